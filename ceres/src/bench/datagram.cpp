@@ -0,0 +1,127 @@
+#include <iostream>
+#include <chrono>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/datagram.hpp>
+
+// Loopback UDP throughput: one datagram per call versus sendmmsg/recvmmsg 
+// batches from a datagram_ring, optionally with GSO/GRO offload; reports 
+// packets per second and system calls per packet on each side
+
+using namespace ceres;
+namespace net = io::net;
+
+constexpr size_t payload = 256;
+constexpr size_t batch = 64;
+constexpr auto duration = std::chrono::seconds (1);
+
+struct counters
+{
+    size_t packets = 0;
+    size_t calls = 0;
+};
+
+enum class mode { single, batched, segmented };
+
+void transmit (net::socket &sock, net::socket::address const &remote, mode how, counters &out)
+{
+    uint8_t data [payload] = {};
+    net::datagram_ring ring {batch, payload};
+    size_t sent = 0;
+
+    auto finish = std::chrono::steady_clock::now () + duration;
+
+    while (std::chrono::steady_clock::now () < finish)
+    {
+        if (how == mode::single)
+        {
+            if (!sock.send_to ({data, sizeof (data)}, remote, sent))
+                ++out.packets;
+        }
+        else
+        {
+            while (ring.push ({data, sizeof (data)}, remote));
+
+            if (!ring.send (sock, sent, how == mode::segmented))
+                out.packets += sent;
+        }
+
+        ++out.calls;
+    }
+}
+
+void collect (net::socket &sock, mode how, std::atomic <bool> const &done, counters &in)
+{
+    uint8_t data [payload];
+    net::socket::address remote;
+    net::datagram_ring ring {batch, how == mode::segmented? 65536 : payload};
+    size_t received = 0;
+
+    while (!done.load ())
+    {
+        if (how == mode::single)
+        {
+            if (!sock.receive_from ({data, sizeof (data)}, remote, received))
+                ++in.packets, ++in.calls;
+        }
+        else if (!ring.receive (sock, received) && received)
+        {
+            ++in.calls;
+
+            for (; !ring.empty (); ring.pop ())
+            {
+                auto datagram = ring.front ();
+                auto segment = datagram.segment? datagram.segment : datagram.data.bytes;
+                in.packets += segment? (datagram.data.bytes + segment - 1) / segment : 1;
+            }
+        }
+    }
+}
+
+void measure (char const *label, mode how)
+{
+    net::socket receiver {net::socket::type::UDP};
+    receiver.bind (net::socket::address {"127.0.0.1:0"});
+    receiver.set_nonblocking ();
+
+    bool offload = how != mode::segmented || !receiver.set_udp_gro ();
+
+    net::socket sender {net::socket::type::UDP};
+    auto remote = receiver.local_address ();
+
+    counters out, in;
+    std::atomic <bool> done {false};
+
+    std::thread thread {[&] { collect (receiver, how, done, in); }};
+    transmit (sender, remote, how, out);
+
+    std::this_thread::sleep_for (std::chrono::milliseconds (100));
+    done = true;
+    thread.join ();
+
+    double seconds = std::chrono::duration<double> (duration).count ();
+
+    std::cout << label << (offload? "" : " (no GRO)")
+        << " sent/s=" << out.packets / seconds
+        << " calls/packet=" << double (out.calls) / std::max <size_t> (out.packets, 1)
+        << " received/s=" << in.packets / seconds
+        << " calls/packet=" << double (in.calls) / std::max <size_t> (in.packets, 1)
+        << std::endl;
+}
+
+int main ()
+{
+    measure ("single   ", mode::single);
+    measure ("batched  ", mode::batched);
+    measure ("segmented", mode::segmented);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <chrono>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/reactor.hpp>
+
+// Local echo load: a reactor group (one sharded socket per reactor) echoes
+// what it receives while blocking client threads ping-pong fixed size 
+// messages; reports round trips per second for UDP and TCP
+
+using namespace ceres;
+namespace net = io::net;
+using net::reactor;
+
+constexpr size_t message_size = 64;
+constexpr auto duration = std::chrono::seconds (2);
+
+void echo_datagrams (net::socket &sock, uint32_t events)
+{
+    uint8_t data [2048];
+    net::socket::address remote;
+    size_t received, sent;
+
+    if (events & reactor::readable)
+        while (!sock.receive_from ({data, sizeof (data)}, remote, received))
+            sock.send_to ({data, received}, remote, sent);
+}
+
+void echo_stream (reactor &r, net::socket &sock, uint32_t events)
+{
+    uint8_t data [2048];
+    size_t received, sent;
+
+    if (events & reactor::readable)
+    {
+        std::error_code error;
+        while (!(error = sock.receive ({data, sizeof (data)}, received)) && received > 0)
+            sock.send ({data, received}, sent);
+
+        if (!error && received == 0)
+            r.remove (sock.handle ()); // orderly shutdown by peer
+    }
+}
+
+void accept_streams (reactor &r, net::socket &listener, uint32_t)
+{
+    net::socket accepted;
+    
+    while (!listener.accept (accepted))
+    {
+        r.add (std::move (accepted), [&r] (net::socket &s, uint32_t e) { echo_stream (r, s, e); }, 
+                reactor::readable);
+        accepted = net::socket {};
+    }
+}
+
+// a socket that can't be added, or a handle that isn't there, fails that
+// call alone; the reactor keeps running its other sockets
+bool check ()
+{
+    reactor r;
+
+    bool rejected = bool (r.add (net::socket {}, echo_datagrams));
+    bool missing = bool (r.remove (net::socket::handle_type (-1)));
+    bool added = !r.add (net::socket {net::socket::type::UDP}, echo_datagrams);
+
+    r.poll (0);
+
+    return r && rejected && missing && added && r.size () == 1;
+}
+
+double load (net::socket::type kind, net::socket::address const &server, size_t clients)
+{
+    std::atomic <size_t> total {0};
+    std::vector <std::thread> threads;
+
+    for (size_t c = 0; c < clients; ++c)
+    {
+        threads.emplace_back ([&]
+        {
+            net::socket sock {kind};
+            sock.connect (server);
+
+            uint8_t data [message_size] = {};
+            size_t count = 0, sent, received;
+
+            auto finish = std::chrono::steady_clock::now () + duration;
+
+            while (std::chrono::steady_clock::now () < finish)
+            {
+                if (sock.send ({data, sizeof (data)}, sent))
+                    break;
+
+                for (size_t got = 0; got < sizeof (data); got += received)
+                    if (sock.receive ({data + got, sizeof (data) - got}, received) || !received)
+                        return;
+
+                ++count;
+            }
+
+            total += count;
+        });
+    }
+
+    for (auto &t : threads)
+        t.join ();
+
+    return total / std::chrono::duration<double> (duration).count ();
+}
+
+int main (int argc, char **argv)
+{
+    size_t reactors = argc > 1? std::stoul (argv[1]) : system::thread::core_count ();
+    size_t clients = argc > 2? std::stoul (argv[2]) : 2 * reactors;
+
+    if (!check ())
+    {
+        std::cout << "check failed" << std::endl;
+        return 1;
+    }
+
+    net::socket::address udp {"127.0.0.1:47001"};
+    net::socket::address tcp {"127.0.0.1:47002"};
+
+    net::reactor_group group {reactors};
+
+    group.start ([&] (reactor &r, size_t)
+    {
+        r.add (net::open_sharded (net::socket::type::UDP, udp), echo_datagrams, reactor::readable);
+        r.add (net::open_sharded (net::socket::type::TCP, tcp), 
+                [&r] (net::socket &s, uint32_t e) { accept_streams (r, s, e); }, reactor::readable);
+    });
+
+    std::this_thread::sleep_for (std::chrono::milliseconds (100));
+
+    std::cout << "reactors=" << reactors << " clients=" << clients << std::endl;
+    std::cout << "udp round trips/s=" << load (net::socket::type::UDP, udp, clients) << std::endl;
+    std::cout << "tcp round trips/s=" << load (net::socket::type::TCP, tcp, clients) << std::endl;
+
+    group.stop ();
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+#include <core/name_table.hpp>
+#include <core/name.hpp>
+#include <io/file/chunk.hpp>
+#include <io/file/format.hpp>
+#include <data/endian.hpp>
+#include <data/encoding/bit.hpp>
+#include <data/map.hpp>
+#include <policy/data/mapper.hpp>
+#include <core/stream.hpp>
+
+// Bulk endian conversion. First checks byte_swap_array, built with whichever
+// vector path the compiler targets (SSSE3, AVX2 or NEON), against the scalar
+// path for 2, 4 and 8 byte lanes over every length up to a few vector
+// iterations, every source and destination misalignment within a word, and
+// in place; exits non-zero on any mismatch. Then reports GB/s converting
+// cached arrays of each width one value at a time, through the scalar and
+// the vector array paths, and writing floats to a netstream per value versus
+// as one memory::buffer.
+//
+//   bench_endian [values=4096] [repeats=100000]
+//
+// The build adds bench_endian_avx2 when the host runs AVX2; build for ARM for NEON.
+
+using namespace ceres;
+namespace endian = data::endian;
+
+char const *kernel ()
+{
+#if defined (__AVX2__)
+    return "avx2";
+#elif defined (__SSSE3__)
+    return "ssse3";
+#elif defined (__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+template <size_t Size>
+size_t check (std::minstd_rand &random)
+{
+    size_t const longest = 300;
+    size_t mismatched = 0;
+
+    std::vector <uint8_t> source (longest * Size + 8), expected (source.size ()), actual (source.size ());
+
+    for (size_t count = 0; count <= longest; ++count)
+    {
+        for (size_t from = 0; from < 8; ++from)
+        {
+            for (size_t to = 0; to < 8; ++to)
+            {
+                for (auto &byte : source)
+                    byte = uint8_t (random ());
+
+                endian::byte_swap_array_scalar <Size> (&expected[to], &source[from], count);
+                endian::byte_swap_array <Size> (&actual[to], &source[from], count);
+
+                mismatched += !std::equal (&expected[to], &expected[to] + count * Size, &actual[to]);
+            }
+
+            // in place
+            actual = source;
+            endian::byte_swap_array_scalar <Size> (&expected[from], &source[from], count);
+            endian::byte_swap_array <Size> (&actual[from], &actual[from], count);
+
+            mismatched += !std::equal (&expected[from], &expected[from] + count * Size, &actual[from]);
+        }
+    }
+
+    return mismatched;
+}
+
+template <typename Function>
+double gigabytes_per_second (size_t bytes, size_t repeats, Function &&function)
+{
+    auto start = std::chrono::steady_clock::now ();
+
+    for (size_t r = 0; r < repeats; ++r)
+        function ();
+
+    double seconds = std::chrono::duration <double> (std::chrono::steady_clock::now () - start).count ();
+    return bytes * repeats / seconds / 1e9;
+}
+
+template <typename T>
+void measure (char const *label, size_t values, size_t repeats)
+{
+    using word = typename endian::unsigned_of <sizeof (T)>::type;
+
+    std::vector <T> host (values);
+    std::vector <uint8_t> wire (values * sizeof (T) + 1);
+
+    for (size_t i = 0; i < values; ++i)
+        host[i] = T (i);
+
+    // the wire side starts one byte in, as it does within a packet
+    uint8_t *out = wire.data () + 1;
+    size_t bytes = values * sizeof (T);
+
+    double each = gigabytes_per_second (bytes, repeats, [&]
+    {
+        for (size_t i = 0; i < values; ++i)
+        {
+            word value;
+            std::memcpy (&value, &host[i], sizeof (T));
+            value = endian::make_network_byte_order (value);
+            std::memcpy (out + i * sizeof (T), &value, sizeof (T));
+        }
+    });
+
+    double scalar = gigabytes_per_second (bytes, repeats, [&]
+    {
+        endian::byte_swap_array_scalar <sizeof (T)> (out, host.data (), values);
+    });
+
+    double vector = gigabytes_per_second (bytes, repeats, [&]
+    {
+        endian::make_network_byte_order (out, host.data (), values);
+    });
+
+    std::cout << label << ": GB/s per value=" << each << " scalar array=" << scalar
+        << " " << kernel () << " array=" << vector << " check=" << int (out[bytes - 1]) << std::endl;
+}
+
+void measure_stream (size_t values, size_t repeats)
+{
+    std::vector <float> host (values);
+    std::vector <uint8_t> wire (values * sizeof (float) + 1);
+
+    for (size_t i = 0; i < values; ++i)
+        host[i] = float (i);
+
+    memory::bytebuffer buf {wire.data () + 1, values * sizeof (float)};
+    size_t bytes = values * sizeof (float);
+
+    double each = gigabytes_per_second (bytes, repeats, [&]
+    {
+        core::netstream out {buf};
+        for (size_t i = 0; i < values; ++i)
+            out << host[i];
+    });
+
+    double array = gigabytes_per_second (bytes, repeats, [&]
+    {
+        core::netstream out {buf};
+        out.write (memory::buffer <float const> {host.data (), values});
+    });
+
+    std::cout << "float netstream: GB/s per value=" << each << " array=" << array
+        << " check=" << int (wire[bytes]) << std::endl;
+}
+
+int main (int argc, char **argv)
+{
+    size_t values = argc > 1? std::stoul (argv[1]) : 4096;
+    size_t repeats = argc > 2? std::stoul (argv[2]) : 100000;
+
+    std::minstd_rand random {11};
+    size_t mismatched = check <2> (random) + check <4> (random) + check <8> (random);
+
+    std::cout << "kernel=" << kernel () << " mismatched=" << mismatched << std::endl;
+
+    if (mismatched > 0)
+        return 1;
+
+    std::cout << "values=" << values << " repeats=" << repeats << std::endl;
+
+    measure <uint16_t> ("uint16", values, repeats);
+    measure <float> ("float", values, repeats);
+    measure <double> ("double", values, repeats);
+    measure_stream (values, repeats);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <memory/arena.hpp>
+#include <task/pool.hpp>
+#include <task/graph.hpp>
+#include <event/stream.hpp>
+#include <event/pipeline.hpp>
+
+// A frame of input events mapped into damage and movement streams, each
+// reduced into per-entity totals. Reports the time per frame through the
+// pipeline on the pool and through std::vector queues on one thread, and
+// the arena bytes held once warm.
+//
+//   bench_event [threads=cores] [events=1000000] [frames=50]
+
+using namespace ceres;
+
+constexpr uint32_t entities = 4096;
+
+struct input
+{
+    uint32_t entity;
+    uint32_t kind;
+    float x, y;
+};
+
+struct damage
+{
+    uint32_t entity;
+    float amount;
+};
+
+struct movement
+{
+    uint32_t entity;
+    float dx, dy;
+};
+
+double milliseconds (std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration <double, std::milli> (elapsed).count ();
+}
+
+bool is_hit (input const &e) { return e.kind == 0; }
+bool is_move (input const &e) { return e.kind == 1; }
+
+damage to_damage (input const &e) { return {e.entity, std::sqrt (e.x * e.x + e.y * e.y)}; }
+movement to_movement (input const &e) { return {e.entity, e.x * 0.5f, e.y * 0.5f}; }
+
+int main (int argc, char **argv)
+{
+    size_t threads = argc > 1? std::stoul (argv[1]) : system::thread::core_count ();
+    size_t events = argc > 2? std::stoul (argv[2]) : 1000000;
+    size_t frames = argc > 3? std::stoul (argv[3]) : 50;
+
+    std::minstd_rand random {1};
+    std::vector <input> inputs (events);
+
+    for (auto &e : inputs)
+        e = {uint32_t (random () % entities), uint32_t (random () % 3),
+            float (random () % 100), float (random () % 100)};
+
+    std::vector <float> health (entities), expected_health (entities);
+    std::vector <float> position (entities), expected_position (entities);
+
+    task::pool workers {threads};
+    event::pipeline pipeline {workers};
+
+    auto &source = pipeline.source <input> ();
+    auto &hit_inputs = pipeline.filter (source, [] (input const &e) { return is_hit (e); });
+    auto &move_inputs = pipeline.filter (source, [] (input const &e) { return is_move (e); });
+    auto &hits = pipeline.transform (hit_inputs, [] (input const &e) { return to_damage (e); });
+    auto &moves = pipeline.transform (move_inputs, [] (input const &e) { return to_movement (e); });
+
+    pipeline.reduce (hits, [&health] (damage const &d) { health[d.entity] -= d.amount; });
+    pipeline.reduce (moves, [&position] (movement const &m) { position[m.entity] += m.dx + m.dy; });
+
+    std::cout << "threads=" << workers.size () << " events=" << events
+        << " frames=" << frames << std::endl;
+
+    auto start = std::chrono::steady_clock::now ();
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        pipeline.reset ();
+        event::stream <input>::writer writer {source};
+
+        for (auto &e : inputs)
+            writer.push (e);
+
+        pipeline.run ();
+    }
+
+    double pipeline_ms = milliseconds (std::chrono::steady_clock::now () - start) / frames;
+
+    std::vector <input> hit_queue_inputs, move_queue_inputs;
+    std::vector <damage> hit_queue;
+    std::vector <movement> move_queue;
+
+    start = std::chrono::steady_clock::now ();
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        std::vector <input> queue (inputs.begin (), inputs.end ());
+
+        hit_queue_inputs.clear ();
+        move_queue_inputs.clear ();
+        hit_queue.clear ();
+        move_queue.clear ();
+
+        for (auto &e : queue)
+        {
+            if (is_hit (e)) hit_queue_inputs.push_back (e);
+            if (is_move (e)) move_queue_inputs.push_back (e);
+        }
+
+        for (auto &e : hit_queue_inputs) hit_queue.push_back (to_damage (e));
+        for (auto &e : move_queue_inputs) move_queue.push_back (to_movement (e));
+
+        for (auto &d : hit_queue) expected_health[d.entity] -= d.amount;
+        for (auto &m : move_queue) expected_position[m.entity] += m.dx + m.dy;
+    }
+
+    double vector_ms = milliseconds (std::chrono::steady_clock::now () - start) / frames;
+
+    // batches are reduced partition by partition, so sums may differ in rounding
+    double error = 0;
+    for (uint32_t e = 0; e < entities; ++e)
+        error = std::max <double> (error, std::abs (health[e] - expected_health[e]) / std::abs (expected_health[e]));
+
+    std::cout << "pipeline ms/frame=" << pipeline_ms << " vector ms/frame=" << vector_ms
+        << " speedup=" << vector_ms / pipeline_ms << " arena KiB=" << pipeline.frame ().capacity () / 1024
+        << (error < 1e-3? "" : " MISMATCH") << std::endl;
+
+    return 0;
+}
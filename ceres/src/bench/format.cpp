@@ -0,0 +1,191 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+#include <core/name_table.hpp>
+#include <core/name.hpp>
+#include <io/file/chunk.hpp>
+#include <io/file/format.hpp>
+#include <data/file/heap_description.hpp>
+
+#include <system/platform.hpp>
+#include <io/file/mapping.hpp>
+
+// Text parsing throughput over generated files: an INI file of heap 
+// descriptions read through iostreams with the ctype delimiter table versus
+// an ini_reader over a file mapping, and a CSV file of numeric rows read 
+// with getline and stoul versus a csv_reader. Reports MB/s for each.
+//
+//   bench_format [megabytes=100] [directory=/tmp]
+
+using namespace ceres;
+namespace format = io::file::format;
+
+constexpr size_t heaps = 64; // distinct names, so the name table never fills
+
+double elapsed (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration <double> (std::chrono::steady_clock::now () - start).count ();
+}
+
+void report (char const *what, size_t bytes, double seconds, size_t count, uint64_t check)
+{
+    std::cout << what << ": MB/s=" << bytes / seconds / 1e6 << " records=" << count 
+        << " check=" << check << std::endl;
+}
+
+size_t generate_ini (std::string const &path, size_t bytes)
+{
+    std::ofstream out (path);
+    size_t written = 0;
+
+    for (size_t i = 0; written < bytes; ++i)
+    {
+        char section [128];
+        int length = std::snprintf (section, sizeof (section), 
+                "[heap%zu]\npage_size = 4096\nmin_pages = %zu\nmax_pages = %zu\n\n", 
+                i % heaps, i % 1000, i % 1000 + 16);
+
+        out.write (section, length);
+        written += length;
+    }
+
+    return written;
+}
+
+size_t generate_csv (std::string const &path, size_t bytes)
+{
+    std::ofstream out (path);
+    size_t written = 0;
+
+    for (size_t i = 0; written < bytes; ++i)
+    {
+        char row [128];
+        int length = std::snprintf (row, sizeof (row), "%zu,%zu,%zu,%zu,entity%zu\n", 
+                i, i * 7 % 10007, i * 13 % 65521, i % 256, i % heaps);
+
+        out.write (row, length);
+        written += length;
+    }
+
+    return written;
+}
+
+void parse_ini_stream (std::string const &path, size_t bytes)
+{
+    auto start = std::chrono::steady_clock::now ();
+    std::ifstream in (path);
+
+    data::file::heap_description descr;
+    size_t count = 0;
+    uint64_t check = 0;
+
+    while (in >> std::ws && in.peek () != EOF)
+    {
+        if (!(descr << in, in))
+            break;
+
+        check += descr.min_pages + descr.max_pages;
+        ++count;
+    }
+
+    report ("ini istream", bytes, elapsed (start), count, check);
+}
+
+void parse_ini_mapped (std::string const &path, size_t bytes)
+{
+    auto start = std::chrono::steady_clock::now ();
+    io::file::mapping file (path.c_str ());
+
+    format::ini_reader reader {file.text ()};
+    data::file::heap_description descr;
+    size_t count = 0;
+    uint64_t check = 0;
+
+    while (descr.read (reader))
+    {
+        check += descr.min_pages + descr.max_pages;
+        ++count;
+    }
+
+    report ("ini mapped", bytes, elapsed (start), count, check);
+}
+
+void parse_csv_stream (std::string const &path, size_t bytes)
+{
+    auto start = std::chrono::steady_clock::now ();
+    std::ifstream in (path);
+
+    std::string row, field;
+    size_t count = 0;
+    uint64_t check = 0;
+
+    while (std::getline (in, row))
+    {
+        std::istringstream fields (row);
+
+        for (int column = 0; column < 4 && std::getline (fields, field, ','); ++column)
+            check += std::stoul (field);
+
+        ++count;
+    }
+
+    report ("csv istream", bytes, elapsed (start), count, check);
+}
+
+void parse_csv_mapped (std::string const &path, size_t bytes)
+{
+    auto start = std::chrono::steady_clock::now ();
+    io::file::mapping file (path.c_str ());
+
+    format::csv_reader reader {file.text ()};
+    size_t count = 0;
+    uint64_t check = 0;
+
+    while (reader.next_row ())
+    {
+        for (int column = 0; column < 4 && reader.next_field (); ++column)
+        {
+            uint64_t value = 0;
+            format::parse (reader.field (), value);
+            check += value;
+        }
+
+        ++count;
+    }
+
+    report ("csv mapped", bytes, elapsed (start), count, check);
+}
+
+int main (int argc, char **argv)
+{
+    size_t megabytes = argc > 1? std::stoul (argv[1]) : 100;
+    std::string directory = argc > 2? argv[2] : "/tmp";
+
+    std::string ini = directory + "/bench_format.ini";
+    std::string csv = directory + "/bench_format.csv";
+
+    size_t ini_bytes = generate_ini (ini, megabytes << 20);
+    size_t csv_bytes = generate_csv (csv, megabytes << 20);
+
+    // the first pass warms the page cache for both readers
+    parse_ini_mapped (ini, ini_bytes);
+    parse_ini_stream (ini, ini_bytes);
+    parse_ini_mapped (ini, ini_bytes);
+
+    parse_csv_mapped (csv, csv_bytes);
+    parse_csv_stream (csv, csv_bytes);
+    parse_csv_mapped (csv, csv_bytes);
+
+    std::remove (ini.c_str ());
+    std::remove (csv.c_str ());
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <new>
+#include <cstdlib>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <memory/arena.hpp>
+#include <memory/frame.hpp>
+#include <memory/composable/allocator/core.hpp>
+#include <memory/composable/allocator/stateful.hpp>
+#include <memory/composable/allocator/terminal.hpp>
+#include <memory/composable/allocator/compat.hpp>
+#include <memory/composable/allocator/concrete.hpp>
+#include <memory/composable/allocator/frame.hpp>
+
+// Per-frame event processing with std::vector and std::map temporaries:
+// events are gathered into a vector, sorted, and grouped by key into a map
+// of vectors, then all thrown away. Compares the default allocator with
+// the frame layer, counting global heap calls made inside the frames, which
+// for the frame layer stop once the thread's arenas have grown to the peak.
+//
+//   bench_frame [events/frame=4096] [keys=64] [frames=2000]
+
+using namespace ceres;
+
+static size_t heap_calls = 0;
+
+void *operator new (size_t bytes)
+{
+    ++heap_calls;
+
+    if (void *p = std::malloc (bytes))
+        return p;
+
+    throw std::bad_alloc ();
+}
+
+void operator delete (void *p) noexcept
+{
+    std::free (p);
+}
+
+struct event
+{
+    uint32_t key;
+    uint32_t value;
+};
+
+template <typename T>
+using frame_allocator = memory::allocator::concrete <memory::allocator::compat <memory::allocator::frame>, T>;
+
+// An unchained arena that refuses a request keeps serving ones that fit,
+// and containers over the frame layer copy, move and swap without taking
+// its state with them.
+bool check ()
+{
+    memory::arena bounded {1024, false};
+
+    bool refused = bounded.allocate (2048) == nullptr;
+    bool served = bounded.allocate (512) != nullptr && bounded.allocate (256) != nullptr;
+
+    typedef std::vector <uint32_t, frame_allocator <uint32_t>> values;
+    typedef std::map <uint32_t, uint32_t, std::less <uint32_t>,
+            frame_allocator <std::pair <uint32_t const, uint32_t>>> table;
+
+    values a, b, c;
+    table x, y;
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        a.push_back (i);
+        x[i] = i;
+    }
+
+    b = a;
+    c = std::move (b);
+    std::swap (a, c);
+    y = x;
+    x = std::move (y);
+    std::swap (x, y);
+
+    memory::frame_arena::local ().flip ();
+    memory::frame_arena::local ().flip ();
+
+    return refused && served && a.size () == 100 && c.size () == 100 && a.back () == 99
+        && y.size () == 100 && y[99] == 99;
+}
+
+template <typename Vector, typename Map>
+double measure (size_t events, size_t keys, size_t frames, size_t &calls, bool flip)
+{
+    std::minstd_rand random {3};
+    uint64_t checksum = 0;
+    size_t before = 0;
+
+    auto start = std::chrono::steady_clock::now ();
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        // the first frames grow the arenas
+        if (f == 2)
+            before = heap_calls;
+
+        {
+            Vector incoming;
+
+            for (size_t e = 0; e < events; ++e)
+                incoming.push_back (event {uint32_t (random () % keys), uint32_t (random ())});
+
+            std::sort (incoming.begin (), incoming.end (),
+                    [] (event const &a, event const &b) { return a.key < b.key; });
+
+            Map grouped;
+
+            for (auto &e : incoming)
+                grouped[e.key].push_back (e.value);
+
+            for (auto &group : grouped)
+                checksum += group.first * group.second.size ();
+        }
+
+        if (flip)
+            memory::frame_arena::local ().flip ();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now () - start;
+    calls = heap_calls - before;
+
+    if (checksum == 0)
+        std::cout << "unreachable" << std::endl;
+
+    return std::chrono::duration <double, std::micro> (elapsed).count () / frames;
+}
+
+int main (int argc, char **argv)
+{
+    size_t events = argc > 1? std::stoul (argv[1]) : 4096;
+    size_t keys = argc > 2? std::stoul (argv[2]) : 64;
+    size_t frames = argc > 3? std::stoul (argv[3]) : 2000;
+
+    if (!check ())
+    {
+        std::cout << "check failed" << std::endl;
+        return 1;
+    }
+
+    typedef std::vector <uint32_t, frame_allocator <uint32_t>> frame_values;
+    typedef std::pair <uint32_t const, frame_values> frame_group;
+
+    size_t heap, framed;
+
+    double global = measure <std::vector <event>, std::map <uint32_t, std::vector <uint32_t>>>
+        (events, keys, frames, heap, false);
+
+    double arena = measure <std::vector <event, frame_allocator <event>>,
+          std::map <uint32_t, frame_values, std::less <uint32_t>, frame_allocator <frame_group>>>
+        (events, keys, frames, framed, true);
+
+    std::cout << "events/frame=" << events << " keys=" << keys << " frames=" << frames << std::endl;
+    std::cout << "global heap: us/frame=" << global << " heap calls=" << heap << std::endl;
+    std::cout << "frame arena: us/frame=" << arena << " heap calls=" << framed
+        << " arena capacity=" << memory::frame_arena::local ().capacity () << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/scheduler.hpp>
+#include <io/net/interest.hpp>
+
+// Entities wandering a square world, observers at some of them with a
+// circle of interest. Reports the time per tick to rebuild the grid, to
+// query every observer and to feed the changes to the scheduler, with the
+// mean entities relevant to an observer and entering or leaving per tick.
+// Checks the first observer against a brute force scan.
+//
+//   bench_interest [entities=100000] [observers=500] [radius=100] [ticks=60]
+
+using namespace ceres;
+using io::net::interest;
+using io::net::scheduler;
+
+constexpr float world = 4096;
+constexpr float speed = 4;
+
+double milliseconds (std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration <double, std::milli> (elapsed).count ();
+}
+
+int main (int argc, char **argv)
+{
+    size_t entities = argc > 1? std::stoul (argv[1]) : 100000;
+    size_t observers = argc > 2? std::stoul (argv[2]) : 500;
+    float radius = argc > 3? std::stof (argv[3]) : 100;
+    size_t ticks = argc > 4? std::stoul (argv[4]) : 60;
+
+    std::minstd_rand random {1};
+    std::uniform_real_distribution <float> place {0, world}, step {-speed, speed};
+
+    std::vector <float> x (entities), y (entities);
+    interest areas {entities, observers, radius};
+    scheduler sched {entities, observers};
+
+    for (interest::entity_id e = 0; e < entities; ++e)
+    {
+        x[e] = place (random);
+        y[e] = place (random);
+    }
+
+    double rebuild_ms = 0, query_ms = 0, feed_ms = 0;
+    size_t relevant = 0, changed = 0;
+    bool correct = true;
+
+    for (size_t t = 0; t <= ticks; ++t)
+    {
+        for (interest::entity_id e = 0; e < entities; ++e)
+        {
+            x[e] = std::min (std::max (x[e] + step (random), 0.f), world);
+            y[e] = std::min (std::max (y[e] + step (random), 0.f), world);
+            areas.set_position (e, x[e], y[e]);
+        }
+
+        // each observer rides an entity
+        for (interest::connection_id c = 0; c < observers; ++c)
+            areas.set_area (c, x[c * (entities / observers)], y[c * (entities / observers)], radius, radius / 10);
+
+        auto start = std::chrono::steady_clock::now ();
+        areas.rebuild ();
+        auto built = std::chrono::steady_clock::now ();
+
+        for (interest::connection_id c = 0; c < observers; ++c)
+            areas.query (c);
+
+        auto queried = std::chrono::steady_clock::now ();
+        areas.feed (sched);
+        auto fed = std::chrono::steady_clock::now ();
+
+        // the first tick fills from empty; measure the rest
+        if (t == 0)
+            continue;
+
+        rebuild_ms += milliseconds (built - start);
+        query_ms += milliseconds (queried - built);
+        feed_ms += milliseconds (fed - queried);
+
+        for (interest::connection_id c = 0; c < observers; ++c)
+        {
+            changed += areas.entered (c).size () + areas.left (c).size ();
+
+            for (uint64_t word : areas.relevancy (c))
+                relevant += core::bit::count (word);
+        }
+
+        float cx = x[0], cy = y[0], outer = radius * 1.1f;
+
+        for (interest::entity_id e = 0; e < entities; ++e)
+        {
+            float d = (x[e] - cx) * (x[e] - cx) + (y[e] - cy) * (y[e] - cy);
+            bool in = areas.relevant (0, e);
+
+            correct &= (d <= radius * radius)? in : (d > outer * outer)? !in : true;
+        }
+    }
+
+    std::cout << "entities=" << entities << " observers=" << observers
+        << " radius=" << radius << " ticks=" << ticks << std::endl;
+    std::cout << "rebuild ms/tick=" << rebuild_ms / ticks << " query ms/tick=" << query_ms / ticks
+        << " feed ms/tick=" << feed_ms / ticks << " total ms/tick=" << (rebuild_ms + query_ms + feed_ms) / ticks
+        << std::endl;
+    std::cout << "relevant/observer=" << double (relevant) / ticks / observers
+        << " changes/observer/tick=" << double (changed) / ticks / observers
+        << (correct? "" : " MISMATCH") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <state/state.hpp>
+#include <state/machine_array.hpp>
+
+// machine_array reactions. First checks that a batch whose next state throws
+// on construction leaves every entity in exactly one live state, so nothing
+// is destroyed twice or leaked; exits non-zero otherwise. Then measures
+// entity reactions per second reacting random batches, and every entity, of
+// an array of three-state machines, against one singular_machine per entity.
+//
+//   bench_machines [entities=100000] [rounds=200]
+
+using namespace ceres;
+
+struct tick {};
+struct fault {};
+
+static int live = 0;
+
+struct counted
+{
+    counted () { ++live; }
+    counted (counted const &) { ++live; }
+    ~counted () { --live; }
+};
+
+struct idle : counted
+{
+    idle () {}
+    idle (tick const &) {}
+};
+
+struct walking : counted
+{
+    walking (tick const &) {}
+};
+
+struct running : counted
+{
+    running (tick const &) {}
+};
+
+// entered on a fault, which it refuses after the first few
+struct failed : counted
+{
+    static int allowed;
+
+    failed (fault const &)
+    {
+        if (allowed-- <= 0)
+            throw std::runtime_error ("refused");
+    }
+};
+
+int failed::allowed = 0;
+
+namespace traits
+{
+    namespace state
+    {
+        template <> struct transition <idle, tick> { typedef walking next; };
+        template <> struct transition <walking, tick> { typedef running next; };
+        template <> struct transition <running, tick> { typedef idle next; };
+        template <> struct transition <idle, fault> { typedef failed next; };
+    }
+}
+
+typedef state::machine_array <idle, walking, running, failed> machines;
+typedef state::singular_machine <idle, walking, running, failed> machine;
+
+bool check ()
+{
+    live = 0;
+    bool consistent = true;
+
+    {
+        machines array {10};
+
+        uint32_t some [] = {1, 3, 5, 7};
+        array.react (memory::buffer <uint32_t const> {some, 4}, tick {});
+
+        failed::allowed = 3;
+
+        try
+        {
+            array.react (fault {});
+            consistent = false;
+        }
+        catch (std::runtime_error const &) {}
+
+        size_t faulted = 0;
+
+        for (uint32_t entity = 0; entity < array.size (); ++entity)
+            faulted += array.is_active <failed> (entity);
+
+        consistent = consistent && faulted == 3 && live == 10
+            && array.is_active <walking> (1) && array.is_active <idle> (8);
+    }
+
+    return consistent && live == 0;
+}
+
+template <typename Function>
+double reactions_per_second (size_t reactions, Function &&function)
+{
+    auto start = std::chrono::steady_clock::now ();
+    function ();
+    std::chrono::duration <double> elapsed = std::chrono::steady_clock::now () - start;
+
+    return reactions / elapsed.count ();
+}
+
+int main (int argc, char **argv)
+{
+    size_t entities = argc > 1? std::stoul (argv[1]) : 100000;
+    size_t rounds = argc > 2? std::stoul (argv[2]) : 200;
+
+    if (!check ())
+    {
+        std::cout << "check failed" << std::endl;
+        return 1;
+    }
+
+    std::minstd_rand random {5};
+    std::vector <uint32_t> batch;
+
+    for (uint32_t entity = 0; entity < entities; ++entity)
+        if (random () % 4 == 0)
+            batch.push_back (entity);
+
+    machines array {entities};
+    std::vector <machine> singles (entities);
+
+    double array_all = reactions_per_second (entities * rounds, [&]
+    {
+        for (size_t r = 0; r < rounds; ++r)
+            array.react (tick {});
+    });
+
+    double singles_all = reactions_per_second (entities * rounds, [&]
+    {
+        for (size_t r = 0; r < rounds; ++r)
+            for (auto &m : singles)
+                m.react (tick {});
+    });
+
+    memory::buffer <uint32_t const> some {batch.data (), batch.size ()};
+
+    double array_some = reactions_per_second (batch.size () * rounds, [&]
+    {
+        for (size_t r = 0; r < rounds; ++r)
+            array.react (some, tick {});
+    });
+
+    double singles_some = reactions_per_second (batch.size () * rounds, [&]
+    {
+        for (size_t r = 0; r < rounds; ++r)
+            for (auto entity : batch)
+                singles [entity].react (tick {});
+    });
+
+    std::cout << "entities=" << entities << " batch=" << batch.size () << " rounds=" << rounds << std::endl;
+    std::cout << "all: reactions/s machine_array=" << array_all << " singular_machine=" << singles_all << std::endl;
+    std::cout << "batch: reactions/s machine_array=" << array_some << " singular_machine=" << singles_some
+        << " (active " << array.active (0) << " " << singles [0].active () << ")" << std::endl;
+
+    return 0;
+}
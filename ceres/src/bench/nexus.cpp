@@ -0,0 +1,214 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+#include <core/name_table.hpp>
+#include <core/name.hpp>
+#include <io/file/chunk.hpp>
+#include <io/file/format.hpp>
+#include <data/endian.hpp>
+#include <data/encoding/bit.hpp>
+#include <data/map.hpp>
+#include <policy/data/mapper.hpp>
+#include <core/stream.hpp>
+#include <data/schema.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/datagram.hpp>
+#include <io/net/message.hpp>
+#include <io/net/nexus.hpp>
+
+// Two-process nexus transfer under induced loss: the parent sends a run of
+// numbered messages on a reliable ordered stream alongside unreliable
+// traffic to a forked receiver; both ends drop incoming packets at random.
+// The receiver checks every reliable message arrives once and in order and
+// reports through its exit status; the parent reports throughput and the
+// connection's RTT and loss statistics. Stray and truncated datagrams are
+// sent to the receiver alongside, which must drop them.
+//
+//   bench_nexus [loss=0.1] [messages=100000] [size=64]
+
+using namespace ceres;
+namespace net = io::net;
+
+constexpr uint16_t protocol = 0xCE5E;
+constexpr uint16_t entity = 1;
+constexpr uint8_t state = 0, events = 1;
+constexpr auto linger = std::chrono::milliseconds (200);
+constexpr size_t packet_header_size = net::packet_header::wire_size;
+
+net::socket::address const sender_address {"127.0.0.1:47031"};
+net::socket::address const receiver_address {"127.0.0.1:47032"};
+
+void induce_loss (net::nexus &nexus, double loss, unsigned seed)
+{
+    auto random = std::make_shared <std::minstd_rand> (seed);
+    std::bernoulli_distribution drop {loss};
+
+    nexus.set_filter ([random, drop] (net::socket::address const &, memory::bytebuffer const &) mutable
+    {
+        return !drop (*random);
+    });
+}
+
+// a datagram too short for a packet header, and a packet whose message
+// header is cut short; the receiver drops both
+void send_strays (net::socket &stray)
+{
+    uint8_t bytes [packet_header_size + 3] = {};
+    size_t sent = 0;
+
+    core::netstream out {memory::bytebuffer {bytes, sizeof (bytes)}};
+    data::schema::serialize (out, net::packet_header {protocol, 0, 0, 0, 0});
+
+    stray.send_to ({bytes, 5}, receiver_address, sent);
+    stray.send_to ({bytes, sizeof (bytes)}, receiver_address, sent);
+}
+
+void idle (size_t delivered)
+{
+    if (delivered == 0)
+        std::this_thread::sleep_for (std::chrono::microseconds (50));
+}
+
+int receive (double loss, uint32_t messages)
+{
+    net::nexus nexus {receiver_address, protocol};
+    induce_loss (nexus, loss, 2);
+
+    uint32_t expected = 0, unreliable = 0;
+    size_t delivered = 0;
+    bool ordered = true;
+
+    nexus.on_receive ([&] (net::connection &, uint16_t, uint8_t stream, memory::bytebuffer const &payload)
+    {
+        ++delivered;
+
+        if (stream == events)
+            return (void) ++unreliable;
+
+        uint32_t number;
+        std::memcpy (&number, payload.pointer, sizeof (number));
+        ordered = ordered && number == expected++;
+    });
+
+    auto deadline = std::chrono::steady_clock::now () + std::chrono::seconds (60);
+    auto done = std::chrono::steady_clock::time_point {};
+
+    // keep acknowledging for a while after the last message arrives
+    while (std::chrono::steady_clock::now () < deadline)
+    {
+        auto now = std::chrono::steady_clock::now ();
+        delivered = 0;
+
+        if (nexus.update (now))
+            return 2;
+
+        if (expected == messages && done == std::chrono::steady_clock::time_point {})
+            done = now;
+
+        if (done != std::chrono::steady_clock::time_point {} && now - done > linger)
+            break;
+
+        idle (delivered);
+    }
+
+    std::cout << "receiver: reliable=" << expected << "/" << messages
+        << " in order=" << ordered << " unreliable=" << unreliable << std::endl;
+
+    return ordered && expected == messages? 0 : 1;
+}
+
+int send (double loss, uint32_t messages, size_t size)
+{
+    net::nexus nexus {sender_address, protocol};
+    induce_loss (nexus, loss, 1);
+
+    size_t delivered = 0;
+    nexus.on_receive ([&] (net::connection &, uint16_t, uint8_t, memory::bytebuffer const &) { ++delivered; });
+
+    auto &connection = nexus.connect (receiver_address);
+    auto &channel = connection.open (entity);
+    auto &reliable = channel.open (state, net::stream::reliable | net::stream::ordered, 4);
+    auto &unreliable = channel.open (events, net::stream::unreliable, 1);
+
+    net::socket stray {net::socket::type::UDP};
+    size_t rounds = 0;
+
+    std::vector <uint8_t> payload (std::max (size, sizeof (uint32_t)));
+    uint32_t next = 0;
+
+    auto start = std::chrono::steady_clock::now ();
+    auto deadline = start + std::chrono::seconds (60);
+
+    while (std::chrono::steady_clock::now () < deadline)
+    {
+        while (next < messages)
+        {
+            std::memcpy (payload.data (), &next, sizeof (next));
+            if (!reliable.send ({payload.data (), payload.size ()}))
+                break;
+
+            ++next;
+        }
+
+        if (rounds++ < 100)
+            send_strays (stray);
+
+        if (unreliable.outstanding () < 16)
+            unreliable.send ({payload.data (), payload.size ()});
+
+        delivered = 0;
+        if (nexus.update (std::chrono::steady_clock::now ()))
+            return 2;
+
+        if (next == messages && reliable.idle ())
+            break;
+
+        idle (delivered);
+    }
+
+    double seconds = std::chrono::duration <double> (std::chrono::steady_clock::now () - start).count ();
+    auto &stats = connection.stats ();
+
+    std::cout << "sender: messages/s=" << messages / seconds
+        << " payload MB/s=" << messages * payload.size () / seconds / 1e6 << std::endl;
+    std::cout << "sender: rtt ms=" << std::chrono::duration <double, std::milli> (stats.rtt).count ()
+        << " loss=" << stats.loss
+        << " packets sent=" << stats.packets_sent << " acked=" << stats.packets_acked
+        << " lost=" << stats.packets_lost << std::endl;
+
+    return reliable.idle ()? 0 : 1;
+}
+
+int main (int argc, char **argv)
+{
+    double loss = argc > 1? std::stod (argv[1]) : 0.1;
+    uint32_t messages = argc > 2? std::stoul (argv[2]) : 100000;
+    size_t size = argc > 3? std::stoul (argv[3]) : 64;
+
+    std::cout << "loss=" << loss << " messages=" << messages << " size=" << size << std::endl;
+
+    pid_t child = fork ();
+    if (child == 0)
+        return receive (loss, messages);
+
+    int sent = send (loss, messages, size);
+
+    int status = 0;
+    waitpid (child, &status, 0);
+    int received = WIFEXITED (status)? WEXITSTATUS (status) : 3;
+
+    std::cout << (sent == 0 && received == 0? "PASS" : "FAIL") << std::endl;
+    return sent || received;
+}
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <time.h>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <memory/epoch.hpp>
+#include <state/state.hpp>
+#include <entity/store.hpp>
+#include <entity/page.hpp>
+#include <entity/snapshot.hpp>
+
+// Reader threads look up random components in the snapshot of a column,
+// one read section per lookup, while a writer changes components and
+// captures at a swept rate. Reports lookups per second of reader CPU time,
+// which stays flat as the writer rate rises since readers never wait or
+// write shared memory, against the same lookups under a mutex the writer
+// also takes to apply its changes.
+//
+//   bench_rcu [readers=2] [entities=100000] [changes/capture=256] [seconds=1]
+
+using namespace ceres;
+
+struct position
+{
+    float x, y, z;
+};
+
+double thread_seconds ()
+{
+    timespec now;
+    clock_gettime (CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+struct result
+{
+    double lookups_per_cpu_second;
+    double captures_per_second;
+};
+
+template <typename Lookup, typename Write>
+result measure (size_t readers, double seconds, double rate, Lookup const &lookup, Write const &write)
+{
+    std::atomic <bool> stop {false};
+    std::atomic <size_t> lookups {0};
+    std::vector <double> cpu (readers);
+    std::vector <std::thread> threads;
+
+    for (size_t r = 0; r < readers; ++r)
+        threads.emplace_back ([&, r]
+        {
+            std::minstd_rand random (r + 1);
+            double start = thread_seconds ();
+            size_t count = 0;
+
+            while (!stop.load (std::memory_order_relaxed))
+            {
+                lookup (random);
+                ++count;
+            }
+
+            cpu[r] = thread_seconds () - start;
+            lookups += count;
+        });
+
+    auto start = std::chrono::steady_clock::now ();
+    auto deadline = start + std::chrono::duration <double> (seconds);
+    auto interval = std::chrono::duration <double> (rate > 0? 1 / rate : seconds);
+    auto next = start;
+    size_t captures = 0;
+
+    std::minstd_rand random {99};
+
+    while (std::chrono::steady_clock::now () < deadline)
+    {
+        if (rate > 0 && std::chrono::steady_clock::now () >= next)
+        {
+            write (random);
+            ++captures;
+            next += std::chrono::duration_cast <std::chrono::steady_clock::duration> (interval);
+        }
+        else
+            std::this_thread::yield ();
+    }
+
+    stop = true;
+
+    for (auto &thread : threads)
+        thread.join ();
+
+    double total = 0;
+    for (auto c : cpu)
+        total += c;
+
+    return {lookups / total, captures / seconds};
+}
+
+int main (int argc, char **argv)
+{
+    size_t readers = argc > 1? std::stoul (argv[1]) : 2;
+    size_t entities = argc > 2? std::stoul (argv[2]) : 100000;
+    size_t changes = argc > 3? std::stoul (argv[3]) : 256;
+    double seconds = argc > 4? std::stod (argv[4]) : 1;
+
+    memory::epoch_domain domain;
+    entity::column <position> positions;
+    entity::snapshot <position> snapshot {domain};
+    std::mutex mutex;
+
+    for (entity::id e = 0; e < entities; ++e)
+        positions.emplace (e, position {float (e), 0, 0});
+
+    snapshot.capture (positions);
+    positions.dirty ().clear ();
+
+    std::cout << "readers=" << readers << " entities=" << entities
+        << " changes/capture=" << changes << std::endl;
+
+    for (double rate : {0.0, 60.0, 1000.0, 10000.0, 1e9})
+    {
+        auto rcu = measure (readers, seconds, rate, [&] (std::minstd_rand &random)
+        {
+            static thread_local memory::epoch_domain::reader reader {domain};
+            memory::epoch_domain::guard section {reader};
+
+            auto &current = snapshot.read ();
+            size_t index = random () % current.size;
+            auto &component = current.blocks[index / 64]->items[index % 64];
+
+            if (component.x < 0)
+                std::cout << "unreachable" << std::endl;
+        },
+        [&] (std::minstd_rand &random)
+        {
+            for (size_t c = 0; c < changes; ++c)
+                positions.modify (random () % entities).y += 1;
+
+            snapshot.capture (positions);
+            positions.dirty ().clear ();
+        });
+
+        auto locked = measure (readers, seconds, rate, [&] (std::minstd_rand &random)
+        {
+            std::lock_guard <std::mutex> lock {mutex};
+
+            if (positions.get (random () % entities).x < 0)
+                std::cout << "unreachable" << std::endl;
+        },
+        [&] (std::minstd_rand &random)
+        {
+            std::lock_guard <std::mutex> lock {mutex};
+
+            for (size_t c = 0; c < changes; ++c)
+                positions.modify (random () % entities).y += 1;
+
+            positions.dirty ().clear ();
+        });
+
+        std::cout << "writer captures/s=" << rcu.captures_per_second
+            << ": rcu lookups/cpu-s=" << rcu.lookups_per_cpu_second
+            << " | mutex writes/s=" << locked.captures_per_second
+            << " lookups/cpu-s=" << locked.lookups_per_cpu_second << std::endl;
+    }
+
+    domain.synchronize ();
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <state/state.hpp>
+#include <entity/store.hpp>
+#include <entity/page.hpp>
+#include <entity/history.hpp>
+#include <entity/replica.hpp>
+
+// Two endpoints in one process over a link with a fixed latency in ticks
+// each way, driven by seeded generators so every run is the same. The
+// proxy sends step requests on random entities each tick and applies them
+// at once; the owner vetoes a share of them, standing for what only it
+// knows, and the vetoes arriving in a tick cost the proxy one rollback
+// reaching back a round trip. The history is as deep as the round trip
+// needs, so the sweep over depth is a sweep over latency. Reports the time
+// per rollback, the log replayed and pages restored per rollback, and the
+// pages the history holds against whole copies per tick, then checks both
+// copies agree.
+//
+//   bench_replication [entities=100000] [requests/tick=64] [veto/1000=20] [ticks=1000]
+
+using namespace ceres;
+
+struct body
+{
+    int32_t x, y;
+    uint32_t energy;
+};
+
+struct step
+{
+    entity::id entity;
+    int16_t dx, dy;
+    uint32_t cost;
+    uint32_t nonce;
+};
+
+struct apply_step
+{
+    bool operator() (entity::column <body> &bodies, step const &req) const
+    {
+        if (bodies.get (req.entity).energy < req.cost)
+            return false;
+
+        body &b = bodies.modify (req.entity);
+        b.x += req.dx;
+        b.y += req.dy;
+        b.energy -= req.cost;
+
+        return true;
+    }
+};
+
+struct validate_step
+{
+    uint32_t veto;
+
+    bool operator() (entity::column <body> const &, step const &req) const
+    {
+        return (req.nonce * 2654435761u >> 8) % 1000 >= veto;
+    }
+};
+
+typedef entity::proxy <body, step, apply_step> proxy_type;
+typedef entity::authority <body, step, apply_step, validate_step> authority_type;
+
+// messages in flight, delivered in order once their tick comes
+template <typename Message>
+struct link
+{
+    uint64_t latency;
+    std::deque <std::pair <uint64_t, Message>> queue;
+
+    void send (uint64_t now, Message const &message) { queue.emplace_back (now + latency, message); }
+
+    template <typename Receiver>
+    void deliver (uint64_t now, Receiver &&receiver)
+    {
+        while (!queue.empty () && queue.front ().first <= now)
+        {
+            receiver (queue.front ().second);
+            queue.pop_front ();
+        }
+    }
+};
+
+// a history captured at sparse ticks holds exactly those, and restores them
+bool check ()
+{
+    entity::column <body> bodies;
+    entity::history <body> past {8};
+
+    for (entity::id e = 0; e < 100; ++e)
+        bodies.emplace (e, body {int32_t (e), 0, 0});
+
+    past.capture (10, bodies);
+    bodies.modify (5).x = -1;
+    past.capture (20, bodies);
+    bodies.modify (5).x = -2;
+
+    bool held = past.contains (10) && past.contains (20) && !past.contains (15);
+
+    past.restore (20, bodies);
+    bool newest = bodies.get (5).x == -1;
+
+    past.restore (10, bodies);
+    bool oldest = bodies.get (5).x == 5 && past.size () == 1;
+
+    return held && newest && oldest;
+}
+
+int main (int argc, char **argv)
+{
+    if (!check ())
+    {
+        std::cout << "check failed" << std::endl;
+        return 1;
+    }
+
+    size_t entities = argc > 1? std::stoul (argv[1]) : 100000;
+    size_t requests = argc > 2? std::stoul (argv[2]) : 64;
+    uint32_t veto = argc > 3? std::stoul (argv[3]) : 20;
+    size_t ticks = argc > 4? std::stoul (argv[4]) : 1000;
+
+    std::cout << "entities=" << entities << " requests/tick=" << requests
+        << " veto/1000=" << veto << " ticks=" << ticks << std::endl;
+
+    for (size_t depth : {4, 8, 16, 32, 64, 128})
+    {
+        entity::column <body> owned, copy;
+
+        for (entity::id e = 0; e < entities; ++e)
+        {
+            owned.emplace (e, body {int32_t (e), 0, 1000000});
+            copy.emplace (e, body {int32_t (e), 0, 1000000});
+        }
+
+        owned.dirty ().clear ();
+
+        proxy_type proxy {copy, depth};
+        authority_type owner {owned, apply_step (), validate_step {veto}};
+
+        // a request answered a round trip later must find the tick before it
+        uint64_t latency = (depth - 2) / 2;
+        link <std::pair <proxy_type::sequence, step>> upstream {latency, {}};
+        link <std::pair <proxy_type::sequence, bool>> downstream {latency, {}};
+
+        std::minstd_rand random {7};
+        std::chrono::steady_clock::duration rolling {0};
+        size_t resyncs = 0, held = 0, captured = 0;
+
+        for (uint64_t now = 0; now < ticks || proxy.pending (); ++now)
+        {
+            for (size_t r = 0; now < ticks && r < requests; ++r)
+            {
+                step req {entity::id (random () % entities), int16_t (random () % 7 - 3),
+                    int16_t (random () % 7 - 3), uint32_t (random () % 4), uint32_t (random ())};
+
+                upstream.send (now, {proxy.request (req), req});
+            }
+
+            upstream.deliver (now, [&] (std::pair <proxy_type::sequence, step> const &message)
+            {
+                downstream.send (now, {message.first, owner.receive (message.second)});
+            });
+
+            downstream.deliver (now, [&] (std::pair <proxy_type::sequence, bool> const &answer)
+            {
+                if (answer.second)
+                    proxy.accept (answer.first);
+                else if (!proxy.reject (answer.first))
+                    ++resyncs;
+            });
+
+            auto start = std::chrono::steady_clock::now ();
+            proxy.reconcile ();
+            rolling += std::chrono::steady_clock::now () - start;
+
+            proxy.advance ();
+
+            held += proxy.past ().pages ();
+            ++captured;
+        }
+
+        size_t mismatched = 0;
+
+        for (entity::id e = 0; e < entities; ++e)
+        {
+            body const &a = owned.get (e), &b = copy.get (e);
+            mismatched += a.x != b.x || a.y != b.y || a.energy != b.energy;
+        }
+
+        size_t rollbacks = std::max <size_t> (proxy.rollbacks (), 1);
+        size_t whole = (entities + 63) / 64 * std::min (depth, captured);
+
+        std::cout << "depth=" << depth << " latency=" << latency
+            << ": rollbacks=" << proxy.rollbacks ()
+            << " us/rollback=" << std::chrono::duration <double, std::micro> (rolling).count () / rollbacks
+            << " replayed/rollback=" << double (proxy.replayed ()) / rollbacks
+            << " pages restored/rollback=" << double (proxy.restored ()) / rollbacks
+            << " | pages held=" << held / captured << " of " << whole << " whole"
+            << " | resyncs=" << resyncs << " mismatched=" << mismatched << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/scheduler.hpp>
+
+// Replication scheduling at 60Hz: entities with random priorities and
+// update sizes, connections with random relevancy (a share irrelevant)
+// and a fixed bandwidth. Reports the time per tick across all connections
+// and how long relevant entities wait between sends, by priority band.
+//
+//   bench_scheduler [entities=10000] [connections=64] [bytes/s=1048576]
+
+using namespace ceres;
+using io::net::scheduler;
+
+constexpr double tick = 1.0 / 60;
+constexpr size_t ticks = 600;
+
+int main (int argc, char **argv)
+{
+    size_t entities = argc > 1? std::stoul (argv[1]) : 10000;
+    size_t connections = argc > 2? std::stoul (argv[2]) : 64;
+    double bandwidth = argc > 3? std::stod (argv[3]) : 1 << 20;
+
+    std::minstd_rand random {1};
+    std::uniform_real_distribution <float> priority {0.1f, 10.f};
+    std::uniform_int_distribution <uint32_t> bytes {16, 256};
+    std::bernoulli_distribution irrelevant {0.3};
+
+    scheduler sched {entities, connections};
+    std::vector <float> priorities (entities);
+    std::vector <bool> relevant (entities, true); // to connection 0
+
+    for (scheduler::entity_id e = 0; e < entities; ++e)
+    {
+        priorities[e] = priority (random);
+        sched.set_priority (e, priorities[e]);
+        sched.set_size (e, bytes (random));
+    }
+
+    for (scheduler::connection_id c = 0; c < connections; ++c)
+    {
+        sched.set_bandwidth (c, bandwidth, bandwidth * tick * 2);
+
+        for (scheduler::entity_id e = 0; e < entities; ++e)
+            if (irrelevant (random))
+            {
+                sched.set_relevancy (c, e, 0);
+                relevant[e] = relevant[e] && c != 0;
+            }
+    }
+
+    // ticks since each entity was last sent to connection 0
+    std::vector <size_t> last (entities, 0), worst (entities, 0);
+    size_t sent = 0;
+
+    auto start = std::chrono::steady_clock::now ();
+
+    for (size_t t = 1; t <= ticks; ++t)
+    {
+        sched.tick (tick);
+
+        for (auto e : sched.scheduled (0))
+        {
+            worst[e] = std::max (worst[e], t - last[e]);
+            last[e] = t;
+        }
+
+        for (scheduler::connection_id c = 0; c < connections; ++c)
+            sent += sched.scheduled (c).size ();
+    }
+
+    double seconds = std::chrono::duration <double> (std::chrono::steady_clock::now () - start).count ();
+
+    std::cout << "entities=" << entities << " connections=" << connections
+        << " bytes/s=" << bandwidth << std::endl;
+    std::cout << "us/tick=" << seconds / ticks * 1e6
+        << " updates/tick=" << double (sent) / ticks << std::endl;
+
+    // include the wait since the last send to the end of the run
+    for (scheduler::entity_id e = 0; e < entities; ++e)
+        worst[e] = std::max (worst[e], ticks - last[e]);
+
+    // aging bounds the wait of every relevant entity, low priority included
+    for (float band = 0; band < 10; band += 2.5f)
+    {
+        size_t count = 0, never = 0, longest = 0;
+        double waits = 0;
+
+        for (scheduler::entity_id e = 0; e < entities; ++e)
+        {
+            if (priorities[e] < band || priorities[e] >= band + 2.5f || !relevant[e])
+                continue;
+
+            ++count;
+            never += last[e] == 0;
+            longest = std::max (longest, worst[e]);
+            waits += worst[e];
+        }
+
+        std::cout << "priority " << band << "-" << band + 2.5f << ": entities=" << count
+            << " never sent=" << never << " mean worst wait=" << waits / count
+            << " longest wait=" << longest << " ticks" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <chrono>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <state/state.hpp>
+
+// Measures singular_machine reactions per second for rings of 3 to 64 states;
+// every state transitions to the next on a tick and ignores a noop event
+
+using namespace ceres;
+
+struct tick {};
+struct noop {};
+
+template <int N, int K>
+struct node
+{
+    node () {}
+    node (tick const &) {}
+};
+
+namespace traits
+{
+    namespace state
+    {
+        template <int N, int K> 
+        struct transition <node<N,K>, tick> { typedef node<(N+1) % K, K> next; };
+    }
+}
+
+template <int ...I> struct sequence {};
+
+template <int N, int ...I> 
+struct make_sequence : make_sequence <N-1, N-1, I...> {};
+
+template <int ...I> 
+struct make_sequence <0, I...> { typedef sequence <I...> type; };
+
+template <int K, typename Sequence> struct ring;
+
+template <int K, int ...I>
+struct ring <K, sequence <I...>> 
+{ 
+    typedef state::singular_machine <node<I,K>...> type; 
+};
+
+template <typename Event, int K>
+void measure (char const *label)
+{
+    using clock = std::chrono::steady_clock;
+    typedef typename ring <K, typename make_sequence<K>::type>::type machine_type;
+
+    constexpr size_t reactions = 50000000;
+
+    machine_type machine;
+    Event event;
+
+    auto start = clock::now ();
+    for (size_t i = 0; i < reactions; ++i)
+        machine.react (event);
+    auto finish = clock::now ();
+
+    std::chrono::duration<double> elapsed = finish - start;
+
+    std::cout << label << " states=" << K 
+        << " reactions/s=" << (reactions / elapsed.count ())
+        << " (active " << machine.active () << ")" << std::endl;
+}
+
+template <typename Event>
+void measure_all (char const *label)
+{
+    measure <Event, 3> (label);
+    measure <Event, 8> (label);
+    measure <Event, 16> (label);
+    measure <Event, 32> (label);
+    measure <Event, 64> (label);
+}
+
+int main ()
+{
+    measure_all <tick> ("transition");
+    measure_all <noop> ("ignored");
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <state/state.hpp>
+#include <entity/store.hpp>
+#include <entity/transaction.hpp>
+
+// Transactions over a position column, each reading two components and
+// moving one by the other. A share of transactions (the conflict rate)
+// picks both components from a small hot set, the rest from all entities.
+// Sweeps thread counts and conflict rates, reporting commits per second
+// and aborts per commit, against a single mutex around the same work.
+//
+//   bench_stm [entities=100000] [transactions/thread=200000] [hot=16]
+
+using namespace ceres;
+
+struct position
+{
+    float x, y, z;
+};
+
+struct workload
+{
+    size_t entities, hot;
+    double conflict;
+
+    template <typename Random>
+    entity::id pick (Random &random) const
+    {
+        std::bernoulli_distribution contended {conflict};
+        return random () % (contended (random)? hot : entities);
+    }
+};
+
+double seconds (std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration <double> (elapsed).count ();
+}
+
+template <typename Work>
+double run_threads (size_t threads, Work const &work)
+{
+    std::vector <std::thread> running;
+    auto start = std::chrono::steady_clock::now ();
+
+    for (size_t t = 0; t < threads; ++t)
+        running.emplace_back (work, t);
+
+    for (auto &thread : running)
+        thread.join ();
+
+    return seconds (std::chrono::steady_clock::now () - start);
+}
+
+int main (int argc, char **argv)
+{
+    size_t entities = argc > 1? std::stoul (argv[1]) : 100000;
+    size_t count = argc > 2? std::stoul (argv[2]) : 200000;
+    size_t hot = argc > 3? std::stoul (argv[3]) : 16;
+
+    entity::column <position> positions;
+    entity::lock_table locks;
+    std::mutex mutex;
+
+    for (entity::id e = 0; e < entities; ++e)
+        positions.emplace (e, position {float (e), 0, 0});
+
+    std::cout << "entities=" << entities << " transactions/thread=" << count
+        << " hot=" << hot << std::endl;
+
+    for (size_t threads : {1, 2, 4, 8})
+    for (double conflict : {0.0, 0.01, 0.1, 0.5})
+    {
+        workload load {entities, hot, conflict};
+        std::atomic <size_t> aborts {0};
+
+        double stm = run_threads (threads, [&] (size_t t)
+        {
+            std::minstd_rand random (t + 1);
+            entity::transaction tx {locks};
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                entity::id from = load.pick (random), to = load.pick (random);
+
+                tx.atomically ([&] (entity::transaction &tx)
+                {
+                    float x = tx.read (positions, from, &position::x);
+                    float y = tx.read (positions, from, &position::y);
+
+                    tx.write (positions, to, &position::x, tx.read (positions, to, &position::x) + x * 0.5f);
+                    tx.write (positions, to, &position::y, tx.read (positions, to, &position::y) + y * 0.5f);
+                });
+            }
+
+            aborts += tx.aborts ();
+        });
+
+        double locked = run_threads (threads, [&] (size_t t)
+        {
+            std::minstd_rand random (t + 1);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                entity::id from = load.pick (random), to = load.pick (random);
+                std::lock_guard <std::mutex> lock {mutex};
+
+                position const &source = positions.get (from);
+                position &target = positions.modify (to);
+                target.x += source.x * 0.5f;
+                target.y += source.y * 0.5f;
+            }
+        });
+
+        double commits = double (threads * count);
+
+        std::cout << "threads=" << threads << " conflict=" << conflict
+            << ": stm commits/s=" << commits / stm << " aborts/commit=" << aborts / commits
+            << " mutex commits/s=" << commits / locked << std::endl;
+    }
+
+    return 0;
+}
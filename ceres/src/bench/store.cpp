@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <state/state.hpp>
+#include <entity/store.hpp>
+
+// A million entities with a position column, a share of them changed per
+// frame. Reports the time to visit the changed components by scanning the
+// dirty bitset against testing a dirty flag kept in every component.
+//
+//   bench_store [entities=1000000] [dirty%=1] [frames=100]
+
+using namespace ceres;
+
+struct position
+{
+    float x, y, z;
+};
+
+struct flagged
+{
+    position value;
+    bool dirty;
+};
+
+double milliseconds (std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration <double, std::milli> (elapsed).count ();
+}
+
+int main (int argc, char **argv)
+{
+    size_t entities = argc > 1? std::stoul (argv[1]) : 1000000;
+    double percent = argc > 2? std::stod (argv[2]) : 1;
+    size_t frames = argc > 3? std::stoul (argv[3]) : 100;
+
+    std::minstd_rand random {1};
+    std::uniform_int_distribution <entity::id> pick {0, entity::id (entities - 1)};
+    size_t changes = entities * percent / 100;
+
+    entity::store <position> store;
+    std::vector <flagged> flags (entities);
+
+    for (entity::id e = 0; e < entities; ++e)
+        store.emplace <position> (e, position {float (e), 0, 0});
+
+    store.clear_dirty ();
+
+    double bitset_ms = 0, flag_ms = 0;
+    float bitset_sum = 0, flag_sum = 0;
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        for (size_t c = 0; c < changes; ++c)
+        {
+            entity::id e = pick (random);
+            store.modify <position> (e).y += 1;
+            flags[e].value.y += 1;
+            flags[e].dirty = true;
+        }
+
+        auto start = std::chrono::steady_clock::now ();
+
+        store.get_column <position> ().drain_dirty ([&bitset_sum] (entity::id, position &p)
+        {
+            bitset_sum += p.y;
+        });
+
+        bitset_ms += milliseconds (std::chrono::steady_clock::now () - start);
+        start = std::chrono::steady_clock::now ();
+
+        for (auto &component : flags)
+        {
+            if (component.dirty)
+            {
+                flag_sum += component.value.y;
+                component.dirty = false;
+            }
+        }
+
+        flag_ms += milliseconds (std::chrono::steady_clock::now () - start);
+    }
+
+    std::cout << "entities=" << entities << " dirty%=" << percent << " frames=" << frames << std::endl;
+    std::cout << "bitset ms/frame=" << bitset_ms / frames << " flags ms/frame=" << flag_ms / frames
+        << " speedup=" << flag_ms / bitset_ms << (bitset_sum == flag_sum? "" : " MISMATCH") << std::endl;
+
+    return 0;
+}
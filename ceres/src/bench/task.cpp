@@ -0,0 +1,166 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <task/pool.hpp>
+#include <task/graph.hpp>
+
+// A frame graph of 10k nodes in layers, each node depending on a few random
+// nodes of the layer before, run every frame without rebuilding. Reports
+// the time per frame serially in layer order and on the pool, with real
+// work per node and with empty nodes (the scheduling overhead), and how
+// many nodes miss a deadline set on the last layer.
+//
+//   bench_task [threads=cores] [nodes=10000] [work=2000] [frames=200]
+
+using namespace ceres;
+
+constexpr size_t width = 100;
+
+double milliseconds (std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration <double, std::milli> (elapsed).count ();
+}
+
+// deterministic arithmetic standing in for a node's work
+uint64_t churn (uint64_t seed, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+
+    return seed;
+}
+
+struct frame
+{
+    std::vector <std::vector <uint32_t>> inputs;
+    std::vector <uint64_t> results;
+};
+
+frame build (task::graph &graph, size_t nodes, size_t &work)
+{
+    frame shape;
+    shape.inputs.resize (nodes);
+    shape.results.resize (nodes);
+
+    std::minstd_rand random {1};
+
+    for (uint32_t id = 0; id < nodes; ++id)
+    {
+        auto &inputs = shape.inputs[id];
+        auto &results = shape.results;
+
+        graph.add ([id, &inputs, &results, &work]
+        {
+            uint64_t seed = id;
+            for (auto input : inputs)
+                seed ^= results[input];
+
+            results[id] = churn (seed, work);
+        });
+
+        if (id < width)
+            continue;
+
+        // one to three inputs from the layer before
+        size_t layer = id / width * width - width;
+        size_t count = 1 + random () % 3;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t input = layer + random () % width;
+
+            if (std::find (inputs.begin (), inputs.end (), input) == inputs.end ())
+            {
+                inputs.push_back (input);
+                graph.precede (input, id);
+            }
+        }
+    }
+
+    return shape;
+}
+
+uint64_t serial (frame &shape, size_t work)
+{
+    for (uint32_t id = 0; id < shape.results.size (); ++id)
+    {
+        uint64_t seed = id;
+        for (auto input : shape.inputs[id])
+            seed ^= shape.results[input];
+
+        shape.results[id] = churn (seed, work);
+    }
+
+    return shape.results.back ();
+}
+
+int main (int argc, char **argv)
+{
+    size_t threads = argc > 1? std::stoul (argv[1]) : system::thread::core_count ();
+    size_t nodes = argc > 2? std::stoul (argv[2]) : 10000;
+    size_t work = argc > 3? std::stoul (argv[3]) : 2000;
+    size_t frames = argc > 4? std::stoul (argv[4]) : 200;
+
+    task::pool workers {threads};
+    task::graph graph;
+    size_t per_node = work;
+    frame shape = build (graph, nodes, per_node);
+
+    std::cout << "threads=" << workers.size () << " nodes=" << graph.size ()
+        << " work=" << work << " frames=" << frames << std::endl;
+
+    for (size_t iterations : {work, size_t (0)})
+    {
+        per_node = iterations;
+
+        auto start = std::chrono::steady_clock::now ();
+        uint64_t expected = 0;
+
+        for (size_t f = 0; f < frames; ++f)
+            expected = serial (shape, iterations);
+
+        double serial_ms = milliseconds (std::chrono::steady_clock::now () - start) / frames;
+
+        start = std::chrono::steady_clock::now ();
+
+        for (size_t f = 0; f < frames; ++f)
+            graph.run (workers);
+
+        double pool_ms = milliseconds (std::chrono::steady_clock::now () - start) / frames;
+        bool same = shape.results.back () == expected;
+
+        std::cout << "work=" << iterations << ": serial ms/frame=" << serial_ms
+            << " pool ms/frame=" << pool_ms << " speedup=" << serial_ms / pool_ms
+            << " ns/node=" << pool_ms * 1e6 / nodes << (same? "" : " MISMATCH") << std::endl;
+    }
+
+    // the last layer must start within half the parallel frame time
+    per_node = work;
+    graph.run (workers);
+    auto budget = (std::chrono::steady_clock::now () - graph.started ()) / 2;
+    std::atomic <size_t> handled {0};
+
+    for (uint32_t id = nodes - std::min (nodes, width); id < nodes; ++id)
+        graph.set_deadline (id, budget, [&handled] { ++handled; });
+
+    size_t expired = 0;
+    for (size_t f = 0; f < frames; ++f)
+    {
+        graph.run (workers);
+        expired += graph.expired ();
+    }
+
+    std::cout << "deadline ms=" << milliseconds (budget) << ": expired/frame="
+        << double (expired) / frames << " handled=" << handled << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <chrono>
+
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <core/hash.hpp>
+
+#include <system/platform.hpp>
+#include <io/net/socket.hpp>
+#include <io/net/reactor.hpp>
+#include <io/net/completion.hpp>
+
+// Local TCP echo on one server thread: the readiness reactor echoing from
+// its handlers, against the completion reactor on epoll and on io_uring.
+// Blocking client threads ping-pong fixed size messages, several in flight
+// per connection; reports round trips per second for each
+
+using namespace ceres;
+namespace net = io::net;
+using net::reactor;
+using net::completion_reactor;
+
+constexpr size_t message_size = 64;
+constexpr auto duration = std::chrono::seconds (2);
+
+net::socket::address const server {"127.0.0.1:47011"};
+
+// connects the clients and returns the server side of each connection
+std::vector <net::socket> connect (std::vector <net::socket> &clients, size_t count)
+{
+    net::socket listener {net::socket::type::TCP};
+    listener.set_reuse_address ();
+    listener.bind (server);
+    listener.listen (int (count));
+
+    std::vector <net::socket> accepted;
+
+    for (size_t c = 0; c < count; ++c)
+    {
+        clients.emplace_back (net::socket::type::TCP);
+        clients.back ().connect (server);
+
+        accepted.emplace_back ();
+        listener.accept (accepted.back ());
+    }
+
+    return accepted;
+}
+
+double load (std::vector <net::socket> &clients, size_t depth)
+{
+    std::atomic <size_t> total {0};
+    std::vector <std::thread> threads;
+
+    for (auto &sock : clients)
+    {
+        threads.emplace_back ([&]
+        {
+            uint8_t data [message_size] = {};
+            size_t count = 0, sent, received;
+
+            auto finish = std::chrono::steady_clock::now () + duration;
+
+            while (std::chrono::steady_clock::now () < finish)
+            {
+                for (size_t i = 0; i < depth; ++i)
+                    if (sock.send ({data, sizeof (data)}, sent))
+                        return;
+
+                for (size_t got = 0; got < depth * sizeof (data); got += received)
+                    if (sock.receive ({data, sizeof (data)}, received) || !received)
+                        return;
+
+                count += depth;
+            }
+
+            total += count;
+        });
+    }
+
+    for (auto &t : threads)
+        t.join ();
+
+    return total / std::chrono::duration<double> (duration).count ();
+}
+
+double readiness (size_t count, size_t depth)
+{
+    std::vector <net::socket> clients;
+    auto accepted = connect (clients, count);
+
+    reactor r;
+
+    for (auto &sock : accepted)
+    {
+        r.add (std::move (sock), [] (net::socket &s, uint32_t events)
+        {
+            uint8_t data [4096];
+            size_t received, sent;
+
+            if (events & reactor::readable)
+                while (!s.receive ({data, sizeof (data)}, received) && received > 0)
+                    s.send ({data, received}, sent);
+        },
+        reactor::readable);
+    }
+
+    scoped_thread server {std::thread {[&r] { r.run (); }}};
+    auto rate = load (clients, depth);
+    r.stop ();
+
+    return rate;
+}
+
+double completion (completion_reactor::backend kind, size_t count, size_t depth, bool &used)
+{
+    std::vector <net::socket> clients;
+    auto accepted = connect (clients, count);
+
+    completion_reactor r {kind};
+    used = r.get_backend () == kind;
+
+    for (auto &sock : accepted)
+    {
+        r.add (std::move (sock), [&r] (net::socket::handle_type handle,
+                    memory::bytebuffer const &data, std::error_code error)
+        {
+            if (!error && data.bytes > 0)
+                r.send (handle, data);
+        });
+    }
+
+    scoped_thread server {std::thread {[&r] { r.run (); }}};
+    auto rate = load (clients, depth);
+    r.stop ();
+
+    return rate;
+}
+
+int main (int argc, char **argv)
+{
+    size_t clients = argc > 1? std::stoul (argv[1]) : 8;
+    size_t depth = argc > 2? std::stoul (argv[2]) : 4;
+
+    bool epoll = false, uring = false;
+
+    std::cout << "clients=" << clients << " depth=" << depth << std::endl;
+    std::cout << "readiness  round trips/s=" << readiness (clients, depth) << std::endl;
+
+    auto rate = completion (completion_reactor::backend::epoll, clients, depth, epoll);
+    std::cout << "completion/epoll round trips/s=" << rate << std::endl;
+
+    rate = completion (completion_reactor::backend::uring, clients, depth, uring);
+    std::cout << "completion/uring round trips/s=" << rate
+        << (uring? "" : " (io_uring unavailable, ran on epoll)") << std::endl;
+
+    return 0;
+}
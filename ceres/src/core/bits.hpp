@@ -47,6 +47,19 @@ namespace ceres { namespace core { namespace bit {
 #endif
     }
 
+    inline uint32_t trailing_zeros (uint64_t x)
+    {
+        static_assert (sizeof(uint64_t) == sizeof(unsigned long long), "type mismatch");
+        ASSERTF (x != 0, "result for zero is undefined");
+
+#if defined __GNUC__
+        return __builtin_ctzll (x);
+#else
+        ASSERTF (false, "not implemented");
+        return 0;
+#endif
+    }
+
     inline uint32_t count (uint32_t x)
     {
         static_assert (sizeof(uint32_t) == sizeof(unsigned int), "type mismatch");
@@ -59,6 +72,18 @@ namespace ceres { namespace core { namespace bit {
 #endif
     }
 
+    inline uint32_t count (uint64_t x)
+    {
+        static_assert (sizeof(uint64_t) == sizeof(unsigned long long), "type mismatch");
+
+#if defined __GNUC__
+        return __builtin_popcountll (x);
+#else
+        ASSERTF (false, "not implemented");
+        return 0;
+#endif
+    }
+
     inline uint32_t parity (uint32_t x)
     {
         static_assert (sizeof(uint32_t) == sizeof(unsigned int), "type mismatch");
@@ -37,6 +37,7 @@
 #else
 #define ASSERTF(cond, ...) ((void) 0)
 #define ASSUMEF(cond, ...) ((void) 0)
+#define WATCHF(cond, ...) ((void) 0)
 #define CONFIRMF(cond, ...) ((void) 0)
 #endif
     
@@ -1,6 +1,12 @@
 #ifndef _HASH_HPP_
 #define _HASH_HPP_
 
+#if defined __SSE4_2__
+#include <nmmintrin.h>
+#elif defined __ARM_FEATURE_CRC32
+#include <arm_acle.h>
+#endif
+
 namespace ceres { namespace core {
 
     // Design: simple and fast 32bit value for any buffered input.
@@ -33,6 +39,115 @@ namespace ceres { namespace core {
         return hash;
     }
 
+    //=========================================================================
+    // CRC-32C (Castagnoli): hardware accelerated where the target supports it.
+    // All paths compute the standard reflected CRC-32C, so a value hashed at
+    // compile time is bit for bit equal to the same bytes hashed at runtime.
+
+    constexpr uint32_t crc32c_reflected = 0x82F63B78; // bit-reversed core::crc32c
+    constexpr uint32_t crc32c_initial = 0xFFFFFFFF;
+
+    //-------------------------------------------------------------------------
+    // Compile-time path: bitwise recursion satisfies C++11 constexpr rules
+
+    constexpr uint32_t crc32c_bits (uint32_t crc, int bits)
+    {
+        return bits == 0? crc :
+            crc32c_bits ((crc >> 1) ^ (crc32c_reflected & (0u - (crc & 1u))), bits - 1);
+    }
+
+    constexpr uint32_t crc32c_string (uint32_t crc, char const *str)
+    {
+        return *str == '\0'? crc :
+            crc32c_string (crc32c_bits (crc ^ static_cast<uint8_t> (*str), 8), str + 1);
+    }
+
+    constexpr uint32_t crc32c_literal (char const *str, uint32_t crc = crc32c_initial)
+    {
+        return ~crc32c_string (crc, str);
+    }
+
+    //-------------------------------------------------------------------------
+    // Portable runtime path: byte-wise table lookup
+
+    inline uint32_t const *crc32c_table ()
+    {
+        struct table
+        {
+            uint32_t entries [256];
+
+            table ()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                    entries[i] = crc32c_bits (i, 8);
+            }
+        };
+
+        static table const instance; // C++11 guarantees thread-safe init
+        return instance.entries;
+    }
+
+    inline uint32_t crc32c_portable (uint8_t const *data, size_t bytes, uint32_t crc)
+    {
+        auto table = crc32c_table ();
+
+        while (bytes--)
+            crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+        return crc;
+    }
+
+    //-------------------------------------------------------------------------
+    // Runtime path: 8 bytes per step in hardware; unaligned loads via memcpy
+
+    inline uint32_t crc32c_update (void const *pointer, size_t bytes, uint32_t crc)
+    {
+        auto data = static_cast <uint8_t const *> (pointer);
+
+#if defined __SSE4_2__ && defined __x86_64__
+        uint64_t wide = crc;
+        for (; bytes >= sizeof (uint64_t); bytes -= sizeof (uint64_t))
+        {
+            uint64_t block;
+            std::memcpy (&block, data, sizeof (block));
+            wide = _mm_crc32_u64 (wide, block);
+            data += sizeof (block);
+        }
+
+        crc = static_cast <uint32_t> (wide);
+        while (bytes--)
+            crc = _mm_crc32_u8 (crc, *data++);
+
+        return crc;
+#elif defined __ARM_FEATURE_CRC32
+        for (; bytes >= sizeof (uint64_t); bytes -= sizeof (uint64_t))
+        {
+            uint64_t block;
+            std::memcpy (&block, data, sizeof (block));
+            crc = __crc32cd (crc, block);
+            data += sizeof (block);
+        }
+
+        while (bytes--)
+            crc = __crc32cb (crc, *data++);
+
+        return crc;
+#else
+        return crc32c_portable (data, bytes, crc);
+#endif
+    }
+
+    inline uint32_t crc32c_hash (void const *pointer, size_t bytes, uint32_t crc = crc32c_initial)
+    {
+        return ~crc32c_update (pointer, bytes, crc);
+    }
+
+    template <typename T>
+    uint32_t crc32c_hash (memory::buffer<T> const &buf, uint32_t crc = crc32c_initial)
+    {
+        return crc32c_hash (buf.pointer, buf.bytes, crc);
+    }
+
 } }
 
 #endif
@@ -3,50 +3,78 @@
 
 namespace ceres { namespace core {
 
+    //-------------------------------------------------------------------------
+    // 32bit hashed name; compares as a single integer. Every name built at
+    // run time, from a literal or not, is interned in the global name table
+    // so any build can map it back to its string and collisions are caught
+    // on insert. name::literal makes a compile-time constant instead, which
+    // is not interned until the same string is named at run time.
+
     class name
     {
         public:
-            name () : hash_ {0} {}
+            constexpr name () : hash_ {0} {}
 
-            name (char const *str) : 
-#ifdef DEBUG
-                name_ (str),
-#endif
-                hash_ (compute_hash (str)) {}
+            // char arrays, literal or not, are hashed and interned
+            template <size_t N>
+            name (char const (&str) [N]) : 
+                hash_ (compute_hash (str, strnlen (str, N))) {}
+
+            template <size_t N>
+            name (char (&str) [N]) : 
+                hash_ (compute_hash (str, strnlen (str, N))) {}
+
+            // run-time strings are hashed in hardware where available
+            template <typename String, typename = typename std::enable_if<
+                std::is_convertible <String, char const *>::value && 
+                !std::is_array <String>::value>::type>
+            name (String const &str) : 
+                hash_ (compute_hash (str, strlen (str))) {}
+
+            // run-time string of known length, which need not be terminated
+            name (char const *str, size_t bytes) :
+                hash_ (compute_hash (str, bytes)) {}
+
+            // string literals hashed at compile time, for constants
+            template <size_t N>
+            constexpr static name literal (char const (&str) [N])
+            {
+                return name {crc32c_literal (str), hashed {}};
+            }
 
         public:
-            operator uint32_t () const { return hash_; }
-#ifdef DEBUG
-            char const *string () const { return name_; }
-#endif
+            constexpr operator uint32_t () const { return hash_; }
+
+            // null when the name was never interned: one only ever made by
+            // name::literal has no string, so callers must check before use
+            char const *string () const { return names ().lookup (hash_); }
+
         public:
-           bool operator== (name const &r) { return hash_ == r.hash_; }
-           bool operator< (name const &r) { return hash_ < r.hash_; }
+           constexpr bool operator== (name const &r) const { return hash_ == r.hash_; }
+           constexpr bool operator< (name const &r) const { return hash_ < r.hash_; }
 
         private:
-            uint32_t compute_hash (char const *str)
-            {
-                // NOTE: std::hash would require extra copy in std::string
+            struct hashed {};
 
-                uint32_t hash = core::crc32c;
+            constexpr name (uint32_t hash, hashed) : hash_ {hash} {}
 
-                auto bytes = strlen (str);
-                memory::buffer <uint32_t const> buf {str, bytes};
-
-                auto remainder = bytes - buf.bytes;
-                memory::buffer <uint8_t const> post {end (buf), remainder};
+            static uint32_t compute_hash (char const *str, size_t bytes)
+            {
+                // NOTE: std::hash would require extra copy in std::string
+                auto hash = crc32c_hash (str, bytes);
 
-                hash = block_hash_32 (buf, hash, core::crc32c);
-                hash = block_hash_32 (post, hash, core::crc32c);
+                auto result = names ().intern (hash, str, bytes);
+                ASSERTF (result != global_name_table::result::collision,
+                        "name '%.*s' collides with '%s'", (int) bytes, str, names ().lookup (hash));
+                WATCHF (result != global_name_table::result::full,
+                        "name table is full; '%.*s' will not be reverse mapped", (int) bytes, str);
+                (void) result;
 
                 return hash;
             }
 
         private:
-#ifdef DEBUG
-            char const *name_;
-#endif
-            uint32_t    hash_;
+            uint32_t hash_;
     };
 
 } }
@@ -0,0 +1,133 @@
+#ifndef CORE_NAME_TABLE_HPP_
+#define CORE_NAME_TABLE_HPP_
+
+namespace ceres { namespace core {
+
+    //=========================================================================
+    // Lock-free, append-only map from 32bit name hash to the original string.
+    // Open addressing with linear probing; a slot is claimed by CAS on its
+    // hash and its string becomes visible once the pointer is published.
+    // Strings are copied into a fixed arena that is never freed, so returned
+    // pointers stay valid for the life of the program. Hash zero is the
+    // empty string (CRC-32C of no bytes) and is never stored.
+
+    template <size_t Slots, size_t Bytes>
+    class name_table
+    {
+        public:
+            static_assert ((Slots & (Slots - 1)) == 0, "slot count must be a power of 2");
+
+            enum class result { inserted, existing, collision, full };
+
+        public:
+            result intern (uint32_t hash, char const *str, size_t length)
+            {
+                if (hash == 0)
+                    return result::existing;
+
+                for (size_t probe = 0; probe < Slots; ++probe)
+                {
+                    slot &entry = slots_[(hash + probe) & (Slots - 1)];
+                    uint32_t key = entry.hash.load (std::memory_order_acquire);
+
+                    if (key == 0)
+                    {
+                        char *copy = allocate (length + 1);
+                        if (copy == nullptr)
+                            return result::full;
+
+                        std::memcpy (copy, str, length);
+                        copy[length] = '\0';
+
+                        // on failure key is reloaded; the copy is abandoned to the arena
+                        if (entry.hash.compare_exchange_strong (key, hash, std::memory_order_acq_rel))
+                        {
+                            entry.string.store (copy, std::memory_order_release);
+                            return result::inserted;
+                        }
+                    }
+
+                    if (key == hash)
+                    {
+                        char const *existing = published (entry);
+                        bool same = std::strncmp (existing, str, length) == 0 &&
+                            existing[length] == '\0';
+
+                        if (!same)
+                            collisions_.fetch_add (1, std::memory_order_relaxed);
+
+                        return same? result::existing : result::collision;
+                    }
+                }
+
+                return result::full;
+            }
+
+            char const *lookup (uint32_t hash) const
+            {
+                if (hash == 0)
+                    return "";
+
+                for (size_t probe = 0; probe < Slots; ++probe)
+                {
+                    slot const &entry = slots_[(hash + probe) & (Slots - 1)];
+                    uint32_t key = entry.hash.load (std::memory_order_acquire);
+
+                    if (key == hash)
+                        return published (entry);
+
+                    if (key == 0)
+                        break;
+                }
+
+                return nullptr;
+            }
+
+            size_t collisions () const { return collisions_.load (std::memory_order_relaxed); }
+            size_t bytes_used () const { return used_.load (std::memory_order_relaxed); }
+
+        private:
+            struct slot
+            {
+                std::atomic<uint32_t>       hash;
+                std::atomic<char const *>   string;
+            };
+
+            static char const *published (slot const &entry)
+            {
+                // slot claimed but string not yet stored by the inserting thread
+                char const *str;
+                while ((str = entry.string.load (std::memory_order_acquire)) == nullptr)
+                    std::this_thread::yield ();
+
+                return str;
+            }
+
+            char *allocate (size_t bytes)
+            {
+                size_t offset = used_.fetch_add (bytes, std::memory_order_relaxed);
+                return (offset + bytes <= Bytes)? storage_ + offset : nullptr;
+            }
+
+        private:
+            // zero initialized in static storage; no constructor runs
+            slot                slots_ [Slots];
+            std::atomic<size_t> used_;
+            std::atomic<size_t> collisions_;
+            char                storage_ [Bytes];
+    };
+
+    //-------------------------------------------------------------------------
+    // Process-wide table shared by all core::name instances
+
+    using global_name_table = name_table <(1u << 16), (1u << 20)>;
+
+    inline global_name_table &names ()
+    {
+        static global_name_table table;
+        return table;
+    }
+
+} }
+
+#endif
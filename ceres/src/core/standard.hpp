@@ -2,17 +2,28 @@
 #define _STANDARD_HPP_
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
+#include <cmath>
 
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <type_traits>
+#include <limits>
 #include <utility>
+#include <functional>
+#include <tuple>
 #include <memory>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include <fstream>
 #include <system_error>
@@ -10,7 +10,7 @@ namespace ceres { namespace core {
     {
         public:
             stream (memory::buffer<E> const &buf)
-                : buf_ {buf}
+                : buf_ {buf}, mask_ {core::bit::is_power_2 (size (buf))? size (buf) - 1 : 0}
             {}
 
             explicit operator bool () const { return !error_; }
@@ -27,7 +27,7 @@ namespace ceres { namespace core {
                 {
                     IO::insert (buf_.items[wrpos_], item);
 
-                    ++wrpos_ %= size (buf_);
+                    advance (wrpos_);
                     ++size_;
                 }
 
@@ -45,13 +45,53 @@ namespace ceres { namespace core {
                 {
                     IO::extract (buf_.items[rdpos_], item);
 
-                    ++rdpos_ %= size (buf_);
+                    advance (rdpos_);
                     --size_;
                 }
 
                 return *this;
             }
 
+            // fused insertion: one capacity check for the whole item list
+            template <typename ...T>
+            stream &write (T const &...items)
+            {
+                ASSERTF (vacant () >= sizeof...(items), "writing past the end of a stream");
+
+                error_ = error_ || vacant () < sizeof...(items);
+
+                if (!error_)
+                {
+                    int expand [] = {0, (IO::insert (buf_.items[wrpos_], items), 
+                            advance (wrpos_), 0)...};
+                    (void) expand;
+
+                    size_ += sizeof...(items);
+                }
+
+                return *this;
+            }
+
+            // fused extraction: one occupancy check for the whole item list
+            template <typename ...T>
+            stream &read (T &...items)
+            {
+                ASSERTF (occupied () >= sizeof...(items), "reading past the end of a stream");
+
+                error_ = error_ || occupied () < sizeof...(items);
+
+                if (!error_)
+                {
+                    int expand [] = {0, (IO::extract (buf_.items[rdpos_], items), 
+                            advance (rdpos_), 0)...};
+                    (void) expand;
+
+                    size_ -= sizeof...(items);
+                }
+
+                return *this;
+            }
+
             bool full () const { return size_ == size (buf_); }
             bool empty () const { return size_ == 0; }
 
@@ -61,14 +101,21 @@ namespace ceres { namespace core {
 
             void reset () { error_ = false; size_ = rdpos_ = wrpos_ = 0; }
 
+        private:
+            // power of two sized buffers (eg. memory::pow2_size_buffer or
+            // memory::allocate_pow2) wrap with a mask rather than a division
+            void advance (size_t &pos) const
+            {
+                pos = mask_? (pos + 1) & mask_ : (pos + 1) % size (buf_);
+            }
+
         private:
             memory::buffer<E> buf_;
+            size_t mask_;
             size_t size_ = 0, rdpos_ = 0, wrpos_ = 0;
             bool error_ = false;
     };
     
-    // TODO: pow2_size_buffers?
-
     // byte stream ============================================================
     
     template <typename IO>
@@ -79,6 +126,13 @@ namespace ceres { namespace core {
                 : buf_ {buf}
             {}
 
+            // over bytes already written, e.g. a received datagram
+            stream (memory::bytebuffer const &buf, size_t filled)
+                : buf_ {buf}, wrpos_ {filled}
+            {
+                ASSERTF (filled <= size (buf), "filled past the end of a stream");
+            }
+
             explicit operator bool () const { return !error_; }
 
         public:
@@ -116,6 +170,82 @@ namespace ceres { namespace core {
                 return *this;
             }
 
+            // fused insertion: one capacity check for the whole item list
+            template <typename ...T>
+            stream &write (T const &...items)
+            {
+                memory::bytebuffer wrbuf {begin (buf_) + wrpos_, vacant ()};
+
+                size_t bytes = 0;
+                int sizes [] = {0, (bytes += IO::commit_size (wrbuf, items), 0)...};
+                (void) sizes;
+
+                ASSERTF (vacant () >= bytes, "writing past the end of a stream");
+                error_ = error_ || vacant () < bytes;
+
+                if (!error_)
+                {
+                    int inserts [] = {0, (IO::insert (wrbuf, items), 0)...};
+                    (void) inserts;
+
+                    wrpos_ += bytes;
+                }
+
+                return *this;
+            }
+
+            // fused extraction: one occupancy check for the whole item list
+            template <typename ...T>
+            stream &read (T &...items)
+            {
+                memory::bytebuffer rdbuf {begin (buf_) + rdpos_, occupied ()};
+
+                size_t bytes = 0;
+                int sizes [] = {0, (bytes += IO::commit_size (rdbuf, items), 0)...};
+                (void) sizes;
+
+                ASSERTF (occupied () >= bytes, "reading past the end of a stream");
+                error_ = error_ || occupied () < bytes;
+
+                if (!error_)
+                {
+                    int extracts [] = {0, (IO::extract (rdbuf, items), 0)...};
+                    (void) extracts;
+
+                    rdpos_ += bytes;
+                }
+
+                return *this;
+            }
+
+            // raw bytes, copied in unmapped
+            stream &write_bytes (memory::bytebuffer const &bytes)
+            {
+                error_ = error_ || vacant () < bytes.bytes;
+
+                if (!error_)
+                {
+                    std::memcpy (begin (buf_) + wrpos_, bytes.pointer, bytes.bytes);
+                    wrpos_ += bytes.bytes;
+                }
+
+                return *this;
+            }
+
+            // raw bytes, viewed in place rather than copied out
+            stream &read_bytes (memory::bytebuffer &bytes, size_t count)
+            {
+                error_ = error_ || occupied () < count;
+
+                if (!error_)
+                {
+                    bytes.reset ({begin (buf_) + rdpos_, count});
+                    rdpos_ += count;
+                }
+
+                return *this;
+            }
+
             bool full () const { return wrpos_ == size (buf_); }
             bool empty () const { return wrpos_ == rdpos_; }
 
@@ -178,6 +308,54 @@ namespace ceres { namespace core {
                 return *this;
             }
 
+            // fused insertion: one capacity check for the whole item list
+            template <typename ...T>
+            stream &write (T const &...items)
+            {
+                memory::bitbuffer wrbuf {buf_.base, buf_.limit, wrpos_};
+
+                size_t bits = 0;
+                int sizes [] = {0, (bits += IO::commit_size (wrbuf, items), 0)...};
+                (void) sizes;
+
+                ASSERTF (size (wrbuf) >= bits, "writing past the end of a stream");
+                error_ = error_ || size (wrbuf) < bits;
+
+                if (!error_)
+                {
+                    int inserts [] = {0, (IO::insert (wrbuf, items), 0)...};
+                    (void) inserts;
+
+                    wrpos_ += bits;
+                }
+
+                return *this;
+            }
+
+            // fused extraction: one occupancy check for the whole item list
+            template <typename ...T>
+            stream &read (T &...items)
+            {
+                memory::bitbuffer rdbuf {buf_.base, wrpos_, rdpos_};
+
+                size_t bits = 0;
+                int sizes [] = {0, (bits += IO::commit_size (rdbuf, items), 0)...};
+                (void) sizes;
+
+                ASSERTF (size (rdbuf) >= bits, "reading past the end of a stream");
+                error_ = error_ || size (rdbuf) < bits;
+
+                if (!error_)
+                {
+                    int extracts [] = {0, (IO::extract (rdbuf, items), 0)...};
+                    (void) extracts;
+
+                    rdpos_ += bits;
+                }
+
+                return *this;
+            }
+
             bool full () const { return wrpos_ == size (buf_); }
             bool empty () const { return wrpos_ == rdpos_; }
 
@@ -199,31 +377,22 @@ namespace ceres { namespace core {
     using basicstream = stream <E, policy::data::mapper::native>;
     using bytestream = stream <uint8_t, policy::data::mapper::native>;
     using bitstream = stream <bool, policy::data::mapper::native>;
+    using netstream = stream <uint8_t, policy::data::mapper::network>;
 
     // serialization ----------------------------------------------------------
+    // Items are written and read in one fused operation per call, so the
+    // stream performs a single capacity check for the whole argument list.
     
-    template <typename Stream, typename T>
-    bool serialize (Stream &stream, T arg)
-    {
-        return (bool) (stream << arg);
-    }
-
-    template <typename Stream, typename T, typename ...Types>
-    bool serialize (Stream &stream, T arg, Types ...args)
-    {
-        return (stream << arg) && serialize (stream, std::forward<Types> (args)...);
-    }
-
-    template <typename Stream, typename T>
-    bool deserialize (Stream &stream, T arg)
+    template <typename Stream, typename ...Types>
+    bool serialize (Stream &stream, Types const &...args)
     {
-        return (bool) (stream >> arg);
+        return (bool) stream.write (args...);
     }
 
-    template <typename Stream, typename T, typename ...Types>
-    bool deserialize (Stream &stream, T arg, Types ...args)
+    template <typename Stream, typename ...Types>
+    bool deserialize (Stream &stream, Types &...args)
     {
-        return (stream >> arg) && deserialize (stream, std::forward<Types> (args)...);
+        return (bool) stream.read (args...);
     }
 } }
 
@@ -51,7 +51,6 @@ namespace ceres { namespace core {
     }
 
     //---------------------------------------------------------------------
-    // TODO alignment
 
     template <typename T>
     constexpr T max (T a, T b)
@@ -64,10 +63,33 @@ namespace ceres { namespace core {
         return 0; 
     }
 
-    template <typename T, typename ...Ts>
+    template <typename T>
+    constexpr size_t max_type_size () 
+    { 
+        return sizeof(T);
+    }
+
+    template <typename T, typename U, typename ...Ts>
     constexpr size_t max_type_size () 
     { 
-        return max (sizeof(T), max_type_size());
+        return max (sizeof(T), max_type_size<U, Ts...>());
+    }
+
+    constexpr size_t max_type_align () 
+    { 
+        return 1; 
+    }
+
+    template <typename T>
+    constexpr size_t max_type_align () 
+    { 
+        return std::alignment_of<T>::value;
+    }
+
+    template <typename T, typename U, typename ...Ts>
+    constexpr size_t max_type_align () 
+    { 
+        return max (std::alignment_of<T>::value, max_type_align<U, Ts...>());
     }
 
     //---------------------------------------------------------------------
@@ -78,10 +100,16 @@ namespace ceres { namespace core {
         return 0; 
     }
 
-    template <typename T, typename ...Ts>
+    template <typename T>
+    constexpr size_t sum_type_size () 
+    { 
+        return sizeof(T);
+    }
+
+    template <typename T, typename U, typename ...Ts>
     constexpr size_t sum_type_size () 
     { 
-        return sizeof(T) + sum_type_size();
+        return sizeof(T) + sum_type_size<U, Ts...>();
     }
 
     //---------------------------------------------------------------------
@@ -1,6 +1,12 @@
 #ifndef DATA_ENDIAN_HPP_
 #define DATA_ENDIAN_HPP_
 
+#if defined (__SSSE3__)
+#include <immintrin.h>
+#elif defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace ceres { namespace data { namespace endian {
 
     enum class type { little, big };
@@ -13,10 +19,10 @@ namespace ceres { namespace data { namespace endian {
             uint8_t byte [sizeof(word)];
         };
         
-        return (convert {.word = 1}.byte[0] = 0)? type::big : type::little;
+        return (convert {.word = 1}.byte[0] == 0)? type::big : type::little;
     }
 
-    constexpr bool is_big = false;      // TODO: use platform defines to set this
+    constexpr bool is_big = __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
     constexpr bool is_little = !is_big;
 
     struct big {};          // tag type for big endian conversion
@@ -81,36 +87,171 @@ namespace ceres { namespace data { namespace endian {
         return cast.real; 
     }
 
+    //-------------------------------------------------------------------------
+    // Bulk byte swapping of arrays of 2, 4 or 8 byte values: vector shuffles
+    // reverse 16 bytes (32 with AVX2) at a time and a scalar loop takes the 
+    // tail. Either pointer may be unaligned; they may be equal to swap in 
+    // place but must not otherwise overlap.
+
+    template <size_t Size> struct unsigned_of;
+    template <> struct unsigned_of <1> { using type = uint8_t; };
+    template <> struct unsigned_of <2> { using type = uint16_t; };
+    template <> struct unsigned_of <4> { using type = uint32_t; };
+    template <> struct unsigned_of <8> { using type = uint64_t; };
+
+    // one value at a time; the reference for, and the tail of, the vector path
+    template <size_t Size>
+    inline void byte_swap_array_scalar (void *dst, void const *src, size_t count)
+    {
+        using word = typename unsigned_of <Size>::type;
+
+        auto out = static_cast <uint8_t *> (dst);
+        auto in = static_cast <uint8_t const *> (src);
+
+        for (size_t done = 0; done < count * Size; done += Size)
+        {
+            word value;
+            std::memcpy (&value, in + done, Size);
+            value = byte_swap (value);
+            std::memcpy (out + done, &value, Size);
+        }
+    }
+
+    // shuffle index reversing the bytes of each Size byte lane
+    template <size_t Size>
+    constexpr uint8_t reversed_lane (size_t index)
+    {
+        return index - index % Size + (Size - 1 - index % Size);
+    }
+
+    template <size_t Size>
+    inline void byte_swap_array (void *dst, void const *src, size_t count)
+    {
+        auto out = static_cast <uint8_t *> (dst);
+        auto in = static_cast <uint8_t const *> (src);
+        size_t bytes = count * Size, done = 0;
+
+        if (Size == 1)
+        {
+            if (dst != src)
+                std::memcpy (dst, src, bytes);
+            return;
+        }
+
+#if defined (__SSSE3__)
+        uint8_t lanes [32];
+        for (size_t i = 0; i < sizeof (lanes); ++i)
+            lanes[i] = reversed_lane <Size> (i);
+
+#if defined (__AVX2__)
+        auto const wide = _mm256_loadu_si256 (reinterpret_cast <__m256i const *> (lanes));
+        auto shuffle_wide = [wide, in, out] (size_t at)
+        {
+            auto value = _mm256_loadu_si256 (reinterpret_cast <__m256i const *> (in + at));
+            _mm256_storeu_si256 (reinterpret_cast <__m256i *> (out + at), _mm256_shuffle_epi8 (value, wide));
+        };
+
+        for (; done + 128 <= bytes; done += 128)
+            shuffle_wide (done), shuffle_wide (done + 32), shuffle_wide (done + 64), shuffle_wide (done + 96);
+#endif
+        auto const mask = _mm_loadu_si128 (reinterpret_cast <__m128i const *> (lanes));
+        auto shuffle = [mask, in, out] (size_t at)
+        {
+            auto value = _mm_loadu_si128 (reinterpret_cast <__m128i const *> (in + at));
+            _mm_storeu_si128 (reinterpret_cast <__m128i *> (out + at), _mm_shuffle_epi8 (value, mask));
+        };
+
+        // four independent shuffles per iteration keep the ports busy
+        for (; done + 64 <= bytes; done += 64)
+            shuffle (done), shuffle (done + 16), shuffle (done + 32), shuffle (done + 48);
+
+        for (; done + 16 <= bytes; done += 16)
+            shuffle (done);
+#elif defined (__ARM_NEON)
+        for (; done + 16 <= bytes; done += 16)
+        {
+            auto value = vld1q_u8 (in + done);
+            vst1q_u8 (out + done, 
+                Size == 2? vrev16q_u8 (value) : 
+                Size == 4? vrev32q_u8 (value) : vrev64q_u8 (value));
+        }
+#endif
+        byte_swap_array_scalar <Size> (out + done, in + done, (bytes - done) / Size);
+    }
+
     template <typename From, typename To>
     struct map;
 
-    template <>
-    struct map<big, big>
+    // identity maps compile to nothing in place and to a copy out of place
+    struct same_order
     {
         template <typename T>
         static T convert (T value) { return value; }
+
+        template <typename T>
+        static void convert (void *dst, void const *src, size_t count) 
+        { 
+            if (dst != src)
+                std::memcpy (dst, src, count * sizeof (T));
+        }
     };
-    
-    template <>
-    struct map<big, little>
+
+    struct swap_order
     {
         template <typename T>
         static T convert (T value) { return byte_swap (value); } 
-    };
 
-    template <>
-    struct map<little, big>
-    {
         template <typename T>
-        static T convert (T value) { return byte_swap (value); }
+        static void convert (void *dst, void const *src, size_t count) 
+        { 
+            byte_swap_array <sizeof (T)> (dst, src, count); 
+        }
     };
-    
-    template <>
-    struct map<little, little>
+
+    template <> struct map<big, big> : same_order {};
+    template <> struct map<big, little> : swap_order {};
+    template <> struct map<little, big> : swap_order {};
+    template <> struct map<little, little> : same_order {};
+
+    template <typename T>
+    T make_network_byte_order (T value)
     {
-        template <typename T>
-        static T convert (T value) { return value; }
-    };
+        return map<native, network>::convert (value);
+    }
+
+    template <typename T>
+    T make_host_byte_order (T value)
+    {
+        return map<network, native>::convert (value);
+    }
+
+    // arrays; the host side is typed, the network side may be unaligned ......
+
+    template <typename T>
+    void make_network_byte_order (void *dst, T const *src, size_t count)
+    {
+        static_assert (std::is_arithmetic <T>::value, "arithmetic arrays only");
+        map<native, network>::convert <T> (dst, src, count);
+    }
+
+    template <typename T>
+    void make_host_byte_order (T *dst, void const *src, size_t count)
+    {
+        static_assert (std::is_arithmetic <T>::value, "arithmetic arrays only");
+        map<network, native>::convert <T> (dst, src, count);
+    }
+
+    template <typename T>
+    void make_network_byte_order (T *values, size_t count)
+    {
+        make_network_byte_order (static_cast <void *> (values), values, count);
+    }
+
+    template <typename T>
+    void make_host_byte_order (T *values, size_t count)
+    {
+        make_host_byte_order (values, static_cast <void const *> (values), count);
+    }
 
 } } }
 
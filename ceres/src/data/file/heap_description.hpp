@@ -50,6 +50,34 @@ namespace ceres { namespace data { namespace file {
 
             return *this;
         }
+
+        // reads the next section and its entries in place, leaving the reader
+        // on the section after; false at the end of input or on a bad entry
+        bool read (io::file::format::ini_reader &reader)
+        {
+            using io::file::format::parse;
+
+            while (!reader.is_section ())
+                if (!reader.next ())
+                    return false;
+
+            auto section = reader.section ();
+            name = core::name {section.first, section.size ()};
+
+            while (reader.next () && !reader.is_section ())
+            {
+                auto key = reader.key ();
+                bool parsed = 
+                    key == "page_size"? parse (reader.value (), page_size) :
+                    key == "min_pages"? parse (reader.value (), min_pages) :
+                    key == "max_pages"? parse (reader.value (), max_pages) : true;
+
+                if (!parsed)
+                    return false;
+            }
+
+            return !reader.malformed ();
+        }
     };
 
 } } }
@@ -5,14 +5,17 @@ namespace ceres { namespace data { namespace map {
 
     //-------------------------------------------------------------------------
 
-#ifdef DEBUG
     std::ostream &operator<< (std::ostream &stream, core::name const &obj)
     {
-        stream << obj.string();
+        auto string = obj.string();
+
+        if (string)
+            stream << string;
+        else
+            stream << "#" << std::hex << (uint32_t) obj << std::dec;
 
         return stream;
     } 
-#endif
 
     std::istream &operator>> (std::istream &stream, core::name &obj)
     {
@@ -76,6 +79,41 @@ namespace ceres { namespace data { namespace map {
             return buf.reset (offset (typed, 1));
         }
 
+        // arrays ..............................................................
+
+        template <typename T>
+        size_t commit_size (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return items.bytes;
+        }
+
+        template <typename T>
+        bool can_insert (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return buf.bytes >= commit_size (buf, items);
+        }
+
+        template <typename T>
+        memory::bytebuffer &operator<< (memory::bytebuffer &buf, memory::buffer<T> const &items)
+        {
+            std::memcpy (begin (buf), items.pointer, items.bytes);
+            return buf.reset (offset (buf, items.bytes));
+        }
+
+        template <typename T>
+        bool can_extract (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return buf.bytes >= commit_size (buf, items);
+        }
+
+        // fills the caller's array
+        template <typename T>
+        memory::bytebuffer &operator>> (memory::bytebuffer &buf, memory::buffer<T> &items)
+        {
+            std::memcpy (begin (items), begin (buf), items.bytes);
+            return buf.reset (offset (buf, items.bytes));
+        }
+
         // bitbuffer  .........................................................
 
         template <typename T>
@@ -115,16 +153,19 @@ namespace ceres { namespace data { namespace map {
 
     namespace network
     {
+        using endian::make_network_byte_order;
+        using endian::make_host_byte_order;
+
         // buffer .............................................................
 
         template <typename T>
-        size_t commit_size (memory::bytebuffer &buf, T value)
+        size_t commit_size (memory::bytebuffer const &buf, T value)
         {
             return sizeof (value);
         }
 
         template <typename T>
-        bool can_insert (memory::bytebuffer &buf, T value)
+        bool can_insert (memory::bytebuffer const &buf, T value)
         {
             return buf.bytes >= commit_size (buf, value);
         }
@@ -138,7 +179,7 @@ namespace ceres { namespace data { namespace map {
         }
 
         template <typename T>
-        bool can_extract (memory::bytebuffer &buf, T value)
+        bool can_extract (memory::bytebuffer const &buf, T value)
         {
             return buf.bytes >= commit_size (buf, value);
         }
@@ -150,6 +191,41 @@ namespace ceres { namespace data { namespace map {
             value = make_host_byte_order (*begin (typed)); 
             return buf.reset (offset (typed, 1));
         }
+
+        // arrays, converted in bulk ..........................................
+
+        template <typename T>
+        size_t commit_size (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return items.bytes;
+        }
+
+        template <typename T>
+        bool can_insert (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return buf.bytes >= commit_size (buf, items);
+        }
+
+        template <typename T>
+        memory::bytebuffer &operator<< (memory::bytebuffer &buf, memory::buffer<T> const &items)
+        {
+            make_network_byte_order (begin (buf), begin (items), size (items));
+            return buf.reset (offset (buf, items.bytes));
+        }
+
+        template <typename T>
+        bool can_extract (memory::bytebuffer const &buf, memory::buffer<T> const &items)
+        {
+            return buf.bytes >= commit_size (buf, items);
+        }
+
+        // fills the caller's array
+        template <typename T>
+        memory::bytebuffer &operator>> (memory::bytebuffer &buf, memory::buffer<T> &items)
+        {
+            make_host_byte_order (begin (items), begin (buf), size (items));
+            return buf.reset (offset (buf, items.bytes));
+        }
     }
 
 } } }
@@ -0,0 +1,96 @@
+#ifndef DATA_SCHEMA_HPP_
+#define DATA_SCHEMA_HPP_
+
+namespace ceres { namespace data { namespace schema {
+
+    //=========================================================================
+    // Compile-time field lists describing the serialized layout of a struct.
+    // Each struct is described once; serialization is then generated as a
+    // single fused stream operation with one capacity check per message.
+
+    //-------------------------------------------------------------------------
+    // Binds a data member pointer into the type so access is resolved statically
+
+    template <typename Class, typename Type, Type Class::*Member>
+    struct field
+    {
+        typedef Class   class_type;
+        typedef Type    value_type;
+
+        static Type &get (Class &object) { return object.*Member; }
+        static Type const &get (Class const &object) { return object.*Member; }
+    };
+
+    //-------------------------------------------------------------------------
+    // Ordered list of fields; field order is the order on the wire
+
+    template <typename Class, typename ...Fields>
+    struct fields
+    {
+        typedef Class class_type;
+
+        constexpr static size_t nfields = sizeof...(Fields);
+
+        template <typename Stream>
+        static bool serialize (Stream &stream, Class const &object)
+        {
+            return (bool) stream.write (Fields::get (object)...);
+        }
+
+        template <typename Stream>
+        static bool deserialize (Stream &stream, Class &object)
+        {
+            return (bool) stream.read (Fields::get (object)...);
+        }
+    };
+
+} } }
+
+namespace traits
+{
+    namespace data
+    {
+        // Deliberately undefined: serializing a type without a schema is an error
+
+        template <typename Type>
+        struct schema;
+
+        // To describe a type specialize schema template within the
+        // implemented translation unit as follows:
+        //
+        // namespace traits
+        // {
+        //     namespace data
+        //     {
+        //         template <> struct schema <Point> :
+        //         public ceres::data::schema::fields <Point,
+        //             SCHEMA_FIELD (Point, x),
+        //             SCHEMA_FIELD (Point, y)> {};
+        //     }
+        // }
+    }
+}
+
+#define SCHEMA_FIELD(Class, member) \
+    ceres::data::schema::field <Class, decltype (Class::member), &Class::member>
+
+namespace ceres { namespace data { namespace schema {
+
+    //-------------------------------------------------------------------------
+    // Entry points for described types; work with any mapper policy stream
+
+    template <typename Stream, typename Type>
+    bool serialize (Stream &stream, Type const &object)
+    {
+        return traits::data::schema<Type>::serialize (stream, object);
+    }
+
+    template <typename Stream, typename Type>
+    bool deserialize (Stream &stream, Type &object)
+    {
+        return traits::data::schema<Type>::deserialize (stream, object);
+    }
+
+} } }
+
+#endif
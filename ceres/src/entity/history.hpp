@@ -0,0 +1,168 @@
+#ifndef _ENTITY_HISTORY_HPP_
+#define _ENTITY_HISTORY_HPP_
+
+namespace ceres { namespace entity {
+
+    //=========================================================================
+    // Ring of per-tick copies of a column for rolling back. Each copy is a
+    // table of copy-on-write pages of 64 dense slots, one per dirty word:
+    // capturing a tick copies only the pages with dirty components (or whose
+    // entities moved, when components were added or removed) and shares the
+    // rest with the tick before, so the ring holds memory in proportion to
+    // the change rate rather than its depth. Capture reads the dirty flags
+    // without clearing them; restoring a tick writes back only the pages
+    // that differ from the column, and drops the ticks after it.
+
+    template <typename Component>
+    class history
+    {
+        public:
+            typedef entity::page <Component> page;
+
+            constexpr static size_t page_size = page::size;
+
+        public:
+            explicit history (size_t depth) :
+                depth_ {std::max <size_t> (depth, 1)} {}
+
+        public:
+            bool empty () const { return ticks_.empty (); }
+            size_t size () const { return ticks_.size (); }
+
+            uint64_t oldest () const { return ticks_.front ().tick; }
+            uint64_t newest () const { return ticks_.back ().tick; }
+
+            // ticks need not be consecutive; only captured ones are held
+            bool contains (uint64_t tick) const
+            {
+                return find (tick) < size ();
+            }
+
+            // pages allocated across the ring
+            size_t pages () const { return pages_; }
+
+        public:
+            // ticks are captured in increasing order; the oldest falls off
+            // past the depth. Returns the pages copied.
+            size_t capture (uint64_t tick, column <Component> const &components)
+            {
+                ASSERTF (empty () || tick > newest (), "ticks out of order");
+
+                frame const *previous = empty ()? nullptr : &ticks_.back ();
+                bool moved = !previous || components.generation () != previous->generation;
+
+                static std::vector <std::shared_ptr <page>> const none;
+
+                frame next {tick, components.generation (), components.size (), {}};
+                size_t copied = copy_pages (components, moved, previous? previous->pages : none, next.pages,
+                        [] { return std::make_shared <page> (); });
+
+                ticks_.push_back (std::move (next));
+                pages_ += copied;
+
+                if (ticks_.size () > depth_)
+                {
+                    pages_ -= unshared (ticks_[0], &ticks_[1]);
+                    ticks_.pop_front ();
+                }
+
+                return copied;
+            }
+
+            // puts the column back as captured at the tick, with its dirty
+            // flags clear, and drops later ticks; returns the pages written,
+            // none when the tick is not held
+            size_t restore (uint64_t tick, column <Component> &components)
+            {
+                size_t index = find (tick);
+
+                ASSERTF (index < size (), "tick is not in the history");
+                if (index == size ())
+                    return 0;
+
+                frame &target = ticks_[index];
+                frame &latest = ticks_.back ();
+                size_t written = 0;
+
+                bool moved = components.generation () != latest.generation ||
+                    target.generation != latest.generation || target.size != latest.size;
+
+                if (moved)
+                {
+                    // entities were added or removed since: rebuild whole
+                    components.clear ();
+
+                    for (auto &p : target.pages)
+                        for (size_t i = 0; i < p->count; ++i)
+                            components.emplace (p->entities[i], p->items[i]);
+
+                    written = target.pages.size ();
+                }
+                else
+                {
+                    // same entities throughout: only the pages changed since
+                    // the target, in the ring or since the last capture
+                    auto values = components.components ();
+
+                    for (size_t p = 0; p < target.pages.size (); ++p)
+                    {
+                        if (target.pages[p] == latest.pages[p] && components.dirty ().word (p) == 0)
+                            continue;
+
+                        std::copy (target.pages[p]->items, target.pages[p]->items + target.pages[p]->count,
+                                values.items + p * page_size);
+                        ++written;
+                    }
+                }
+
+                components.dirty ().clear ();
+                target.generation = components.generation ();
+
+                while (ticks_.size () > index + 1)
+                {
+                    pages_ -= unshared (ticks_.back (), &ticks_[ticks_.size () - 2]);
+                    ticks_.pop_back ();
+                }
+
+                return written;
+            }
+
+        private:
+            struct frame
+            {
+                uint64_t                    tick;
+                uint64_t                    generation;
+                size_t                      size;
+                std::vector <std::shared_ptr <page>> pages;
+            };
+
+            // index of the tick's frame, or size () when it wasn't captured
+            size_t find (uint64_t tick) const
+            {
+                auto frame = std::lower_bound (ticks_.begin (), ticks_.end (), tick,
+                        [] (struct frame const &f, uint64_t t) { return f.tick < t; });
+
+                return frame != ticks_.end () && frame->tick == tick?
+                    size_t (frame - ticks_.begin ()) : size ();
+            }
+
+            // pages of a frame its neighbour doesn't share, freed with it
+            static size_t unshared (frame const &dropped, frame const *neighbour)
+            {
+                size_t count = 0;
+
+                for (size_t p = 0; p < dropped.pages.size (); ++p)
+                    count += p >= neighbour->pages.size () || dropped.pages[p] != neighbour->pages[p];
+
+                return count;
+            }
+
+        private:
+            size_t                          depth_;
+            std::deque <frame>              ticks_;
+            size_t                          pages_ = 0;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _ENTITY_PAGE_HPP_
+#define _ENTITY_PAGE_HPP_
+
+namespace ceres { namespace entity {
+
+    //=========================================================================
+    // Copy of 64 dense slots of a column, one per dirty word. Copies of a
+    // column taken at different times are tables of pages, and share those
+    // whose slots did not change between them.
+
+    template <typename Component>
+    struct page
+    {
+        constexpr static size_t size = dirty_bits::word_bits;
+
+        size_t                      count;
+        id                          entities [size];
+        Component                   items [size];
+    };
+
+    //-------------------------------------------------------------------------
+    // Fills next with a table of the column's pages: those with dirty
+    // components, or whose entities moved (when moved, as components were
+    // added or removed), are new copies from make (), which returns a
+    // Pointer to an empty page; the rest are taken from previous. Returns
+    // the pages copied; pages of previous missing from next were replaced.
+
+    template <typename Component, typename Pointer, typename Make>
+    size_t copy_pages (column <Component> const &components, bool moved,
+            std::vector <Pointer> const &previous, std::vector <Pointer> &next, Make &&make)
+    {
+        constexpr size_t page_size = page <Component>::size;
+
+        size_t used = (components.size () + page_size - 1) / page_size;
+        size_t copied = 0;
+
+        auto entities = components.entities ();
+        auto values = components.components ();
+
+        next.resize (used);
+
+        for (size_t p = 0; p < used; ++p)
+        {
+            size_t first = p * page_size;
+            size_t count = std::min (page_size, components.size () - first);
+
+            Pointer old = p < previous.size ()? previous[p] : nullptr;
+            bool changed = !old || components.dirty ().word (p) != 0;
+
+            if (!changed && moved)
+                changed = old->count != count ||
+                    !std::equal (entities.items + first, entities.items + first + count, old->entities);
+
+            if (!changed)
+            {
+                next[p] = old;
+                continue;
+            }
+
+            Pointer copy = make ();
+            copy->count = count;
+            std::copy (entities.items + first, entities.items + first + count, copy->entities);
+            std::copy (values.items + first, values.items + first + count, copy->items);
+
+            next[p] = std::move (copy);
+            ++copied;
+        }
+
+        return copied;
+    }
+
+} }
+
+#endif
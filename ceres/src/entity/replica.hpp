@@ -0,0 +1,209 @@
+#ifndef _ENTITY_REPLICA_HPP_
+#define _ENTITY_REPLICA_HPP_
+
+namespace ceres { namespace entity {
+
+    //=========================================================================
+    // Non-owner's copy of a column under owner-authoritative replication.
+    // Requests to change what the owner holds are applied at once rather
+    // than a round trip later, and logged with the tick they were applied
+    // in; the owner answers each in order. Acceptance only settles the log.
+    // Rejection rolls back: the history is restored to the tick before the
+    // earliest rejected request and the rest of the log replayed up to the
+    // present, capturing each replayed tick again. The proxy takes the
+    // column's dirty flags for its history, clearing them every tick.
+    //
+    // Apply is bool (column <Component> &, Request const &), false when the
+    // request can't take effect, and must then change nothing; the owner
+    // applies the same, so once every request is answered the copies agree.
+
+    template <typename Component, typename Request, typename Apply>
+    class proxy
+    {
+        public:
+            typedef uint32_t sequence;
+
+        public:
+            proxy (column <Component> &components, size_t depth, Apply apply = Apply ()) :
+                components_ (components), history_ {depth}, apply_ (std::move (apply))
+            {
+                history_.capture (tick_++, components_);
+                components_.dirty ().clear ();
+            }
+
+            proxy (proxy const &) = delete;
+            proxy &operator= (proxy const &) = delete;
+
+        public:
+            // the tick requests now apply in
+            uint64_t tick () const { return tick_; }
+
+            // requests without an answer
+            size_t pending () const { return pending_; }
+
+            history <Component> const &past () const { return history_; }
+
+            size_t rollbacks () const { return rollbacks_; }
+            size_t replayed () const { return replayed_; }
+            size_t restored () const { return restored_; }
+
+        public:
+            // applies locally; the owner's answer names the sequence
+            sequence request (Request const &req)
+            {
+                log_.push_back ({next_, tick_, req, status::pending});
+                apply_ (components_, req);
+                ++pending_;
+
+                return next_++;
+            }
+
+            // ends the tick, rolling back first if anything was rejected
+            void advance ()
+            {
+                reconcile ();
+
+                history_.capture (tick_++, components_);
+                components_.dirty ().clear ();
+
+                // settled requests the history no longer reaches before
+                while (!log_.empty () && log_.front ().state != status::pending &&
+                        log_.front ().tick <= history_.oldest ())
+                    log_.pop_front ();
+            }
+
+            void accept (sequence seq)
+            {
+                log_[find (seq)].state = status::accepted;
+                --pending_;
+            }
+
+            // the rollback waits for reconcile, so that rejections arriving
+            // together cost one; false when the request is older than the
+            // history, and the column must be sent whole by the owner instead
+            bool reject (sequence seq)
+            {
+                size_t i = find (seq);
+
+                log_[i].state = status::rejected;
+                --pending_;
+
+                if (!history_.contains (log_[i].tick - 1))
+                    return false;
+
+                rewind_ = std::min (rewind_, log_[i].tick);
+                return true;
+            }
+
+            // restores the tick before the earliest rejected request and
+            // replays the log since, less the rejected, up to the present
+            void reconcile ()
+            {
+                if (rewind_ == never)
+                    return;
+
+                uint64_t tick = rewind_;
+                rewind_ = never;
+
+                restored_ += history_.restore (tick - 1, components_);
+                ++rollbacks_;
+
+                size_t i = 0;
+                while (i < log_.size () && log_[i].tick < tick)
+                    ++i;
+
+                for (;; ++tick)
+                {
+                    for (; i < log_.size () && log_[i].tick == tick; ++i)
+                        if (log_[i].state != status::rejected)
+                        {
+                            apply_ (components_, log_[i].req);
+                            ++replayed_;
+                        }
+
+                    if (tick == tick_)
+                        break;
+
+                    history_.capture (tick, components_);
+                    components_.dirty ().clear ();
+                }
+            }
+
+        private:
+            enum class status : uint8_t { pending, accepted, rejected };
+
+            struct entry
+            {
+                sequence                    seq;
+                uint64_t                    tick;
+                Request                     req;
+                status                      state;
+            };
+
+            // index in the log, which holds consecutive sequences
+            size_t find (sequence seq) const
+            {
+                size_t index = sequence (seq - (log_.empty ()? seq : log_.front ().seq));
+
+                ASSERTF (index < log_.size (), "unknown request");
+                ASSERTF (log_[index].state == status::pending, "request already answered");
+
+                return index;
+            }
+
+        private:
+            column <Component>             &components_;
+            history <Component>             history_;
+            Apply                           apply_;
+
+            std::deque <entry>              log_;
+            uint64_t                        tick_ = 0;
+            sequence                        next_ = 0;
+            size_t                          pending_ = 0;
+
+            constexpr static uint64_t never = ~uint64_t (0);
+            uint64_t                        rewind_ = never;
+
+            size_t                          rollbacks_ = 0;
+            size_t                          replayed_ = 0;
+            size_t                          restored_ = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    // Owner's side: requests are applied, in the order sent, only when
+    // Validate, bool (column <Component> const &, Request const &), passes;
+    // the result is the answer to send back.
+
+    template <typename Component, typename Request, typename Apply, typename Validate>
+    class authority
+    {
+        public:
+            authority (column <Component> &components, Apply apply = Apply (), Validate validate = Validate ()) :
+                components_ (components), apply_ (std::move (apply)), validate_ (std::move (validate)) {}
+
+        public:
+            size_t accepted () const { return accepted_; }
+            size_t rejected () const { return rejected_; }
+
+            bool receive (Request const &req)
+            {
+                bool accept = validate_ (components_, req) &&
+                    apply_ (components_, req);
+
+                ++(accept? accepted_ : rejected_);
+
+                return accept;
+            }
+
+        private:
+            column <Component>             &components_;
+            Apply                           apply_;
+            Validate                        validate_;
+
+            size_t                          accepted_ = 0;
+            size_t                          rejected_ = 0;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _ENTITY_SNAPSHOT_HPP_
+#define _ENTITY_SNAPSHOT_HPP_
+
+namespace ceres { namespace entity {
+
+    //=========================================================================
+    // Read-copy-update copy of a column for readers on other threads, such
+    // as replication while the simulation runs on. The copy is kept in blocks
+    // of 64 dense slots, one per dirty word, under a version table of block
+    // pointers. Capturing copies only the blocks with dirty components (or
+    // whose entities moved, when components were added or removed) into new
+    // blocks, and publishes a new table sharing the others; the replaced
+    // table and blocks are retired to the epoch domain. A reader takes the
+    // table once inside a read section and sees one capture throughout.
+
+    template <typename Component>
+    class snapshot
+    {
+        public:
+            typedef entity::page <Component> block;
+
+            constexpr static size_t block_size = block::size;
+
+            struct version
+            {
+                uint64_t                    number;
+                size_t                      size;
+                std::vector <block *>       blocks;
+
+                // calls visitor (entity, component) for each component
+                template <typename Visitor>
+                void each (Visitor &&visitor) const
+                {
+                    for (auto b : blocks)
+                        for (size_t i = 0; i < b->count; ++i)
+                            visitor (b->entities[i], b->items[i]);
+                }
+            };
+
+        public:
+            explicit snapshot (memory::epoch_domain &domain) :
+                domain_ (domain), current_ {new version {0, 0, {}}} {}
+
+            // no reader may be left in a section
+            ~snapshot ()
+            {
+                version *last = current_.load (std::memory_order_relaxed);
+
+                for (auto b : last->blocks)
+                    delete b;
+
+                delete last;
+            }
+
+            snapshot (snapshot const &) = delete;
+            snapshot &operator= (snapshot const &) = delete;
+
+        public:
+            // readers, inside a read section of the domain
+            version const &read () const { return *current_.load (std::memory_order_acquire); }
+
+            // one writer at a time, ordered after the column's writers;
+            // returns the blocks copied. Dirty flags are left to the caller.
+            size_t capture (column <Component> const &components)
+            {
+                version const &previous = *current_.load (std::memory_order_relaxed);
+                std::unique_ptr <version> next {new version {previous.number + 1, components.size (), {}}};
+
+                bool moved = components.generation () != generation_;
+                size_t copied = copy_pages (components, moved, previous.blocks, next->blocks,
+                        [] { return new block; });
+
+                // copied over, or past the end when the column shrank
+                replaced_.clear ();
+
+                for (size_t b = 0; b < previous.blocks.size (); ++b)
+                    if (b >= next->blocks.size () || next->blocks[b] != previous.blocks[b])
+                        replaced_.push_back (previous.blocks[b]);
+
+                version *retired = current_.exchange (next.release (), std::memory_order_seq_cst);
+                generation_ = components.generation ();
+
+                for (auto b : replaced_)
+                    domain_.retire (b);
+
+                domain_.retire (retired);
+                domain_.collect ();
+
+                return copied;
+            }
+
+        private:
+            memory::epoch_domain           &domain_;
+            std::atomic <version *>         current_;
+            uint64_t                        generation_ = ~uint64_t (0);
+
+            // scratch reused across captures
+            std::vector <block *>           replaced_;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,418 @@
+#ifndef _ENTITY_STORE_HPP_
+#define _ENTITY_STORE_HPP_
+
+namespace ceres { namespace entity {
+
+    typedef uint32_t id;
+
+    constexpr id none = ~id (0);
+
+    //=========================================================================
+    // Fixed set of flags, one per dense slot, that any thread may raise.
+    // Readers scan a word of 64 at a time and skip clear words outright.
+    // Resizing is not thread safe and belongs between parallel phases.
+
+    class dirty_bits
+    {
+        public:
+            constexpr static size_t word_bits = 64;
+
+        public:
+            dirty_bits () = default;
+            dirty_bits (dirty_bits const &) = delete;
+            dirty_bits &operator= (dirty_bits const &) = delete;
+
+        public:
+            size_t size () const { return size_; }
+            size_t words () const { return (size_ + word_bits - 1) / word_bits; }
+
+            // keeps the flags below the new size; new ones are clear
+            void resize (size_t count)
+            {
+                size_t needed = (count + word_bits - 1) / word_bits;
+
+                if (needed > capacity_)
+                {
+                    size_t capacity = std::max (needed, capacity_ * 2);
+                    std::unique_ptr <std::atomic <uint64_t> []> words {new std::atomic <uint64_t> [capacity]};
+
+                    for (size_t w = 0; w < capacity; ++w)
+                        words[w].store (w < capacity_? word (w) : 0, std::memory_order_relaxed);
+
+                    words_ = std::move (words);
+                    capacity_ = capacity;
+                }
+
+                // clear what lies past the end so growing again starts clear
+                if (count < size_ && count % word_bits)
+                    words_[count / word_bits].fetch_and (mask (count) - 1, std::memory_order_relaxed);
+
+                for (size_t w = needed; w < words (); ++w)
+                    words_[w].store (0, std::memory_order_relaxed);
+
+                size_ = count;
+            }
+
+            void set (size_t index)
+            {
+                ASSERTF (index < size_, "index out of range");
+                words_[index / word_bits].fetch_or (mask (index), std::memory_order_relaxed);
+            }
+
+            void reset (size_t index)
+            {
+                ASSERTF (index < size_, "index out of range");
+                words_[index / word_bits].fetch_and (~mask (index), std::memory_order_relaxed);
+            }
+
+            bool test (size_t index) const
+            {
+                ASSERTF (index < size_, "index out of range");
+                return word (index / word_bits) & mask (index);
+            }
+
+            // copies a flag over another and clears the source (swap removal)
+            void move (size_t from, size_t to)
+            {
+                if (test (from))
+                    set (to);
+                else
+                    reset (to);
+
+                reset (from);
+            }
+
+            void clear ()
+            {
+                for (size_t w = 0; w < words (); ++w)
+                    words_[w].store (0, std::memory_order_relaxed);
+            }
+
+            size_t count () const
+            {
+                size_t total = 0;
+
+                for (size_t w = 0; w < words (); ++w)
+                    total += core::bit::count (word (w));
+
+                return total;
+            }
+
+            uint64_t word (size_t w) const
+            {
+                return words_[w].load (std::memory_order_acquire);
+            }
+
+        public:
+            // calls consumer (index) for each raised flag in words [first, last)
+            template <typename Consumer>
+            void each (Consumer &&consumer, size_t first = 0, size_t last = ~size_t (0)) const
+            {
+                last = std::min (last, words ());
+
+                for (size_t w = first; w < last; ++w)
+                    visit (w, word (w), consumer);
+            }
+
+            // as each, clearing the words as they are read; flags raised
+            // meanwhile are either seen now or kept for the next drain
+            template <typename Consumer>
+            void drain (Consumer &&consumer, size_t first = 0, size_t last = ~size_t (0))
+            {
+                last = std::min (last, words ());
+
+                for (size_t w = first; w < last; ++w)
+                    if (words_[w].load (std::memory_order_relaxed))
+                        visit (w, words_[w].exchange (0, std::memory_order_acq_rel), consumer);
+            }
+
+        private:
+            static uint64_t mask (size_t index) { return uint64_t (1) << (index % word_bits); }
+
+            template <typename Consumer>
+            static void visit (size_t w, uint64_t bits, Consumer &consumer)
+            {
+                while (bits)
+                {
+                    consumer (w * word_bits + core::bit::trailing_zeros (bits));
+                    bits &= bits - 1;
+                }
+            }
+
+        private:
+            std::unique_ptr <std::atomic <uint64_t> []>     words_;
+            size_t                                          capacity_ = 0;
+            size_t                                          size_ = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    // Entity to dense index map: a sparse array indexed by entity holds the
+    // dense index, and the dense array holds the entity back. Removal swaps
+    // the last entity into the hole, so the dense array stays packed.
+
+    class sparse_set
+    {
+        public:
+            size_t size () const { return dense_.size (); }
+            bool empty () const { return dense_.empty (); }
+
+            bool contains (id entity) const
+            {
+                return entity < sparse_.size () && sparse_[entity] != none;
+            }
+
+            // none when absent
+            id index (id entity) const
+            {
+                return entity < sparse_.size ()? sparse_[entity] : none;
+            }
+
+            id entity (size_t index) const { return dense_[index]; }
+
+            memory::buffer <id const> entities () const { return {dense_.data (), dense_.size ()}; }
+
+        public:
+            // returns the new dense index, at the end
+            id insert (id entity)
+            {
+                ASSERTF (entity != none, "invalid entity");
+                ASSERTF (!contains (entity), "entity already present");
+
+                if (entity >= sparse_.size ())
+                    sparse_.resize (std::max <size_t> (entity + 1, sparse_.size () * 2), none);
+
+                sparse_[entity] = dense_.size ();
+                dense_.push_back (entity);
+
+                return sparse_[entity];
+            }
+
+            // returns the dense index the last entity moved into
+            id erase (id entity)
+            {
+                ASSERTF (contains (entity), "entity not present");
+
+                id hole = sparse_[entity];
+                id moved = dense_.back ();
+
+                dense_[hole] = moved;
+                sparse_[moved] = hole;
+                sparse_[entity] = none;
+                dense_.pop_back ();
+
+                return hole;
+            }
+
+            void clear ()
+            {
+                for (auto entity : dense_)
+                    sparse_[entity] = none;
+
+                dense_.clear ();
+            }
+
+        private:
+            std::vector <id>                sparse_;
+            std::vector <id>                dense_;
+    };
+
+    //=========================================================================
+    // Packed array of one component type with its entity map and dirty
+    // flags, all indexed alike. Writers mark what they change and may do so
+    // from any thread, each on its own entities; adding and removing entities
+    // is single threaded.
+
+    template <typename Component>
+    class column
+    {
+        public:
+            typedef Component value_type;
+
+        public:
+            column () = default;
+            column (column const &) = delete;
+            column &operator= (column const &) = delete;
+
+        public:
+            size_t size () const { return index_.size (); }
+            bool contains (id entity) const { return index_.contains (entity); }
+            id index (id entity) const { return index_.index (entity); }
+
+            memory::buffer <id const> entities () const { return index_.entities (); }
+            memory::buffer <Component> components () { return {values_.data (), values_.size ()}; }
+            memory::buffer <Component const> components () const { return {values_.data (), values_.size ()}; }
+
+            dirty_bits &dirty () { return dirty_; }
+            dirty_bits const &dirty () const { return dirty_; }
+
+            // changes whenever components are added or removed
+            uint64_t generation () const { return generation_; }
+
+        public:
+            // added components start dirty so their first state is sent
+            template <typename ...Args>
+            Component &emplace (id entity, Args &&...args)
+            {
+                id at = index_.insert (entity);
+                values_.emplace_back (std::forward <Args> (args)...);
+
+                dirty_.resize (size ());
+                dirty_.set (at);
+                ++generation_;
+
+                return values_[at];
+            }
+
+            void erase (id entity)
+            {
+                id hole = index_.erase (entity);
+                id last = values_.size () - 1;
+
+                if (hole != last)
+                {
+                    values_[hole] = std::move (values_[last]);
+                    dirty_.move (last, hole);
+                }
+
+                values_.pop_back ();
+                dirty_.resize (size ());
+                ++generation_;
+            }
+
+            void clear ()
+            {
+                index_.clear ();
+                values_.clear ();
+                dirty_.resize (0);
+                ++generation_;
+            }
+
+            Component const &get (id entity) const
+            {
+                ASSERTF (contains (entity), "entity has no such component");
+                return values_[index_.index (entity)];
+            }
+
+            // for writing; marks the component dirty
+            Component &modify (id entity)
+            {
+                ASSERTF (contains (entity), "entity has no such component");
+
+                id at = index_.index (entity);
+                dirty_.set (at);
+
+                return values_[at];
+            }
+
+            void mark (id entity)
+            {
+                ASSERTF (contains (entity), "entity has no such component");
+                dirty_.set (index_.index (entity));
+            }
+
+        public:
+            // calls visitor (entity, component) for each dirty component
+            template <typename Visitor>
+            void each_dirty (Visitor &&visitor)
+            {
+                auto &values = values_;
+                auto &index = index_;
+
+                dirty_.each ([&] (size_t at) { visitor (index.entity (at), values[at]); });
+            }
+
+            // as each_dirty, clearing the flags as they are read
+            template <typename Visitor>
+            void drain_dirty (Visitor &&visitor)
+            {
+                auto &values = values_;
+                auto &index = index_;
+
+                dirty_.drain ([&] (size_t at) { visitor (index.entity (at), values[at]); });
+            }
+
+        private:
+            sparse_set                      index_;
+            std::vector <Component>         values_;
+            dirty_bits                      dirty_;
+            uint64_t                        generation_ = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    // Entities composed of components: one column per component type, so
+    // each type is stored structure of arrays and systems walk only the
+    // columns they need. Entity IDs are handed out by the caller.
+
+    template <typename ...Components>
+    class store
+    {
+        public:
+            constexpr static size_t ncomponents = sizeof...(Components);
+
+            template <typename Component>
+            using index_of = state::state_index <Component, Components...>;
+
+        public:
+            store () = default;
+            store (store const &) = delete;
+            store &operator= (store const &) = delete;
+
+        public:
+            template <typename Component>
+            column <Component> &get_column ()
+            {
+                return std::get <index_of <Component>::value> (columns_);
+            }
+
+            template <typename Component>
+            column <Component> const &get_column () const
+            {
+                return std::get <index_of <Component>::value> (columns_);
+            }
+
+            template <typename Component>
+            bool has (id entity) const { return get_column <Component> ().contains (entity); }
+
+            template <typename Component, typename ...Args>
+            Component &emplace (id entity, Args &&...args)
+            {
+                return get_column <Component> ().emplace (entity, std::forward <Args> (args)...);
+            }
+
+            template <typename Component>
+            void erase (id entity) { get_column <Component> ().erase (entity); }
+
+            template <typename Component>
+            Component const &get (id entity) const { return get_column <Component> ().get (entity); }
+
+            template <typename Component>
+            Component &modify (id entity) { return get_column <Component> ().modify (entity); }
+
+            // removes whatever components the entity has
+            void destroy (id entity)
+            {
+                auto swallow = { (erase_if_present (get_column <Components> (), entity), 0)... };
+                (void) swallow;
+            }
+
+            void clear_dirty ()
+            {
+                auto swallow = { (get_column <Components> ().dirty ().clear (), 0)... };
+                (void) swallow;
+            }
+
+        private:
+            template <typename Component>
+            static void erase_if_present (column <Component> &components, id entity)
+            {
+                if (components.contains (entity))
+                    components.erase (entity);
+            }
+
+        private:
+            std::tuple <column <Components>...>     columns_;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,378 @@
+#ifndef _ENTITY_TRANSACTION_HPP_
+#define _ENTITY_TRANSACTION_HPP_
+
+namespace ceres { namespace entity {
+
+    //=========================================================================
+    // Software transactional memory over component fields, after TL2 (Dice,
+    // Shalev and Shavit, "Transactional Locking II"). Field addresses hash
+    // to stripes of versioned locks, and a global clock versions commits.
+    // A transaction reads the clock when it starts, and each read checks the
+    // field's stripe is unlocked and no newer than that, so every read is
+    // consistent with the start. Writes are buffered; commit locks the
+    // written stripes, takes a new version from the clock, checks the read
+    // stripes are still no newer than the start, writes back and releases
+    // the stripes at the new version. Readers and writers never block: a
+    // conflict aborts the transaction, which retries.
+    //
+    // Fields must be trivially copyable and of 1, 2, 4 or 8 bytes, so they
+    // are read and written as single atomic words. Adding and removing
+    // components must not overlap transactions on the same columns.
+
+    class lock_table
+    {
+        public:
+            explicit lock_table (size_t stripes = 1 << 16) :
+                locks_ {new std::atomic <uint64_t> [size_t (1) << core::bit::log2_ceil (stripes)]},
+                mask_ {(size_t (1) << core::bit::log2_ceil (stripes)) - 1}
+            {
+                for (size_t s = 0; s <= mask_; ++s)
+                    locks_[s].store (0, std::memory_order_relaxed);
+            }
+
+            lock_table (lock_table const &) = delete;
+            lock_table &operator= (lock_table const &) = delete;
+
+        public:
+            // lock words hold the version shifted up, with the low bit set while locked
+            std::atomic <uint64_t> &lock (size_t stripe) { return locks_[stripe]; }
+
+            size_t stripe (void const *address) const
+            {
+                auto word = reinterpret_cast <size_t> (address) >> 3;
+                return (word ^ (word >> 17)) & mask_;
+            }
+
+            std::atomic <uint64_t> &clock () { return clock_; }
+
+        private:
+            std::unique_ptr <std::atomic <uint64_t> []>     locks_;
+            size_t                                          mask_;
+
+            alignas (64) std::atomic <uint64_t>             clock_ {0};
+    };
+
+    //-------------------------------------------------------------------------
+    // One thread's transaction, reused from one to the next so its read and
+    // write sets keep their capacity
+
+    class transaction
+    {
+        public:
+            explicit transaction (entity::lock_table &shared) :
+                shared_ (shared) {}
+
+            transaction (transaction const &) = delete;
+            transaction &operator= (transaction const &) = delete;
+
+        public:
+            // runs body (transaction &) until it commits; returns the retries
+            template <typename Body>
+            size_t atomically (Body &&body)
+            {
+                for (size_t attempt = 0; ; ++attempt)
+                {
+                    begin ();
+
+                    try
+                    {
+                        body (*this);
+
+                        if (commit ())
+                        {
+                            ++commits_;
+                            return attempt;
+                        }
+                    }
+                    catch (conflict const &) {}
+
+                    ++aborts_;
+                    backoff (attempt);
+                }
+            }
+
+        public:
+            template <typename Field>
+            Field read (Field const &field)
+            {
+                check <Field> ();
+
+                // read your own writes
+                if (filter_ & bloom (&field))
+                    for (auto entry = writes_.rbegin (); entry != writes_.rend (); ++entry)
+                        if (entry->address == &field)
+                            return decode <Field> (entry->bits);
+
+                size_t stripe = shared_.stripe (&field);
+                auto &lock = shared_.lock (stripe);
+
+                uint64_t before = lock.load (std::memory_order_acquire);
+                uint64_t bits = load (&field, sizeof (Field));
+                std::atomic_thread_fence (std::memory_order_acquire);
+                uint64_t after = lock.load (std::memory_order_relaxed);
+
+                if ((before & 1) || before != after || (before >> 1) > start_)
+                    throw conflict {};
+
+                reads_.push_back (stripe);
+                return decode <Field> (bits);
+            }
+
+            template <typename Field>
+            void write (Field &field, Field const &value)
+            {
+                write (field, value, nullptr, 0);
+            }
+
+            // a field of an entity's component
+            template <typename Component, typename Field>
+            Field read (column <Component> const &components, id entity, Field Component::*field)
+            {
+                return read (components.get (entity).*field);
+            }
+
+            // as write, marking the component dirty once committed
+            template <typename Component, typename Field>
+            void write (column <Component> &components, id entity, Field Component::*field, Field const &value)
+            {
+                ASSERTF (components.contains (entity), "entity has no such component");
+
+                auto &component = components.components ().items[components.index (entity)];
+                write (component.*field, value, &components.dirty (), components.index (entity));
+            }
+
+        public:
+            size_t commits () const { return commits_; }
+            size_t aborts () const { return aborts_; }
+
+        private:
+            struct conflict {};
+
+            struct write_entry
+            {
+                void                       *address;
+                uint64_t                    bits;
+                uint32_t                    size;
+                uint32_t                    stripe;
+                dirty_bits                 *dirty;
+                size_t                      index;
+            };
+
+            struct held_lock
+            {
+                uint32_t                    stripe;
+                uint64_t                    previous;
+            };
+
+        private:
+            void begin ()
+            {
+                reads_.clear ();
+                writes_.clear ();
+                filter_ = 0;
+                start_ = shared_.clock ().load (std::memory_order_acquire);
+            }
+
+            bool commit ()
+            {
+                // read only: every read was consistent with the start
+                if (writes_.empty ())
+                    return true;
+
+                if (!acquire ())
+                    return false;
+
+                uint64_t version = shared_.clock ().fetch_add (1, std::memory_order_acq_rel) + 1;
+
+                // unless nothing else committed since the start, the reads
+                // must still be current
+                if (version != start_ + 1 && !validate ())
+                {
+                    release (false, 0);
+                    return false;
+                }
+
+                for (auto &entry : writes_)
+                {
+                    store (entry.address, entry.bits, entry.size);
+
+                    if (entry.dirty)
+                        entry.dirty->set (entry.index);
+                }
+
+                release (true, version);
+                return true;
+            }
+
+            // try-locks each written stripe once; never waits on another
+            bool acquire ()
+            {
+                held_.clear ();
+
+                for (auto &entry : writes_)
+                {
+                    if (holds (entry.stripe))
+                        continue;
+
+                    auto &lock = shared_.lock (entry.stripe);
+                    uint64_t previous = lock.load (std::memory_order_relaxed);
+
+                    if ((previous & 1) ||
+                            !lock.compare_exchange_strong (previous, previous | 1, std::memory_order_acquire))
+                    {
+                        release (false, 0);
+                        return false;
+                    }
+
+                    held_.push_back ({entry.stripe, previous});
+                }
+
+                // orders the stores after the locks for readers' validation
+                std::atomic_thread_fence (std::memory_order_release);
+                return true;
+            }
+
+            bool validate () const
+            {
+                for (auto stripe : reads_)
+                {
+                    uint64_t word = shared_.lock (stripe).load (std::memory_order_acquire);
+
+                    if (word & 1)
+                    {
+                        if (!holds (stripe))
+                            return false;
+
+                        word = previous (stripe);
+                    }
+
+                    if ((word >> 1) > start_)
+                        return false;
+                }
+
+                return true;
+            }
+
+            void release (bool committed, uint64_t version)
+            {
+                for (auto &held : held_)
+                    shared_.lock (held.stripe).store (committed? version << 1 : held.previous,
+                            std::memory_order_release);
+
+                held_.clear ();
+            }
+
+            bool holds (uint32_t stripe) const
+            {
+                for (auto &held : held_)
+                    if (held.stripe == stripe)
+                        return true;
+
+                return false;
+            }
+
+            uint64_t previous (uint32_t stripe) const
+            {
+                for (auto &held : held_)
+                    if (held.stripe == stripe)
+                        return held.previous;
+
+                return 0;
+            }
+
+            template <typename Field>
+            void write (Field &field, Field const &value, dirty_bits *dirty, size_t index)
+            {
+                check <Field> ();
+
+                uint64_t bits = 0;
+                std::memcpy (&bits, &value, sizeof (Field));
+
+                if (filter_ & bloom (&field))
+                    for (auto &entry : writes_)
+                        if (entry.address == &field)
+                        {
+                            entry.bits = bits;
+                            return;
+                        }
+
+                filter_ |= bloom (&field);
+                writes_.push_back ({&field, bits, sizeof (Field), uint32_t (shared_.stripe (&field)), dirty, index});
+            }
+
+        private:
+            template <typename Field>
+            static void check ()
+            {
+                static_assert (std::is_trivially_copyable <Field>::value, "field is not trivially copyable");
+                static_assert (sizeof (Field) == 1 || sizeof (Field) == 2 ||
+                        sizeof (Field) == 4 || sizeof (Field) == 8, "field is not a single word");
+            }
+
+            template <typename Field>
+            static Field decode (uint64_t bits)
+            {
+                Field value;
+                std::memcpy (&value, &bits, sizeof (Field));
+                return value;
+            }
+
+            static uint64_t bloom (void const *address)
+            {
+                return uint64_t (1) << ((reinterpret_cast <size_t> (address) >> 2) & 63);
+            }
+
+            // fields race with committing writers by design, so both sides
+            // access them atomically
+            static uint64_t load (void const *address, size_t size)
+            {
+                switch (size)
+                {
+                    case 1: return __atomic_load_n (static_cast <uint8_t const *> (address), __ATOMIC_RELAXED);
+                    case 2: return __atomic_load_n (static_cast <uint16_t const *> (address), __ATOMIC_RELAXED);
+                    case 4: return __atomic_load_n (static_cast <uint32_t const *> (address), __ATOMIC_RELAXED);
+                    default: return __atomic_load_n (static_cast <uint64_t const *> (address), __ATOMIC_RELAXED);
+                }
+            }
+
+            static void store (void *address, uint64_t bits, size_t size)
+            {
+                switch (size)
+                {
+                    case 1: __atomic_store_n (static_cast <uint8_t *> (address), uint8_t (bits), __ATOMIC_RELAXED); break;
+                    case 2: __atomic_store_n (static_cast <uint16_t *> (address), uint16_t (bits), __ATOMIC_RELAXED); break;
+                    case 4: __atomic_store_n (static_cast <uint32_t *> (address), uint32_t (bits), __ATOMIC_RELAXED); break;
+                    default: __atomic_store_n (static_cast <uint64_t *> (address), bits, __ATOMIC_RELAXED); break;
+                }
+            }
+
+            // randomised exponential backoff, so conflicting retries spread out
+            void backoff (size_t attempt)
+            {
+                seed_ = seed_ * 6364136223846793005ull + 1442695040888963407ull;
+                size_t spins = (seed_ >> 33) % (size_t (16) << std::min <size_t> (attempt, 10));
+
+                for (size_t s = 0; s < spins; ++s)
+                    std::atomic_signal_fence (std::memory_order_seq_cst);
+
+                if (attempt > 16)
+                    std::this_thread::yield ();
+            }
+
+        private:
+            entity::lock_table                 &shared_;
+            uint64_t                        start_ = 0;
+            uint64_t                        filter_ = 0;
+
+            std::vector <uint32_t>          reads_;
+            std::vector <write_entry>       writes_;
+            std::vector <held_lock>         held_;
+
+            size_t                          commits_ = 0;
+            size_t                          aborts_ = 0;
+            uint64_t                        seed_ = reinterpret_cast <uint64_t> (this);
+    };
+
+} }
+
+#endif
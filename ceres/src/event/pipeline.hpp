@@ -0,0 +1,195 @@
+#ifndef _EVENT_PIPELINE_HPP_
+#define _EVENT_PIPELINE_HPP_
+
+namespace ceres { namespace event {
+
+    //=========================================================================
+    // Event map/reduce over a frame's streams. Map stages (filter, transform,
+    // or a general map emitting any number of events) fan source streams out
+    // into ever more specialised streams, each stage processing its input's
+    // batches in parallel on the pool. Reduce stages consume a stream whole
+    // on one thread; reductions of different streams run in parallel. Every
+    // stage is a node of a task graph following its input's producer, built
+    // once and run each frame, after which reset drops every event.
+
+    class pipeline
+    {
+        public:
+            explicit pipeline (task::pool &workers, size_t block_size = 64 * 1024) :
+                workers_ (workers), frame_ {workers, block_size} {}
+
+            pipeline (pipeline const &) = delete;
+            pipeline &operator= (pipeline const &) = delete;
+
+        public:
+            // filled by the caller before run
+            template <typename Event>
+            stream <Event> &source ()
+            {
+                return make_stream <Event> ();
+            }
+
+            // mapping (event, output) pushes any number of events to output,
+            // a writer of the output stream
+            template <typename Out, typename In, typename Mapping>
+            stream <Out> &map (stream <In> &input, Mapping mapping)
+            {
+                auto &output = make_stream <Out> ();
+                auto stage = new map_stage <In, Out, Mapping> {workers_, input, output, std::move (mapping)};
+
+                stages_.emplace_back (stage);
+                output.producer = add_node (input, [stage] { stage->run (); });
+
+                return output;
+            }
+
+            // events for which predicate (event) holds
+            template <typename Event, typename Predicate>
+            stream <Event> &filter (stream <Event> &input, Predicate predicate)
+            {
+                return map <Event> (input, [predicate] (Event const &item, typename stream <Event>::writer &output)
+                {
+                    if (predicate (item))
+                        output.push (item);
+                });
+            }
+
+            // the result of transform (event) for each event
+            template <typename In, typename Transform,
+                     typename Out = typename std::decay <typename std::result_of <Transform (In const &)>::type>::type>
+            stream <Out> &transform (stream <In> &input, Transform transform)
+            {
+                return map <Out> (input, [transform] (In const &item, typename stream <Out>::writer &output)
+                {
+                    output.push (transform (item));
+                });
+            }
+
+            // calls reduction (event) for every event, on one thread; the node
+            // returned may be ordered against others with graph ().precede
+            template <typename Event, typename Reduction>
+            task::graph::node_id reduce (stream <Event> &input, Reduction reduction)
+            {
+                stream <Event> *source = &input;
+
+                return add_node (input, [source, reduction] () mutable
+                {
+                    source->each (reduction);
+                });
+            }
+
+        public:
+            void run () { graph_.run (workers_); }
+
+            // drops every event of the frame; only between runs
+            void reset () { frame_.reset (); }
+
+            task::graph &graph () { return graph_; }
+            event::frame &frame () { return frame_; }
+
+        private:
+            struct stage
+            {
+                virtual ~stage () {}
+            };
+
+            // one job per input batch, queued by the stage's node, which
+            // helps with them until all are done
+            template <typename In, typename Out, typename Mapping>
+            struct map_stage : stage
+            {
+                struct batch_job : task::job
+                {
+                    batch_job (map_stage *owner, In const *first, In const *last) :
+                        owner (owner), first (first), last (last) {}
+
+                    void run (task::pool &) override
+                    {
+                        owner->process (first, last);
+                        owner->remaining.fetch_sub (1, std::memory_order_acq_rel);
+                    }
+
+                    map_stage                  *owner;
+                    In const                   *first;
+                    In const                   *last;
+                };
+
+                map_stage (task::pool &workers, stream <In> &input, stream <Out> &output, Mapping &&mapping) :
+                    workers (workers), input (input), output (output), mapping (std::move (mapping)) {}
+
+                void run ()
+                {
+                    // built before any is queued; the vector keeps its
+                    // capacity from frame to frame
+                    jobs.clear ();
+                    input.each_batch ([this] (In const *first, In const *last)
+                    {
+                        jobs.emplace_back (this, first, last);
+                    });
+
+                    if (jobs.empty ())
+                        return;
+
+                    remaining.store (jobs.size () - 1, std::memory_order_relaxed);
+
+                    for (size_t index = 1; index < jobs.size (); ++index)
+                        workers.submit (&jobs[index]);
+
+                    process (jobs[0].first, jobs[0].last);
+
+                    workers.help_while ([this]
+                    {
+                        return remaining.load (std::memory_order_acquire) > 0;
+                    });
+                }
+
+                void process (In const *first, In const *last)
+                {
+                    typename stream <Out>::writer writer {output};
+
+                    for (auto item = first; item != last; ++item)
+                        mapping (*item, writer);
+                }
+
+                task::pool                 &workers;
+                stream <In>                &input;
+                stream <Out>               &output;
+                Mapping                     mapping;
+
+                std::vector <batch_job>     jobs;
+                std::atomic <size_t>        remaining {0};
+            };
+
+        private:
+            template <typename Event>
+            stream <Event> &make_stream ()
+            {
+                auto created = new stream <Event> {frame_};
+                streams_.emplace_back (created);
+
+                return *created;
+            }
+
+            template <typename Work>
+            task::graph::node_id add_node (stream_base const &input, Work &&work)
+            {
+                auto node = graph_.add (std::forward <Work> (work));
+
+                if (input.producer != stream_base::none)
+                    graph_.precede (input.producer, node);
+
+                return node;
+            }
+
+        private:
+            task::pool                                 &workers_;
+            event::frame                                frame_;
+            task::graph                                 graph_;
+
+            std::vector <std::unique_ptr <stream_base>> streams_;
+            std::vector <std::unique_ptr <stage>>       stages_;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef _EVENT_STREAM_HPP_
+#define _EVENT_STREAM_HPP_
+
+namespace ceres { namespace event {
+
+    //=========================================================================
+    // Transient storage of a frame's events: an arena per pool worker, and
+    // one for whichever single thread off the pool produces. Reset rewinds
+    // every arena and starts a new epoch, which empties every stream of the
+    // frame without touching it.
+
+    class frame
+    {
+        public:
+            explicit frame (task::pool &workers, size_t block_size = 64 * 1024) :
+                workers_ (workers)
+            {
+                for (size_t index = 0; index <= workers.size (); ++index)
+                    arenas_.emplace_back (new memory::arena {block_size});
+            }
+
+            frame (frame const &) = delete;
+            frame &operator= (frame const &) = delete;
+
+        public:
+            size_t partitions () const { return arenas_.size (); }
+
+            // the calling thread's partition; the last one off the pool
+            size_t partition () const { return workers_.current (); }
+
+            memory::arena &local () { return *arenas_[partition ()]; }
+
+            uint64_t epoch () const { return epoch_; }
+
+            // only between runs, when no thread is producing
+            void reset ()
+            {
+                ++epoch_;
+
+                for (auto &arena : arenas_)
+                    arena->reset ();
+            }
+
+            // bytes held by the arenas, used or not
+            size_t capacity () const
+            {
+                size_t total = 0;
+
+                for (auto &arena : arenas_)
+                    total += arena->capacity ();
+
+                return total;
+            }
+
+        private:
+            task::pool                                 &workers_;
+            std::vector <std::unique_ptr <memory::arena>> arenas_;
+            uint64_t                                    epoch_ = 1;
+    };
+
+    //-------------------------------------------------------------------------
+    // Queue of events partitioned by producing thread: each thread appends
+    // batches to its own partition from its own arena, so producers share
+    // nothing and take no locks. Readers see the partitions concatenated,
+    // and must be ordered after the producers (by the task graph). Events
+    // are dropped with the arena, so they must be trivially destructible.
+
+    class stream_base
+    {
+        public:
+            virtual ~stream_base () {}
+
+            // graph node filling the stream; none for sources
+            task::graph::node_id producer = none;
+
+            constexpr static task::graph::node_id none = ~task::graph::node_id (0);
+    };
+
+    template <typename Event>
+    class stream : public stream_base
+    {
+        static_assert (std::is_trivially_destructible <Event>::value, "events are not destroyed");
+
+        public:
+            typedef Event value_type;
+
+            constexpr static size_t batch_size = sizeof (Event) < 4096? 4096 / sizeof (Event) : 1;
+
+        public:
+            explicit stream (event::frame &frame) :
+                frame_ (frame), partitions_ (frame.partitions ()) {}
+
+            stream (stream const &) = delete;
+            stream &operator= (stream const &) = delete;
+
+        public:
+            class writer;
+
+            void push (Event const &item) { writer {*this}.push (item); }
+
+            template <typename ...Args>
+            void emplace (Args &&...args)
+            {
+                writer {*this}.emplace (std::forward <Args> (args)...);
+            }
+
+        public:
+            size_t size () const
+            {
+                size_t total = 0;
+
+                for (size_t p = 0; p < partitions_.size (); ++p)
+                    total += live (p)? partitions_[p].count : 0;
+
+                return total;
+            }
+
+            bool empty () const { return size () == 0; }
+
+            // calls consumer (first, last) for each batch, partition by partition
+            template <typename Consumer>
+            void each_batch (Consumer &&consumer) const
+            {
+                for (size_t p = 0; p < partitions_.size (); ++p)
+                    if (live (p))
+                        for (batch *b = partitions_[p].head; b; b = b->next)
+                            consumer (b->at (0), b->at (b->count));
+            }
+
+            template <typename Consumer>
+            void each (Consumer &&consumer) const
+            {
+                each_batch ([&consumer] (Event const *first, Event const *last)
+                {
+                    for (auto item = first; item != last; ++item)
+                        consumer (*item);
+                });
+            }
+
+            event::frame &frame () const { return frame_; }
+
+        private:
+            struct batch
+            {
+                batch                      *next;
+                size_t                      count;
+
+                typename std::aligned_storage <sizeof (Event), alignof (Event)>::type items [batch_size];
+
+                Event *at (size_t index) { return reinterpret_cast <Event *> (items + index); }
+            };
+
+            // padded so producers don't share a line
+            struct partition
+            {
+                batch                      *head;
+                batch                      *tail;
+                size_t                      count;
+                uint64_t                    epoch;
+                char                        padding [memory::cache_line_size - 4 * sizeof (size_t)];
+            };
+
+            bool live (size_t p) const { return partitions_[p].epoch == frame_.epoch (); }
+
+            void grow (partition &part)
+            {
+                auto next = frame_.local ().allocate_array <batch> (1);
+                ASSERTF (next, "out of memory for events");
+
+                next->next = nullptr;
+                next->count = 0;
+
+                (part.tail? part.tail->next : part.head) = next;
+                part.tail = next;
+            }
+
+            // a partition of an earlier frame is emptied on first use
+            partition &current (size_t p)
+            {
+                partition &part = partitions_[p];
+
+                if (part.epoch != frame_.epoch ())
+                {
+                    part.head = part.tail = nullptr;
+                    part.count = 0;
+                    part.epoch = frame_.epoch ();
+                }
+
+                return part;
+            }
+
+        private:
+            event::frame                   &frame_;
+            std::vector <partition>         partitions_;
+
+        public:
+            //-----------------------------------------------------------------
+            // Appends to the calling thread's partition, found once rather
+            // than per event; for use on that thread within the frame
+
+            class writer
+            {
+                public:
+                    explicit writer (stream &target) :
+                        target_ (target), part_ (target.current (target.frame_.partition ())) {}
+
+                public:
+                    void push (Event const &item) { emplace (item); }
+
+                    template <typename ...Args>
+                    void emplace (Args &&...args)
+                    {
+                        if (!part_.tail || part_.tail->count == batch_size)
+                            target_.grow (part_);
+
+                        new (part_.tail->at (part_.tail->count)) Event (std::forward <Args> (args)...);
+                        ++part_.tail->count;
+                        ++part_.count;
+                    }
+
+                private:
+                    stream                 &target_;
+                    partition              &part_;
+            };
+    };
+
+} }
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef _IO_FILE_ARCHIVE_HPP_
+#define _IO_FILE_ARCHIVE_HPP_
+
+namespace ceres { namespace io { namespace file { namespace archive {
+
+    //=========================================================================
+    // Binary chunk container: a header, the chunk payloads each aligned to 
+    // the file's alignment, then a table of contents of typed, sized chunk
+    // entries. Readers take payloads in place as buffer views of a mapping;
+    // writers stream payloads out and write the table last. Fields are in 
+    // host byte order, which the magic number checks.
+
+    struct header
+    {
+        uint32_t        magic;
+        uint16_t        version;
+        uint16_t        alignment;      // of each payload; a power of two
+        uint64_t        toc_offset;     // from the start of the file
+        uint32_t        chunk_count;
+        uint32_t        reserved;
+
+        constexpr static uint32_t MAGIC = 0x53524543;   // "CERS" on little endian
+        constexpr static uint16_t VERSION = 1;
+    };
+
+    struct entry
+    {
+        uint32_t        type;           // core::name hash of the chunk type
+        uint32_t        flags;          // reserved for the chunk type
+        uint64_t        offset;         // from the start of the file
+        uint64_t        size;
+    };
+
+    static_assert (sizeof (header) == 24, "archive header must be packed");
+    static_assert (sizeof (entry) == 24, "archive entry must be packed");
+
+    //-------------------------------------------------------------------------
+    // Validating view of an archive held in memory; nothing is copied
+
+    class reader
+    {
+        public:
+            typedef memory::buffer <uint8_t const> bytes_type;
+
+            static const size_t npos = size_t (-1);
+
+        public:
+            explicit reader (bytes_type const &file) :
+                base_ {file.items}, size_ {file.bytes}
+            {
+                validate ();
+            }
+
+        public:
+            size_t size () const { return header_? header_->chunk_count : 0; }
+            size_t alignment () const { return header_? header_->alignment : 0; }
+
+            // compares equal to the core::name of the chunk type
+            uint32_t type (size_t index) const { return toc_[index].type; }
+
+            uint32_t flags (size_t index) const { return toc_[index].flags; }
+
+            bytes_type payload (size_t index) const
+            {
+                return {base_ + toc_[index].offset, size_t (toc_[index].size)};
+            }
+
+            // payload as an array of trivially copyable records
+            template <typename T>
+            memory::buffer <T const> view (size_t index) const
+            {
+                static_assert (std::is_trivially_copyable <T>::value, "records must be trivially copyable");
+                ASSERTF (alignof (T) <= alignment (), "record is more aligned than the archive");
+
+                auto bytes = payload (index);
+                return {static_cast <T const *> (bytes.pointer), bytes.bytes / sizeof (T)};
+            }
+
+            // index of the first chunk of the type at or after from, or npos
+            size_t find (core::name type, size_t from = 0) const
+            {
+                for (size_t index = from; index < size (); ++index)
+                    if (toc_[index].type == uint32_t (type))
+                        return index;
+
+                return npos;
+            }
+
+            // hands each chunk of the type to the consumer as it is reached
+            template <typename Consumer>
+            size_t each (core::name type, Consumer &&consume) const
+            {
+                size_t count = 0;
+
+                for (size_t index = find (type); index != npos; index = find (type, index + 1), ++count)
+                    consume (payload (index));
+
+                return count;
+            }
+
+        public:
+            operator bool () const { return !error_; }
+            std::error_code error () const { return error_; }
+
+        private:
+            void validate ()
+            {
+                auto fail = [this] () 
+                { 
+                    error_ = std::make_error_code (std::errc::illegal_byte_sequence); 
+                    header_ = nullptr;
+                };
+
+                if (size_ < sizeof (header))
+                    return fail ();
+
+                header_ = reinterpret_cast <header const *> (base_);
+
+                auto alignment = header_->alignment;
+                auto offset = header_->toc_offset;
+                auto count = header_->chunk_count;
+
+                if (header_->magic != header::MAGIC || header_->version != header::VERSION ||
+                    alignment == 0 || (alignment & (alignment - 1)) || 
+                    offset % alignof (entry) || offset > size_ || 
+                    count > (size_ - offset) / sizeof (entry))
+                    return fail ();
+
+                toc_ = reinterpret_cast <entry const *> (base_ + offset);
+
+                for (size_t index = 0; index < count; ++index)
+                {
+                    auto const &chunk = toc_[index];
+
+                    if (chunk.offset % alignment || chunk.offset > offset || 
+                        chunk.size > offset - chunk.offset)
+                        return fail ();
+                }
+            }
+
+        private:
+            uint8_t const      *base_;
+            size_t              size_;
+            header const       *header_ = nullptr;
+            entry const        *toc_ = nullptr;
+            std::error_code     error_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Streams chunks out to a file; the table of contents is written by 
+    // close, without which the archive does not validate
+
+    class writer
+    {
+        public:
+            typedef memory::buffer <uint8_t const> bytes_type;
+
+        public:
+            explicit writer (char const *path, uint16_t alignment = 64) :
+                file_ {path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc}
+            {
+                ASSERTF (alignment && !(alignment & (alignment - 1)), "alignment must be a power of two");
+
+                header_ = header {header::MAGIC, header::VERSION, alignment, 0, 0, 0};
+                file_.write (reinterpret_cast <char const *> (&header_), sizeof (header_));
+                position_ = sizeof (header_);
+                check ();
+            }
+
+            ~writer () { close (); }
+
+        public:
+            std::error_code add (core::name type, bytes_type const &payload, uint32_t flags = 0)
+            {
+                pad (header_.alignment);
+                toc_.push_back (entry {type, flags, position_, payload.bytes});
+
+                file_.write (static_cast <char const *> (payload.pointer), payload.bytes);
+                position_ += payload.bytes;
+
+                return check ();
+            }
+
+            template <typename T>
+            std::error_code add (core::name type, memory::buffer <T const> const &records, uint32_t flags = 0)
+            {
+                static_assert (std::is_trivially_copyable <T>::value, "records must be trivially copyable");
+                return add (type, bytes_type {records.pointer, records.bytes}, flags);
+            }
+
+            std::error_code close ()
+            {
+                if (!file_.is_open ())
+                    return error_;
+
+                pad (alignof (entry));
+                header_.toc_offset = position_;
+                header_.chunk_count = toc_.size ();
+
+                file_.write (reinterpret_cast <char const *> (toc_.data ()), toc_.size () * sizeof (entry));
+                file_.seekp (0);
+                file_.write (reinterpret_cast <char const *> (&header_), sizeof (header_));
+                file_.close ();
+
+                return check ();
+            }
+
+        public:
+            operator bool () const { return !error_; }
+            std::error_code error () const { return error_; }
+
+        private:
+            void pad (size_t alignment)
+            {
+                static char const zeros [256] = {};
+
+                size_t padding = (alignment - position_ % alignment) % alignment;
+                position_ += padding;
+
+                for (size_t written; padding > 0; padding -= written)
+                {
+                    written = std::min (padding, sizeof (zeros));
+                    file_.write (zeros, written);
+                }
+            }
+
+            std::error_code check ()
+            {
+                if (!file_.good () && !error_)
+                    error_ = std::make_error_code (std::errc::io_error);
+
+                return error_;
+            }
+
+        private:
+            std::ofstream           file_;
+            header                  header_;
+            uint64_t                position_ = 0;
+            std::vector <entry>     toc_;
+            std::error_code         error_;
+    };
+
+} } } }
+
+#endif
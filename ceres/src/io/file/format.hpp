@@ -123,6 +123,256 @@ namespace ceres { namespace io { namespace file { namespace format {
         return stream;
     }
 
+    //=========================================================================
+    // Zero-copy tokenizing of text held in memory, eg. a file mapping. Tokens
+    // are views into the input and nothing is allocated; delimiters are found
+    // with memchr, which the C library vectorizes.
+
+    using text = memory::buffer <char const>;
+
+    //-------------------------------------------------------------------------
+    // Assignable view of a run of characters in the input
+
+    struct token
+    {
+        char const *first = nullptr;
+        char const *last = nullptr;
+
+        token () = default;
+        token (char const *begin, char const *end) : first {begin}, last {end} {}
+
+        size_t size () const { return last - first; }
+        bool empty () const { return first == last; }
+
+        text view () const { return {first, size ()}; }
+        std::string string () const { return std::string (first, last); }
+    };
+
+    inline bool operator== (token const &tok, char const *str)
+    {
+        size_t length = std::strlen (str);
+        return tok.size () == length && std::memcmp (tok.first, str, length) == 0;
+    }
+
+    inline bool operator!= (token const &tok, char const *str)
+    {
+        return !(tok == str);
+    }
+
+    //-------------------------------------------------------------------------
+    // Scanning primitives
+
+    // first ch in [begin, end), or end
+    inline char const *find (char const *begin, char const *end, char const ch)
+    {
+        auto found = std::memchr (begin, ch, end - begin);
+        return found? static_cast <char const *> (found) : end;
+    }
+
+    inline bool is_blank (char const ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r';
+    }
+
+    inline token trim (char const *begin, char const *end)
+    {
+        while (begin != end && is_blank (*begin)) ++begin;
+        while (end != begin && is_blank (end[-1])) --end;
+
+        return {begin, end};
+    }
+
+    // unsigned decimal; fails on an empty token, any other character or overflow
+    template <typename Unsigned>
+    bool parse (token const &tok, Unsigned &value)
+    {
+        static_assert (std::is_unsigned <Unsigned>::value, "unsigned types only");
+
+        Unsigned result = 0;
+
+        for (char const *ch = tok.first; ch != tok.last; ++ch)
+        {
+            unsigned digit = *ch - '0';
+            if (digit > 9 || result > (std::numeric_limits <Unsigned>::max () - digit) / 10)
+                return false;
+
+            result = result * 10 + digit;
+        }
+
+        if (tok.empty ())
+            return false;
+
+        value = result;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // Line cursor; lines exclude the newline and any carriage return
+
+    class lines
+    {
+        public:
+            explicit lines (text const &input) : 
+                next_ {input.items}, end_ {input.items + size (input)} {}
+
+        public:
+            bool next ()
+            {
+                if (next_ == end_)
+                    return false;
+
+                char const *newline = find (next_, end_, '\n');
+                line_ = {next_, newline};
+                next_ = newline == end_? end_ : newline + 1;
+
+                if (!line_.empty () && line_.last[-1] == '\r')
+                    --line_.last;
+
+                ++number_;
+                return true;
+            }
+
+            token line () const { return line_; }
+
+            // one-based number of the current line
+            size_t number () const { return number_; }
+
+        private:
+            char const     *next_;
+            char const     *end_;
+            token           line_;
+            size_t          number_ = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    // INI reader: "[section]" headers and "key = value" entries, skipping 
+    // blank lines and ';' or '#' comments; tokens are trimmed
+
+    class ini_reader
+    {
+        public:
+            explicit ini_reader (text const &input) : lines_ {input} {}
+
+        public:
+            // advances to the next section header or entry; false at the end
+            // of input or on a malformed line
+            bool next ()
+            {
+                is_section_ = false;
+
+                while (lines_.next ())
+                {
+                    token line = lines_.line ();
+                    line = trim (line.first, line.last);
+
+                    if (line.empty () || *line.first == ';' || *line.first == '#')
+                        continue;
+
+                    if (*line.first == '[')
+                    {
+                        char const *close = find (line.first, line.last, ']');
+                        if (close == line.last)
+                            return fail ();
+
+                        section_ = trim (line.first + 1, close);
+                        key_ = value_ = {};
+                        is_section_ = true;
+                        return true;
+                    }
+
+                    char const *equals = find (line.first, line.last, '=');
+                    if (equals == line.last)
+                        return fail ();
+
+                    key_ = trim (line.first, equals);
+                    value_ = trim (equals + 1, line.last);
+                    return true;
+                }
+
+                return false;
+            }
+
+            bool is_section () const { return is_section_; }
+
+            // the current header, or the one enclosing the current entry
+            token section () const { return section_; }
+            token key () const { return key_; }
+            token value () const { return value_; }
+
+            size_t line () const { return lines_.number (); }
+            bool malformed () const { return malformed_; }
+
+        private:
+            bool fail ()
+            {
+                malformed_ = true;
+                return false;
+            }
+
+        private:
+            format::lines   lines_;
+            token           section_;
+            token           key_;
+            token           value_;
+            bool            is_section_ = false;
+            bool            malformed_ = false;
+    };
+
+    //-------------------------------------------------------------------------
+    // CSV reader: rows of delimited fields, without quoting; blank lines are
+    // skipped and fields are not trimmed
+
+    class csv_reader
+    {
+        public:
+            explicit csv_reader (text const &input, char const delim = ',') : 
+                lines_ {input}, delim_ {delim} {}
+
+        public:
+            // advances to the next non-blank row; false at the end of input
+            bool next_row ()
+            {
+                while (lines_.next ())
+                {
+                    row_ = lines_.line ();
+
+                    if (!row_.empty ())
+                    {
+                        more_ = true;
+                        return true;
+                    }
+                }
+
+                more_ = false;
+                return false;
+            }
+
+            // advances to the next field of the current row; "a,,b," has four
+            bool next_field ()
+            {
+                if (!more_)
+                    return false;
+
+                char const *delim = find (row_.first, row_.last, delim_);
+                field_ = {row_.first, delim};
+
+                more_ = delim != row_.last;
+                row_.first = more_? delim + 1 : row_.last;
+
+                return true;
+            }
+
+            token field () const { return field_; }
+            size_t line () const { return lines_.number (); }
+
+        private:
+            format::lines   lines_;
+            token           row_;
+            token           field_;
+            char            delim_;
+            bool            more_ = false;
+    };
+
 } } } }
 
 #endif
@@ -0,0 +1,94 @@
+#ifndef _IO_FILE_MAPPING_HPP_
+#define _IO_FILE_MAPPING_HPP_
+
+namespace ceres { namespace io { namespace file {
+
+    //=========================================================================
+    // Read-only memory mapping of a whole file; contents are read in place
+    // through buffer views that stay valid for the life of the mapping
+
+    class mapping
+    {
+        public:
+            mapping () = default;
+            mapping (mapping const &) = delete;
+            mapping &operator= (mapping const &) = delete;
+
+            mapping (mapping &&other) :
+                data_ {other.data_}, size_ {other.size_}, error_ {other.error_}
+            {
+                other.invalidate ();
+            }
+
+            mapping &operator= (mapping &&other)
+            {
+                if (this != &other)
+                {
+                    close ();
+
+                    data_ = other.data_;
+                    size_ = other.size_;
+                    error_ = other.error_;
+                    other.invalidate ();
+                }
+
+                return *this;
+            }
+
+            explicit mapping (char const *path) { open (path); }
+            ~mapping () { close (); }
+
+        public:
+            void invalidate () { data_ = nullptr; size_ = 0; }
+
+            size_t size () const { return size_; }
+
+            memory::buffer <uint8_t const> bytes () const { return {data_, size_}; }
+            memory::buffer <char const> text () const { return {data_, size_}; }
+
+        public:
+            std::error_code open (char const *path)
+            {
+                close ();
+                error_.clear ();
+
+                system::file::handle_type handle = system::file::INVALID;
+
+                if (!system::file::try_open (path, handle) ||
+                    !system::file::try_get_size (handle, size_) ||
+                    !system::file::try_map (handle, size_, data_))
+                {
+                    system::load_last_error_code (error_);
+                    size_ = 0;
+                }
+
+                // the mapping holds its own reference to the file
+                if (handle != system::file::INVALID)
+                    system::file::try_close (handle);
+
+                return error_;
+            }
+
+            std::error_code close ()
+            {
+                if (data_ && !system::file::try_unmap (data_, size_))
+                    system::load_last_error_code (error_);
+
+                invalidate ();
+
+                return error_;
+            }
+
+        public:
+            operator bool () const { return !error_; }
+            std::error_code error () const { return error_; }
+
+        private:
+            void const     *data_ = nullptr;
+            size_t          size_ = 0;
+            std::error_code error_;
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,568 @@
+#ifndef _IO_NET_COMPLETION_HPP_
+#define _IO_NET_COMPLETION_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Completion-style reactor for connected stream sockets: owners are
+    // handed received bytes rather than readiness, and queue sends that
+    // complete in order. Runs on io_uring where available, using multishot
+    // receives into a provided buffer ring, registered file slots, and sends
+    // submitted as linked chains; otherwise falls back to the epoll reactor
+    // with the same interface. Driven by one thread; only stop () may be
+    // called from elsewhere.
+
+    class completion_reactor
+    {
+        public:
+            enum class backend { epoll, uring };
+
+            // data is only valid during the call; empty data without error is
+            // an orderly shutdown, after which the socket has been removed
+            using receiver = std::function <void (socket::handle_type,
+                    memory::bytebuffer const &data, std::error_code error)>;
+
+        public:
+            explicit completion_reactor (backend preferred = backend::uring,
+                    size_t connections = 1024, size_t buffers = 1024, size_t buffer_size = 4096) :
+                buffer_size_ {buffer_size}
+            {
+                ASSERTF ((buffers & (buffers - 1)) == 0 && buffers <= (1u << 15),
+                        "buffer count must be a power of 2 no greater than 32768");
+
+                if (preferred == backend::uring && system::uring::is_supported ())
+                    open_uring (connections, buffers);
+
+                if (backend_ == backend::epoll)
+                {
+                    error_.clear ();
+                    epoll_.reset (new reactor);
+                    scratch_.resize (buffer_size_);
+                }
+            }
+
+            ~completion_reactor ()
+            {
+                if (backend_ == backend::uring)
+                    close_uring ();
+            }
+
+            completion_reactor (completion_reactor const &) = delete;
+            completion_reactor &operator= (completion_reactor const &) = delete;
+
+        public:
+            backend get_backend () const { return backend_; }
+
+            // takes ownership of a connected socket and starts receiving
+            std::error_code add (socket &&sock, receiver callback)
+            {
+                return backend_ == backend::uring?
+                    uring_add (std::move (sock), std::move (callback)) :
+                    epoll_add (std::move (sock), std::move (callback));
+            }
+
+            // safe to call from a receiver; the socket is closed once idle
+            std::error_code remove (socket::handle_type handle)
+            {
+                return backend_ == backend::uring? uring_remove (handle) : epoll_remove (handle);
+            }
+
+            // copies the data; sends on one socket complete in call order
+            std::error_code send (socket::handle_type handle, memory::bytebuffer const &data)
+            {
+                return backend_ == backend::uring? uring_send (handle, data) : epoll_send (handle, data);
+            }
+
+        public:
+            // waits up to timeout (negative: indefinitely) and dispatches completions
+            size_t poll (int timeout_ms = -1)
+            {
+                return backend_ == backend::uring? uring_poll (timeout_ms) : epoll_->poll (timeout_ms);
+            }
+
+            void run ()
+            {
+                if (backend_ == backend::epoll)
+                    return epoll_->run ();
+
+                while (!stopped_.load (std::memory_order_acquire) && !error_)
+                    uring_poll (-1);
+            }
+
+            // thread-safe and sticky; interrupts a blocked poll
+            void stop ()
+            {
+                if (backend_ == backend::epoll)
+                    return epoll_->stop ();
+
+                stopped_.store (true, std::memory_order_release);
+                system::event::try_signal_wakeup (wakeup_);
+            }
+
+        public:
+            operator bool () const { return !error (); }
+            std::error_code error () const { return epoll_? epoll_->error () : error_; }
+
+        private:
+            //-----------------------------------------------------------------
+            // io_uring backend
+
+            // user data: operation in the top byte, connection slot, then buffer
+            enum operation : uint64_t { RECEIVE = 1, SEND, CANCEL, WAKEUP };
+
+            static uint64_t encode (operation op, uint32_t slot, uint32_t buffer = 0)
+            {
+                return (uint64_t (op) << 56) | (uint64_t (slot) << 32) | buffer;
+            }
+
+            struct connection
+            {
+                socket                  sock;
+                receiver                callback;
+                std::vector <uint32_t>  queued;         // send buffers not yet submitted
+                size_t                  inflight = 0;   // sends submitted, not completed
+                bool                    receiving = false;
+                bool                    closing = false;
+            };
+
+            void open_uring (size_t connections, size_t buffers)
+            {
+                auto entries = std::min <size_t> (std::max <size_t> (2 * connections, 64), 4096);
+
+                if (!system::uring::try_open (ring_, 1u << core::bit::log2_ceil (entries)) ||
+                    !system::uring::try_register_files (ring_, connections) ||
+                    !system::uring::try_register_buffer_ring (ring_, receives_, 0, buffers) ||
+                    !system::event::try_open_wakeup (wakeup_))
+                {
+                    system::load_last_error_code (error_);
+
+                    if (ring_.handle != system::uring::INVALID)
+                        system::uring::try_close (ring_);
+
+                    return;
+                }
+
+                backend_ = backend::uring;
+
+                connections_.resize (connections);
+                receive_slab_.resize (buffers * buffer_size_);
+                send_slab_.resize (buffers * buffer_size_);
+                send_lengths_.resize (buffers);
+
+                for (size_t slot = connections; slot > 0; --slot)
+                    free_slots_.push_back (slot - 1);
+
+                for (size_t buffer = buffers; buffer > 0; --buffer)
+                    free_sends_.push_back (buffer - 1);
+
+                for (size_t buffer = 0; buffer < buffers; ++buffer)
+                    system::uring::provide_buffer (receives_,
+                            &receive_slab_ [buffer * buffer_size_], buffer_size_, buffer);
+
+                system::uring::publish_buffers (receives_);
+                arm_wakeup ();
+            }
+
+            void close_uring ()
+            {
+                for (auto &conn : connections_)
+                    conn.sock.close ();
+
+                system::uring::try_unregister_buffer_ring (ring_, receives_);
+                system::uring::try_close (ring_);
+                system::event::try_close (wakeup_);
+            }
+
+            system::uring::submission_type *submission ()
+            {
+                auto sqe = system::uring::next_submission (ring_);
+
+                if (sqe == nullptr)
+                {
+                    unsigned submitted;
+                    if (!system::uring::try_submit (ring_, 0, 0, submitted))
+                        system::load_last_error_code (error_);
+
+                    sqe = system::uring::next_submission (ring_);
+                }
+
+                ASSERTF (sqe != nullptr, "submission queue exhausted");
+                return sqe;
+            }
+
+            std::error_code uring_add (socket &&sock, receiver callback)
+            {
+                if (free_slots_.empty ())
+                    return std::make_error_code (std::errc::too_many_files_open);
+
+                auto slot = free_slots_.back ();
+
+                if (!system::uring::try_update_file (ring_, slot, sock.handle ()))
+                {
+                    std::error_code result;
+                    system::load_last_error_code (result);
+                    return result;
+                }
+
+                free_slots_.pop_back ();
+                slots_[sock.handle ()] = slot;
+
+                connection &conn = connections_[slot];
+                conn.sock = std::move (sock);
+                conn.callback = std::move (callback);
+                conn.closing = false;
+
+                arm_receive (slot);
+                return {};
+            }
+
+            std::error_code uring_remove (socket::handle_type handle)
+            {
+                auto found = slots_.find (handle);
+                if (found == slots_.end ())
+                    return std::make_error_code (std::errc::bad_file_descriptor);
+
+                begin_close (found->second);
+                return {};
+            }
+
+            std::error_code uring_send (socket::handle_type handle, memory::bytebuffer const &data)
+            {
+                auto found = slots_.find (handle);
+                if (found == slots_.end ())
+                    return std::make_error_code (std::errc::bad_file_descriptor);
+
+                auto slot = found->second;
+                connection &conn = connections_[slot];
+
+                if (conn.closing)
+                    return std::make_error_code (std::errc::broken_pipe);
+
+                size_t chunks = (data.bytes + buffer_size_ - 1) / buffer_size_;
+                if (chunks > free_sends_.size ())
+                    return std::make_error_code (std::errc::no_buffer_space);
+
+                for (size_t offset = 0; offset < data.bytes; offset += buffer_size_)
+                {
+                    auto buffer = free_sends_.back ();
+                    auto length = std::min (buffer_size_, data.bytes - offset);
+                    free_sends_.pop_back ();
+
+                    std::memcpy (&send_slab_ [buffer * buffer_size_], data.items + offset, length);
+                    send_lengths_[buffer] = length;
+                    conn.queued.push_back (buffer);
+                }
+
+                // a chain in flight is followed by the next once it completes
+                if (conn.inflight == 0)
+                    submit_chain (slot);
+
+                return {};
+            }
+
+            size_t uring_poll (int timeout_ms)
+            {
+                unsigned submitted;
+
+                if (!system::uring::try_submit (ring_, 1, timeout_ms, submitted))
+                {
+                    system::load_last_error_code (error_);
+                    return 0;
+                }
+
+                size_t count = 0;
+
+                while (auto cqe = system::uring::peek_completion (ring_))
+                {
+                    auto completion = *cqe;
+                    system::uring::advance_completion (ring_);
+
+                    complete (completion);
+                    ++count;
+                }
+
+                system::uring::publish_buffers (receives_);
+
+                return count;
+            }
+
+        private:
+            void arm_receive (uint32_t slot)
+            {
+                system::uring::prepare_receive_multishot (submission (), slot,
+                        receives_.group, encode (RECEIVE, slot));
+                connections_[slot].receiving = true;
+            }
+
+            void arm_wakeup ()
+            {
+                system::uring::prepare_read (submission (), wakeup_,
+                        &wakeup_value_, sizeof (wakeup_value_), encode (WAKEUP, 0));
+            }
+
+            // submits queued sends as one linked chain, in order; the chain is
+            // kept within the free queue space so it is never split
+            void submit_chain (uint32_t slot)
+            {
+                connection &conn = connections_[slot];
+
+                size_t space = ring_.sq_entries - (ring_.sq_staged - *ring_.sq_head);
+                size_t count = std::min (conn.queued.size (), size_t (ring_.sq_entries / 2));
+
+                if (count > space)
+                {
+                    unsigned submitted;
+                    if (!system::uring::try_submit (ring_, 0, 0, submitted))
+                        system::load_last_error_code (error_);
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    auto buffer = conn.queued [i];
+                    system::uring::prepare_send (submission (), slot,
+                            &send_slab_ [buffer * buffer_size_], send_lengths_[buffer],
+                            encode (SEND, slot, buffer), i + 1 < count);
+                }
+
+                conn.queued.erase (conn.queued.begin (), conn.queued.begin () + count);
+                conn.inflight = count;
+            }
+
+            void complete (system::uring::completion_type const &cqe)
+            {
+                auto data = system::uring::data_of (cqe);
+                auto result = system::uring::result_of (cqe);
+                auto slot = uint32_t (data >> 32) & 0xFFFFFF;
+
+                switch (data >> 56)
+                {
+                    case RECEIVE: return received (slot, cqe);
+                    case SEND: return sent (slot, uint32_t (data), result);
+                    case WAKEUP: if (!stopped_.load (std::memory_order_acquire)) arm_wakeup (); return;
+                    default: return; // cancellation results are not needed
+                }
+            }
+
+            void received (uint32_t slot, system::uring::completion_type const &cqe)
+            {
+                connection &conn = connections_[slot];
+                auto result = system::uring::result_of (cqe);
+                auto handle = conn.sock.handle ();
+
+                if (!system::uring::has_more (cqe))
+                    conn.receiving = false;
+
+                if (system::uring::has_buffer (cqe))
+                {
+                    auto buffer = system::uring::buffer_of (cqe);
+                    auto data = &receive_slab_ [buffer * buffer_size_];
+
+                    if (result > 0 && !conn.closing)
+                        conn.callback (handle, {data, size_t (result)}, {});
+
+                    system::uring::provide_buffer (receives_, data, buffer_size_, buffer);
+                }
+
+                // removed before the receiver hears of it, as with epoll
+                if (result == 0 && !conn.closing)
+                {
+                    begin_close (slot);
+                    conn.callback (handle, {}, {});
+                }
+                else if (result < 0 && result != -ENOBUFS && !conn.closing)
+                {
+                    begin_close (slot);
+                    conn.callback (handle, {}, std::error_code {-result, std::system_category ()});
+                }
+
+                // multishot ends when buffers run out; receive again once returned
+                if (!conn.receiving && !conn.closing)
+                    arm_receive (slot);
+
+                release_if_idle (slot);
+            }
+
+            void sent (uint32_t slot, uint32_t buffer, int result)
+            {
+                connection &conn = connections_[slot];
+                free_sends_.push_back (buffer);
+                --conn.inflight;
+
+                // a failed or short send cancels the rest of its chain
+                if ((result < 0 || uint32_t (result) < send_lengths_[buffer]) && !conn.closing)
+                {
+                    auto code = result < 0? -result : int (std::errc::broken_pipe);
+                    begin_close (slot);
+                    conn.callback (conn.sock.handle (), {}, std::error_code {code, std::system_category ()});
+                }
+
+                if (conn.inflight == 0 && !conn.queued.empty () && !conn.closing)
+                    submit_chain (slot);
+
+                release_if_idle (slot);
+            }
+
+            void begin_close (uint32_t slot)
+            {
+                connection &conn = connections_[slot];
+
+                if (conn.closing)
+                    return;
+
+                conn.closing = true;
+
+                for (auto buffer : conn.queued)
+                    free_sends_.push_back (buffer);
+                conn.queued.clear ();
+
+                if (conn.receiving)
+                    system::uring::prepare_cancel (submission (),
+                            encode (RECEIVE, slot), encode (CANCEL, slot));
+            }
+
+            // the slot is reused only once no operation can complete against it
+            void release_if_idle (uint32_t slot)
+            {
+                connection &conn = connections_[slot];
+
+                if (!conn.closing || conn.receiving || conn.inflight > 0 || 
+                    conn.sock.handle () == socket::INVALID)
+                    return;
+
+                system::uring::try_update_file (ring_, slot, system::uring::INVALID);
+                slots_.erase (conn.sock.handle ());
+
+                conn.sock.close ();
+                conn.sock = socket {};
+                conn.callback = nullptr;
+
+                free_slots_.push_back (slot);
+            }
+
+        private:
+            //-----------------------------------------------------------------
+            // epoll backend: drains readable sockets into a scratch buffer and
+            // holds unsent bytes until the socket is writable again
+
+            struct stream
+            {
+                receiver                callback;
+                std::vector <uint8_t>   pending;
+            };
+
+            std::error_code epoll_add (socket &&sock, receiver callback)
+            {
+                auto handle = sock.handle ();
+                streams_[handle].callback = std::move (callback);
+
+                auto result = epoll_->add (std::move (sock),
+                        [this] (socket &s, uint32_t events) { ready (s, events); });
+
+                if (result)
+                    streams_.erase (handle);
+
+                return result;
+            }
+
+            std::error_code epoll_remove (socket::handle_type handle)
+            {
+                streams_.erase (handle);
+                return epoll_->remove (handle);
+            }
+
+            std::error_code epoll_send (socket::handle_type handle, memory::bytebuffer const &data)
+            {
+                auto found = streams_.find (handle);
+                if (found == streams_.end ())
+                    return std::make_error_code (std::errc::bad_file_descriptor);
+
+                auto &pending = found->second.pending;
+                size_t sent = 0;
+
+                if (pending.empty () &&
+                    !system::socket::try_send (handle, data.pointer, data.bytes, sent))
+                {
+                    std::error_code result;
+                    system::load_last_error_code (result);
+
+                    if (!socket::would_block (result))
+                        return result;
+                }
+
+                pending.insert (pending.end (), data.items + sent, data.items + data.bytes);
+                return {};
+            }
+
+            void ready (socket &sock, uint32_t events)
+            {
+                auto handle = sock.handle ();
+
+                if (events & reactor::writable)
+                    flush (sock);
+
+                // the receiver may remove the stream, so look it up each time
+                for (auto found = streams_.find (handle); found != streams_.end ();
+                        found = streams_.find (handle))
+                {
+                    size_t received = 0;
+                    auto result = sock.receive ({scratch_.data (), scratch_.size ()}, received);
+
+                    if (socket::would_block (result))
+                        break;
+
+                    auto callback = found->second.callback;
+
+                    if (result || received == 0)
+                    {
+                        epoll_remove (handle);
+                        callback (handle, {}, result);
+                        break;
+                    }
+
+                    callback (handle, {scratch_.data (), received}, {});
+                }
+            }
+
+            void flush (socket &sock)
+            {
+                auto found = streams_.find (sock.handle ());
+                if (found == streams_.end () || found->second.pending.empty ())
+                    return;
+
+                auto &pending = found->second.pending;
+                size_t sent = 0;
+
+                if (!sock.send ({pending.data (), pending.size ()}, sent))
+                    pending.erase (pending.begin (), pending.begin () + sent);
+            }
+
+        private:
+            backend                                 backend_ = backend::epoll;
+            size_t const                            buffer_size_;
+            std::error_code                         error_;
+
+            // io_uring
+            system::uring::ring_type                ring_;
+            system::uring::buffer_ring_type         receives_;
+            system::event::handle_type              wakeup_ = system::event::INVALID;
+            uint64_t                                wakeup_value_ = 0;
+            std::atomic <bool>                      stopped_ {false};
+
+            std::vector <connection>                connections_;
+            std::vector <uint32_t>                  free_slots_;
+            std::unordered_map <socket::handle_type, uint32_t> slots_;
+
+            std::vector <uint8_t>                   receive_slab_;
+            std::vector <uint8_t>                   send_slab_;
+            std::vector <uint32_t>                  send_lengths_;
+            std::vector <uint32_t>                  free_sends_;
+
+            // epoll
+            std::unique_ptr <reactor>               epoll_;
+            std::unordered_map <socket::handle_type, stream> streams_;
+            std::vector <uint8_t>                   scratch_;
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef _IO_NET_DATAGRAM_HPP_
+#define _IO_NET_DATAGRAM_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Ring of preallocated datagram slots for batched UDP I/O. Slot payloads
+    // are laid out back to back in one slab, with an I/O vector, a remote
+    // address and control space per slot, so a batch of messages can be
+    // handed to the kernel in a single system call without allocation.
+    // Slots are filled by the producer (acquire/commit or push) and drained
+    // by the consumer (front/pop); the ring itself is single-threaded.
+
+    class datagram_ring
+    {
+        public:
+            struct datagram
+            {
+                memory::bytebuffer      data;
+                socket::address const  &remote;
+                uint16_t                segment;    // GRO segment size; 0 if single
+            };
+
+        public:
+            datagram_ring (size_t count, size_t slot_size = 1500) :
+                mask_ {(size_t (1) << core::bit::log2_ceil (count)) - 1},
+                slot_size_ {slot_size},
+                control_size_ {system::socket::segment_control_size ()},
+                payload_ ((mask_ + 1) * slot_size),
+                control_ ((mask_ + 1) * control_size_),
+                vectors_ (mask_ + 1),
+                lengths_ (mask_ + 1),
+                segments_ (mask_ + 1),
+                remotes_ (mask_ + 1),
+                messages_ (mask_ + 1)
+            {
+                for (size_t slot = 0; slot <= mask_; ++slot)
+                {
+                    vectors_[slot].iov_base = payload_.data () + slot * slot_size_;
+                    vectors_[slot].iov_len = slot_size_;
+                }
+            }
+
+            datagram_ring (datagram_ring const &) = delete;
+            datagram_ring &operator= (datagram_ring const &) = delete;
+
+        public:
+            size_t capacity () const { return mask_ + 1; }
+            size_t occupied () const { return head_ - tail_; }
+            size_t vacant () const { return capacity () - occupied (); }
+            size_t slot_size () const { return slot_size_; }
+
+            bool empty () const { return head_ == tail_; }
+            bool full () const { return occupied () == capacity (); }
+
+        public:
+            // storage of the next free slot, to be filled in place and committed
+            memory::bytebuffer acquire ()
+            {
+                ASSERTF (!full (), "acquiring from a full ring");
+                return {payload (head_), slot_size_};
+            }
+
+            void commit (size_t length, socket::address const &remote)
+            {
+                ASSERTF (length <= slot_size_, "datagram exceeds slot size");
+
+                auto slot = head_ & mask_;
+                lengths_[slot] = length;
+                segments_[slot] = 0;
+                remotes_[slot] = remote;
+                ++head_;
+            }
+
+            bool push (memory::bytebuffer const &data, socket::address const &remote)
+            {
+                if (full () || data.bytes > slot_size_)
+                    return false;
+
+                std::memcpy (payload (head_), data.pointer, data.bytes);
+                commit (data.bytes, remote);
+                return true;
+            }
+
+            datagram front () const
+            {
+                ASSERTF (!empty (), "reading from an empty ring");
+
+                auto slot = tail_ & mask_;
+                return {{payload (tail_), lengths_[slot]}, remotes_[slot], segments_[slot]};
+            }
+
+            void pop ()
+            {
+                ASSERTF (!empty (), "popping from an empty ring");
+                ++tail_;
+            }
+
+        public:
+            // Sends committed datagrams in one call, popping those the kernel
+            // accepted. With segment set, runs of equal-sized datagrams to the
+            // same remote are coalesced into one UDP_SEGMENT (GSO) message.
+            std::error_code send (socket &sock, size_t &sent, bool segment = false)
+            {
+                size_t count = 0, slots = 0;
+
+                for (size_t pos = tail_; pos != head_; ++count)
+                {
+                    auto run = segment? segment_run (pos) : 1;
+                    auto slot = pos & mask_;
+
+                    msghdr &header = messages_[count].msg_hdr;
+                    header = msghdr {};
+                    header.msg_name = (sockaddr *) remotes_[slot];
+                    header.msg_namelen = remotes_[slot].sockaddr_size ();
+                    header.msg_iov = &vectors_[slot];
+                    header.msg_iovlen = run;
+
+                    for (size_t i = 0; i < run; ++i)
+                        vectors_[slot + i].iov_len = lengths_[slot + i];
+
+                    if (run > 1)
+                        system::socket::set_segment_control (messages_[count],
+                                control (slot), lengths_[slot]);
+
+                    pos += run;
+                }
+
+                size_t messages = 0;
+                auto result = sock.send_batch ({messages_.data (), count}, messages);
+
+                for (size_t i = 0; i < messages; ++i)
+                    slots += messages_[i].msg_hdr.msg_iovlen;
+
+                reset_vectors (tail_, head_);
+                tail_ += slots;
+                sent = slots;
+
+                return result;
+            }
+
+            // Receives into vacant slots in one call, committing each datagram;
+            // with GRO enabled a slot may hold several coalesced segments, so
+            // slots should then be sized for 64KB to avoid truncation
+            std::error_code receive (socket &sock, size_t &received)
+            {
+                size_t count = std::min (vacant (), capacity () - (head_ & mask_));
+
+                received = 0;
+                if (count == 0)
+                    return {};
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    auto slot = (head_ + i) & mask_;
+
+                    msghdr &header = messages_[i].msg_hdr;
+                    header = msghdr {};
+                    header.msg_name = (sockaddr *) remotes_[slot];
+                    header.msg_namelen = remotes_[slot].sockaddr_capacity ();
+                    header.msg_iov = &vectors_[slot];
+                    header.msg_iovlen = 1;
+                    header.msg_control = control (slot);
+                    header.msg_controllen = control_size_;
+                }
+
+                auto result = sock.receive_batch ({messages_.data (), count}, received);
+
+                for (size_t i = 0; i < received; ++i, ++head_)
+                {
+                    auto slot = head_ & mask_;
+                    lengths_[slot] = messages_[i].msg_len;
+                    segments_[slot] = system::socket::get_segment_control (messages_[i]);
+                }
+
+                return result;
+            }
+
+        private:
+            uint8_t *payload (size_t pos) const
+            {
+                return const_cast <uint8_t *> (payload_.data ()) + (pos & mask_) * slot_size_;
+            }
+
+            uint8_t *control (size_t slot)
+            {
+                return control_.data () + slot * control_size_;
+            }
+
+            // Consecutive slots sharing a remote, all but the last full-length
+            // and none longer than the first; bounded by the kernel limits of
+            // 64 segments and 64KB and by the wrap of the ring
+            size_t segment_run (size_t pos) const
+            {
+                constexpr size_t max_segments = 64;
+                constexpr size_t max_bytes = 65507;
+
+                auto first = pos & mask_;
+                auto length = lengths_[first];
+                size_t run = 1, bytes = length;
+
+                while (length > 0 && run < max_segments && 
+                       pos + run != head_ && first + run <= mask_)
+                {
+                    auto next = first + run;
+
+                    // only the last datagram of a run may be shorter
+                    if (lengths_[next - 1] != length || lengths_[next] > length ||
+                        bytes + lengths_[next] > max_bytes || 
+                        !(remotes_[next] == remotes_[first]))
+                        break;
+
+                    bytes += lengths_[next];
+                    ++run;
+                }
+
+                return run;
+            }
+
+            void reset_vectors (size_t first, size_t last)
+            {
+                for (auto pos = first; pos != last; ++pos)
+                    vectors_[pos & mask_].iov_len = slot_size_;
+            }
+
+        private:
+            size_t const    mask_;
+            size_t const    slot_size_;
+            size_t const    control_size_;
+
+            size_t          head_ = 0;      // next slot to commit
+            size_t          tail_ = 0;      // next slot to pop
+
+            std::vector <uint8_t>                       payload_;
+            std::vector <uint8_t>                       control_;
+            std::vector <iovec>                         vectors_;
+            std::vector <size_t>                        lengths_;
+            std::vector <uint16_t>                      segments_;
+            std::vector <socket::address>               remotes_;
+            std::vector <socket::message_type>          messages_;
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef _IO_NET_INTEREST_HPP_
+#define _IO_NET_INTEREST_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Area of interest management: which entities each connection's observer
+    // can see. Entity positions are bucketed by a spatial hash of a uniform
+    // grid, rebuilt by counting sort each tick. Each connection has a circle
+    // of interest; its query walks the grid cells the circle covers, and the
+    // difference from the last tick's result gives the entities that entered
+    // and left, which update the connection's relevancy bitset. An entity
+    // already relevant stays so until it leaves the circle grown by the
+    // hysteresis, so entities on the edge don't flicker. The changes feed
+    // the scheduler's relevancy.
+
+    class interest
+    {
+        public:
+            typedef uint32_t entity_id;
+            typedef uint32_t connection_id;
+
+            constexpr static size_t word_bits = 64;
+
+        public:
+            interest (size_t entities, size_t connections, float cell_size) :
+                x_ (entities, 0), y_ (entities, 0), cell_ (entities, 0),
+                sorted_ (entities), sorted_x_ (entities), sorted_y_ (entities), connections_ (connections),
+                inverse_cell_ {1 / cell_size},
+                bucket_mask_ {(size_t (1) << core::bit::log2_ceil (std::max <size_t> (entities, 2))) - 1},
+                starts_ (bucket_mask_ + 2, 0)
+            {
+                size_t words = (entities + word_bits - 1) / word_bits;
+
+                for (auto &conn : connections_)
+                    conn.mask.assign (words, 0);
+            }
+
+        public:
+            size_t entities () const { return x_.size (); }
+            size_t connections () const { return connections_.size (); }
+
+            // on the ground plane
+            void set_position (entity_id entity, float x, float y)
+            {
+                x_[entity] = x;
+                y_[entity] = y;
+            }
+
+            // the observer's circle; zero radius sees nothing
+            void set_area (connection_id conn, float x, float y, float radius, float hysteresis = 0)
+            {
+                connections_[conn].x = x;
+                connections_[conn].y = y;
+                connections_[conn].radius = radius;
+                connections_[conn].hysteresis = hysteresis;
+            }
+
+        public:
+            // rebuilds the grid from the positions and requeries every connection
+            void update ()
+            {
+                rebuild ();
+
+                for (auto &conn : connections_)
+                    query (conn);
+            }
+
+            // grid only, for callers querying connections in parallel
+            void rebuild ()
+            {
+                std::fill (starts_.begin (), starts_.end (), 0);
+
+                for (entity_id entity = 0; entity < entities (); ++entity)
+                {
+                    cell_[entity] = bucket (cell_of (x_[entity]), cell_of (y_[entity]));
+                    ++starts_[cell_[entity] + 1];
+                }
+
+                for (size_t b = 0; b <= bucket_mask_; ++b)
+                    starts_[b + 1] += starts_[b];
+
+                cursors_.assign (starts_.begin (), starts_.end () - 1);
+
+                // positions are copied in bucket order so queries read them in sequence
+                for (entity_id entity = 0; entity < entities (); ++entity)
+                {
+                    uint32_t s = cursors_[cell_[entity]]++;
+                    sorted_[s] = entity;
+                    sorted_x_[s] = x_[entity];
+                    sorted_y_[s] = y_[entity];
+                }
+            }
+
+            // connections share nothing but the grid, so these may run in parallel
+            void query (connection_id id) { query (connections_[id]); }
+
+            // sets relevancy 1 for entered entities and 0 for those that left;
+            // the first time, the whole bitset
+            void feed (scheduler &sched)
+            {
+                for (connection_id conn = 0; conn < connections (); ++conn)
+                {
+                    if (!connections_[conn].fed)
+                    {
+                        sched.set_relevancy (conn, relevancy (conn));
+                        connections_[conn].fed = true;
+                        continue;
+                    }
+
+                    for (auto entity : connections_[conn].entered)
+                        sched.set_relevancy (conn, entity, 1);
+
+                    for (auto entity : connections_[conn].left)
+                        sched.set_relevancy (conn, entity, 0);
+                }
+            }
+
+        public:
+            bool relevant (connection_id conn, entity_id entity) const
+            {
+                return connections_[conn].mask[entity / word_bits] >> (entity % word_bits) & 1;
+            }
+
+            // one bit per entity, as of the last query
+            memory::buffer <uint64_t const> relevancy (connection_id conn) const
+            {
+                auto &mask = connections_[conn].mask;
+                return {mask.data (), mask.size ()};
+            }
+
+            memory::buffer <entity_id const> entered (connection_id conn) const
+            {
+                auto &entered = connections_[conn].entered;
+                return {entered.data (), entered.size ()};
+            }
+
+            memory::buffer <entity_id const> left (connection_id conn) const
+            {
+                auto &left = connections_[conn].left;
+                return {left.data (), left.size ()};
+            }
+
+        private:
+            struct connection
+            {
+                float                       x = 0;
+                float                       y = 0;
+                float                       radius = 0;
+                float                       hysteresis = 0;
+                bool                        fed = false;
+
+                std::vector <uint64_t>      mask;
+
+                // sorted relevant entities of this query and the last
+                std::vector <entity_id>     relevant;
+                std::vector <entity_id>     previous;
+
+                // changes of the last query and scratch, reused across ticks
+                std::vector <entity_id>     entered;
+                std::vector <entity_id>     left;
+                std::vector <entity_id>     band;
+                std::vector <entity_id>     merged;
+                std::vector <size_t>        visited;
+            };
+
+        private:
+            int32_t cell_of (float coordinate) const
+            {
+                return int32_t (std::floor (coordinate * inverse_cell_));
+            }
+
+            size_t bucket (int32_t cx, int32_t cy) const
+            {
+                return ((uint32_t (cx) * 73856093u) ^ (uint32_t (cy) * 19349663u)) & bucket_mask_;
+            }
+
+            // the relevant entities are gathered as a sorted list, small and
+            // cached where the bitset is not; the bitset takes only the changes
+            void query (connection &conn)
+            {
+                std::swap (conn.relevant, conn.previous);
+                conn.relevant.clear ();
+                conn.entered.clear ();
+                conn.left.clear ();
+
+                // cleared here, not in gather, so a radius dropped to zero
+                // leaves no band from the last tick to keep entities relevant
+                conn.band.clear ();
+                conn.visited.clear ();
+
+                if (conn.radius > 0)
+                    gather (conn);
+
+                // those in the band between the circles stay only if relevant before
+                auto middle = conn.relevant.size ();
+                std::set_intersection (conn.band.begin (), conn.band.end (),
+                        conn.previous.begin (), conn.previous.end (), std::back_inserter (conn.relevant));
+                std::inplace_merge (conn.relevant.begin (), conn.relevant.begin () + middle, conn.relevant.end ());
+
+                std::set_difference (conn.relevant.begin (), conn.relevant.end (),
+                        conn.previous.begin (), conn.previous.end (), std::back_inserter (conn.entered));
+
+                std::set_difference (conn.previous.begin (), conn.previous.end (),
+                        conn.relevant.begin (), conn.relevant.end (), std::back_inserter (conn.left));
+
+                for (auto entity : conn.entered)
+                    conn.mask[entity / word_bits] |= uint64_t (1) << (entity % word_bits);
+
+                for (auto entity : conn.left)
+                    conn.mask[entity / word_bits] &= ~(uint64_t (1) << (entity % word_bits));
+            }
+
+            // entities inside the circle, and apart those between it and the
+            // grown circle
+            void gather (connection &conn)
+            {
+                float outer = conn.radius + conn.hysteresis;
+                float inner_squared = conn.radius * conn.radius;
+                float outer_squared = outer * outer;
+
+                int32_t x0 = cell_of (conn.x - outer), x1 = cell_of (conn.x + outer);
+                int32_t y0 = cell_of (conn.y - outer), y1 = cell_of (conn.y + outer);
+
+                for (int32_t cy = y0; cy <= y1; ++cy)
+                for (int32_t cx = x0; cx <= x1; ++cx)
+                {
+                    size_t b = bucket (cx, cy);
+
+                    // distinct cells may share a bucket; visit each once
+                    if (std::find (conn.visited.begin (), conn.visited.end (), b) != conn.visited.end ())
+                        continue;
+
+                    conn.visited.push_back (b);
+                    size_t relevant = conn.relevant.size (), band = conn.band.size ();
+
+                    for (size_t s = starts_[b]; s < starts_[b + 1]; ++s)
+                    {
+                        float dx = sorted_x_[s] - conn.x, dy = sorted_y_[s] - conn.y;
+                        float distance = dx * dx + dy * dy;
+
+                        if (distance <= inner_squared)
+                            conn.relevant.push_back (sorted_[s]);
+                        else if (distance <= outer_squared)
+                            conn.band.push_back (sorted_[s]);
+                    }
+
+                    // buckets are sorted by entity, so each adds a sorted run
+                    merge (conn.relevant, relevant, conn.merged);
+                    merge (conn.band, band, conn.merged);
+                }
+            }
+
+            // merges the sorted run from middle into the sorted run before it
+            static void merge (std::vector <entity_id> &items, size_t middle, std::vector <entity_id> &merged)
+            {
+                if (middle == 0 || middle == items.size () || items[middle - 1] < items[middle])
+                    return;
+
+                merged.resize (items.size ());
+                std::merge (items.begin (), items.begin () + middle, items.begin () + middle, items.end (), merged.begin ());
+                std::swap (items, merged);
+            }
+
+        private:
+            std::vector <float>             x_;
+            std::vector <float>             y_;
+            std::vector <uint32_t>          cell_;      // bucket of each entity
+            std::vector <entity_id>         sorted_;    // entities by bucket
+            std::vector <float>             sorted_x_;
+            std::vector <float>             sorted_y_;
+            std::vector <connection>        connections_;
+
+            float                           inverse_cell_;
+            size_t                          bucket_mask_;
+            std::vector <uint32_t>          starts_;    // of each bucket in sorted_
+
+            // scratch reused across rebuilds
+            std::vector <uint32_t>          cursors_;
+    };
+
+} } }
+
+#endif
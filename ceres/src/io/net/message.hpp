@@ -3,20 +3,104 @@
 
 namespace ceres { namespace io { namespace net {
 
+    //=========================================================================
+    // Wire format of the nexus transport. A packet is one datagram: a packet
+    // header carrying its sequence and the acknowledgement of the remote's
+    // recent packets, followed by messages packed from any number of streams.
+    // All fields are in network byte order.
+
+    using sequence_type = uint16_t;
+
+    // true if a is more recent than b, allowing for wrap around
+    inline bool sequence_greater (sequence_type a, sequence_type b)
+    {
+        return a != b && sequence_type (a - b) < 0x8000;
+    }
+
+    inline bool sequence_less (sequence_type a, sequence_type b)
+    {
+        return sequence_greater (b, a);
+    }
+
+    struct packet_header
+    {
+        enum : uint8_t { has_ack = 1 << 0 };
+
+        uint16_t        protocol;   // drops stray datagrams
+        uint8_t         flags;
+        sequence_type   sequence;
+        sequence_type   ack;        // most recent remote packet received, if has_ack
+        uint32_t        ack_bits;   // bit n: packet ack - (n + 1) received
+
+        constexpr static size_t wire_size = 11;
+    };
+
+    struct message_header
+    {
+        uint16_t        channel;
+        uint8_t         stream;
+        uint8_t         flags;      // stream delivery flags, see stream::flags
+        sequence_type   sequence;   // per stream
+        uint16_t        length;     // payload bytes that follow
+
+        constexpr static size_t wire_size = 8;
+    };
+
+    //-------------------------------------------------------------------------
+    // Queued outgoing message; reliable messages stay queued until acked
+
     class message
     {
         public:
-            explicit stream (int id, memory::buffer<uint8_t> const buf) 
+            message () = default;
+
+            message (sequence_type sequence, memory::bytebuffer const &payload) :
+                sequence_ {sequence}, payload_ (payload.items, payload.items + payload.bytes) {}
+
+        public:
+            sequence_type sequence () const { return sequence_; }
+
+            memory::bytebuffer payload () const
+            {
+                return {payload_.data (), payload_.size ()};
+            }
+
+            size_t wire_size () const
             {
+                return message_header::wire_size + payload_.size ();
             }
 
+        public:
+            // time of the most recent send; zero if never sent
+            std::chrono::steady_clock::time_point sent_time;
+
         private:
-            int id_;
-            memory::buffer<uint8_t> header_;
-            memory::buffer<uint8_t> body_;
-            memory::buffer<uint8_t> footer_;
+            sequence_type           sequence_ = 0;
+            std::vector <uint8_t>   payload_;
     };
 
 } } }
 
+namespace traits
+{
+    namespace data
+    {
+        template <> struct schema <ceres::io::net::packet_header> :
+        public ceres::data::schema::fields <ceres::io::net::packet_header,
+            SCHEMA_FIELD (ceres::io::net::packet_header, protocol),
+            SCHEMA_FIELD (ceres::io::net::packet_header, flags),
+            SCHEMA_FIELD (ceres::io::net::packet_header, sequence),
+            SCHEMA_FIELD (ceres::io::net::packet_header, ack),
+            SCHEMA_FIELD (ceres::io::net::packet_header, ack_bits)> {};
+
+        template <> struct schema <ceres::io::net::message_header> :
+        public ceres::data::schema::fields <ceres::io::net::message_header,
+            SCHEMA_FIELD (ceres::io::net::message_header, channel),
+            SCHEMA_FIELD (ceres::io::net::message_header, stream),
+            SCHEMA_FIELD (ceres::io::net::message_header, flags),
+            SCHEMA_FIELD (ceres::io::net::message_header, sequence),
+            SCHEMA_FIELD (ceres::io::net::message_header, length)> {};
+    }
+}
+
 #endif
@@ -0,0 +1,780 @@
+#ifndef _IO_NET_NEXUS_HPP_
+#define _IO_NET_NEXUS_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Multiplexed datagram transport (see notes/architecture.txt): streams
+    // carry messages with their own delivery guarantees, channels group the
+    // streams of one entity under a priority, connections group channels by
+    // endpoint, and the nexus owns the socket and the connections. Each
+    // packet acknowledges the remote's last 33 packets; reliable messages
+    // are resent until a packet carrying them is acknowledged.
+
+    using time_point = std::chrono::steady_clock::time_point;
+    using duration = std::chrono::steady_clock::duration;
+
+    //-------------------------------------------------------------------------
+    // Reliable streams hold sent messages in a window until acknowledged;
+    // send fails while the window is full. Ordered streams deliver in send
+    // order, holding early arrivals (reliable) or dropping late ones.
+
+    class stream
+    {
+        public:
+            enum flags : uint8_t
+            {
+                unreliable = 0,
+                reliable = 1 << 0,
+                ordered = 1 << 1,
+            };
+
+            // a message reference carried by a sent packet, for acknowledgement
+            struct reference
+            {
+                uint16_t        channel;
+                uint8_t         stream;
+                sequence_type   sequence;
+            };
+
+        public:
+            stream (uint16_t channel, uint8_t id, uint8_t flags, float weight, size_t max_payload,
+                    size_t window = 256) :
+                channel_ {channel}, id_ {id}, flags_ {flags}, weight_ {weight}, max_payload_ {max_payload},
+                mask_ {(size_t (1) << core::bit::log2_ceil (window)) - 1}
+            {
+                ASSERTF (mask_ < 0x8000, "window exceeds half the sequence space");
+
+                if (is_reliable ())
+                {
+                    sent_.resize (mask_ + 1);
+                    unacked_.resize (mask_ + 1);
+                    arrived_.resize (mask_ + 1);
+                }
+
+                if (is_reliable () && is_ordered ())
+                    held_.resize (mask_ + 1);
+            }
+
+            stream (stream const &) = delete;
+            stream &operator= (stream const &) = delete;
+
+        public:
+            uint16_t channel () const { return channel_; }
+            uint8_t id () const { return id_; }
+            uint8_t flags () const { return flags_; }
+
+            bool is_reliable () const { return flags_ & reliable; }
+            bool is_ordered () const { return flags_ & ordered; }
+
+            float weight () const { return weight_; }
+            void set_weight (float weight) { weight_ = weight; }
+
+            size_t max_payload () const { return max_payload_; }
+
+            // messages queued or awaiting acknowledgement
+            size_t outstanding () const
+            {
+                return queued_.size () + (is_reliable ()? sequence_type (next_ - base_) : 0);
+            }
+
+            bool idle () const { return outstanding () == 0; }
+
+            // false if the payload is too large or the reliable window is full
+            bool send (memory::bytebuffer const &payload)
+            {
+                if (payload.bytes > max_payload_)
+                    return false;
+
+                if (!is_reliable ())
+                {
+                    queued_.emplace_back (next_++, payload);
+                    return true;
+                }
+
+                if (sequence_type (next_ - base_) > mask_)
+                    return false;
+
+                sent_[next_ & mask_] = message {next_, payload};
+                unacked_[next_ & mask_] = true;
+                ++next_;
+
+                return true;
+            }
+
+        public:
+            // Connection side. Writes queued messages and reliable messages due
+            // for (re)send that fit the packet; returns the number written.
+            size_t pack (core::netstream &out, time_point now, duration resend,
+                    std::vector <reference> &references)
+            {
+                size_t count = 0;
+
+                while (!queued_.empty () && fits (out, queued_.front ()))
+                {
+                    write (out, queued_.front ());
+                    queued_.pop_front ();
+                    ++count;
+                }
+
+                for (sequence_type seq = base_; is_reliable () && seq != next_; ++seq)
+                {
+                    auto slot = seq & mask_;
+                    message &msg = sent_[slot];
+
+                    if (!unacked_[slot] || (msg.sent_time != time_point {} && now - msg.sent_time < resend))
+                        continue;
+
+                    if (!fits (out, msg))
+                        break;
+
+                    write (out, msg);
+                    msg.sent_time = now;
+                    references.push_back ({channel_, id_, seq});
+                    ++count;
+                }
+
+                return count;
+            }
+
+            void acknowledge (sequence_type seq)
+            {
+                if (!is_reliable () || sequence_type (seq - base_) >= sequence_type (next_ - base_))
+                    return;
+
+                unacked_[seq & mask_] = false;
+
+                while (base_ != next_ && !unacked_[base_ & mask_])
+                    sent_[base_++ & mask_] = message {};
+            }
+
+            template <typename Deliver>
+            void receive (sequence_type seq, memory::bytebuffer const &payload, Deliver &&deliver)
+            {
+                if (!is_reliable ())
+                {
+                    // unordered: everything; ordered: only what is newer than the last
+                    if (is_ordered () && received_any_ && !sequence_greater (seq, latest_))
+                        return;
+
+                    latest_ = seq;
+                    received_any_ = true;
+                    return deliver (payload);
+                }
+
+                // duplicates fall behind expected_ or onto an occupied slot
+                if (sequence_type (seq - expected_) > mask_ || arrived_[seq & mask_])
+                    return;
+
+                arrived_[seq & mask_] = true;
+
+                if (is_ordered ())
+                    held_[seq & mask_].assign (payload.items, payload.items + payload.bytes);
+                else
+                    deliver (payload);
+
+                while (arrived_[expected_ & mask_])
+                {
+                    auto slot = expected_++ & mask_;
+                    arrived_[slot] = false;
+
+                    if (is_ordered ())
+                        deliver (memory::bytebuffer {held_[slot].data (), held_[slot].size ()});
+                }
+            }
+
+        public:
+            float credit = 0; // accumulated priority, reset when packed
+
+        private:
+            static bool fits (core::netstream const &out, message const &msg)
+            {
+                return out.vacant () >= msg.wire_size ();
+            }
+
+            void write (core::netstream &out, message const &msg)
+            {
+                auto payload = msg.payload ();
+                message_header header {channel_, id_, flags_, msg.sequence (), uint16_t (payload.bytes)};
+
+                data::schema::serialize (out, header);
+                out.write_bytes (payload);
+            }
+
+        private:
+            uint16_t const  channel_;
+            uint8_t const   id_;
+            uint8_t const   flags_;
+            float           weight_;
+            size_t const    max_payload_;
+            size_t const    mask_;
+
+            // sending
+            sequence_type               next_ = 0;
+            sequence_type               base_ = 0;      // oldest unacknowledged
+            std::deque <message>        queued_;        // unreliable, sent once
+            std::vector <message>       sent_;          // reliable window
+            std::vector <bool>          unacked_;
+
+            // receiving
+            sequence_type               expected_ = 0;
+            sequence_type               latest_ = 0;
+            bool                        received_any_ = false;
+            std::vector <bool>          arrived_;
+            std::vector <std::vector <uint8_t>> held_;  // ordered early arrivals
+    };
+
+    //-------------------------------------------------------------------------
+    // Streams of one entity; packing priority is the channel priority
+    // scaled by each stream's weight
+
+    class channel
+    {
+        public:
+            channel (uint16_t id, float priority, size_t max_payload) :
+                id_ {id}, priority_ {priority}, max_payload_ {max_payload} {}
+
+            channel (channel const &) = delete;
+            channel &operator= (channel const &) = delete;
+
+        public:
+            uint16_t id () const { return id_; }
+
+            float priority () const { return priority_; }
+            void set_priority (float priority) { priority_ = priority; }
+
+            // returns the existing stream if already open
+            stream &open (uint8_t id, uint8_t flags, float weight = 1)
+            {
+                if (auto existing = find (id))
+                    return *existing;
+
+                streams_.emplace_back (new stream {id_, id, flags, weight, max_payload_});
+                return *streams_.back ();
+            }
+
+            stream *find (uint8_t id)
+            {
+                for (auto &s : streams_)
+                    if (s->id () == id)
+                        return s.get ();
+
+                return nullptr;
+            }
+
+            bool idle () const
+            {
+                return std::all_of (streams_.begin (), streams_.end (),
+                        [] (std::unique_ptr <stream> const &s) { return s->idle (); });
+            }
+
+            std::vector <std::unique_ptr <stream>> const &streams () const { return streams_; }
+
+        private:
+            uint16_t const  id_;
+            float           priority_;
+            size_t const    max_payload_;
+
+            std::vector <std::unique_ptr <stream>> streams_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Channels to one endpoint, with the packet acknowledgement state and
+    // the link statistics derived from it. Streams the remote side opens by
+    // sending on them count against a cap; messages on new streams past it
+    // are dropped, so a peer cannot make the connection allocate without bound
+
+    class connection
+    {
+        public:
+            struct statistics
+            {
+                duration    rtt = std::chrono::milliseconds (100);  // smoothed
+                float       loss = 0;                               // smoothed ratio
+
+                uint64_t    packets_sent = 0;
+                uint64_t    packets_received = 0;
+                uint64_t    packets_acked = 0;
+                uint64_t    packets_lost = 0;
+                uint64_t    bytes_sent = 0;
+                uint64_t    bytes_received = 0;
+                uint64_t    messages_refused = 0;   // on streams past the cap
+            };
+
+            constexpr static size_t max_packets = 1024;   // unresolved sent packets
+
+        public:
+            connection (socket::address const &remote, size_t mtu, size_t max_streams = 64) :
+                remote_ {remote}, mtu_ {mtu},
+                max_payload_ {mtu - packet_header::wire_size - message_header::wire_size},
+                max_streams_ {max_streams},
+                sent_ (max_packets)
+            {}
+
+            connection (connection const &) = delete;
+            connection &operator= (connection const &) = delete;
+
+        public:
+            socket::address const &remote () const { return remote_; }
+            statistics const &stats () const { return stats_; }
+
+            // returns the existing channel if already open
+            channel &open (uint16_t id, float priority = 1)
+            {
+                auto &slot = channels_[id];
+                if (!slot)
+                    slot.reset (new channel {id, priority, max_payload_});
+
+                return *slot;
+            }
+
+            channel *find (uint16_t id)
+            {
+                auto found = channels_.find (id);
+                return found != channels_.end ()? found->second.get () : nullptr;
+            }
+
+            bool idle () const
+            {
+                for (auto &entry : channels_)
+                    if (!entry.second->idle ())
+                        return false;
+
+                return true;
+            }
+
+            // bytes per second; zero leaves sending unlimited
+            void set_bandwidth (size_t bytes_per_second)
+            {
+                bandwidth_ = bytes_per_second;
+                budget_ = double (mtu_);
+            }
+
+        public:
+            // Nexus side. Packs due messages into packets, highest priority
+            // streams first, until nothing fits, the ring fills or the
+            // bandwidth budget is spent; returns the number of packets.
+            size_t flush (datagram_ring &ring, uint16_t protocol, time_point now)
+            {
+                refill (now);
+                rank ();
+
+                auto resend = std::max <duration> (2 * stats_.rtt, std::chrono::milliseconds (1));
+                size_t packets = 0;
+
+                while (!ring.full () && (bandwidth_ == 0 || budget_ >= mtu_))
+                {
+                    auto slot = ring.acquire ();
+                    core::netstream out {{slot.items, std::min (slot.bytes, mtu_)}};
+
+                    uint8_t flags = remote_any_? packet_header::has_ack : 0;
+                    packet_header header {protocol, flags, sequence_, remote_sequence_, remote_bits_};
+                    data::schema::serialize (out, header);
+
+                    // a record still unresolved this far back is lost
+                    record &rec = sent_[sequence_ % max_packets];
+                    if (!rec.resolved)
+                        lost (rec);
+
+                    sequence_type horizon = sequence_ - (max_packets - 1);
+                    if (sequence_less (oldest_, horizon))
+                        oldest_ = horizon;
+
+                    rec.references.clear ();
+                    size_t count = 0;
+
+                    for (auto s : ranked_)
+                    {
+                        auto packed = s->pack (out, now, resend, rec.references);
+                        if (packed > 0)
+                            s->credit = 0;
+
+                        count += packed;
+                    }
+
+                    if (count == 0 && !ack_pending_)
+                        break;
+
+                    rec.sequence = sequence_++;
+                    rec.time = now;
+                    rec.resolved = false;
+
+                    ring.commit (out.occupied (), remote_);
+                    ack_pending_ = false;
+                    budget_ -= out.occupied ();
+
+                    ++stats_.packets_sent;
+                    stats_.bytes_sent += out.occupied ();
+                    ++packets;
+
+                    if (count == 0)
+                        break;
+                }
+
+                return packets;
+            }
+
+            // header already parsed; deliver is called with (channel, stream, payload)
+            template <typename Deliver>
+            void receive (packet_header const &header, core::netstream &in, time_point now,
+                    Deliver &&deliver)
+            {
+                ++stats_.packets_received;
+                stats_.bytes_received += packet_header::wire_size + in.occupied ();
+
+                track (header.sequence);
+
+                if (header.flags & packet_header::has_ack)
+                    acknowledge (header.ack, header.ack_bits, now);
+
+                message_header msg;
+                memory::bytebuffer payload;
+
+                // datagrams are untrusted: a truncated header ends the packet
+                while (in.occupied () >= message_header::wire_size && data::schema::deserialize (in, msg) &&
+                        in.read_bytes (payload, msg.length))
+                {
+                    stream *st = accept (msg.channel, msg.stream, msg.flags);
+                    if (st == nullptr)
+                    {
+                        ++stats_.messages_refused;
+                        continue;
+                    }
+
+                    st->receive (msg.sequence, payload, [&] (memory::bytebuffer const &data)
+                    {
+                        deliver (st->channel (), st->id (), data);
+                    });
+                }
+            }
+
+        private:
+            // the stream a message arrived on, opened if the cap allows
+            stream *accept (uint16_t channel_id, uint8_t stream_id, uint8_t flags)
+            {
+                channel *ch = find (channel_id);
+                stream *st = ch? ch->find (stream_id) : nullptr;
+
+                if (st == nullptr && remote_streams_ < max_streams_)
+                {
+                    st = &open (channel_id).open (stream_id, flags);
+                    ++remote_streams_;
+                }
+
+                return st;
+            }
+
+            struct record
+            {
+                sequence_type                       sequence = 0;
+                bool                                resolved = true;
+                time_point                          time;
+                std::vector <stream::reference>     references;
+            };
+
+            // remote packets: most recent sequence plus a bit per earlier one
+            void track (sequence_type seq)
+            {
+                ack_pending_ = true;
+
+                if (!remote_any_)
+                {
+                    remote_sequence_ = seq;
+                    remote_any_ = true;
+                }
+                else if (sequence_greater (seq, remote_sequence_))
+                {
+                    sequence_type shift = seq - remote_sequence_;
+                    remote_bits_ = shift < 32? (remote_bits_ << shift) | (1u << (shift - 1)) :
+                        shift == 32? (1u << 31) : 0;
+                    remote_sequence_ = seq;
+                }
+                else
+                {
+                    sequence_type behind = remote_sequence_ - seq;
+                    if (behind >= 1 && behind <= 32)
+                        remote_bits_ |= 1u << (behind - 1);
+                }
+            }
+
+            void acknowledge (sequence_type ack, uint32_t bits, time_point now)
+            {
+                if (stats_.packets_sent == 0 || sequence_greater (ack, sequence_ - 1))
+                    return;
+
+                for (sequence_type i = 0; i <= 32; ++i)
+                    if (i == 0 || (bits & (1u << (i - 1))))
+                        acknowledged (sequence_type (ack - i), now);
+
+                // anything older than the acknowledged window is now lost
+                if (!acked_any_ || sequence_greater (ack, latest_ack_))
+                {
+                    latest_ack_ = ack;
+                    acked_any_ = true;
+
+                    for (; sequence_less (oldest_, sequence_type (ack - 32)); ++oldest_)
+                    {
+                        record &rec = sent_[oldest_ % max_packets];
+                        if (rec.sequence == oldest_ && !rec.resolved)
+                            lost (rec);
+                    }
+                }
+            }
+
+            void acknowledged (sequence_type seq, time_point now)
+            {
+                record &rec = sent_[seq % max_packets];
+                if (rec.resolved || rec.sequence != seq)
+                    return;
+
+                rec.resolved = true;
+                ++stats_.packets_acked;
+
+                auto sample = now - rec.time;
+                stats_.rtt = stats_.packets_acked == 1? sample : stats_.rtt + (sample - stats_.rtt) / 8;
+                stats_.loss += (0.f - stats_.loss) / 16;
+
+                for (auto &ref : rec.references)
+                    if (auto ch = find (ref.channel))
+                        if (auto st = ch->find (ref.stream))
+                            st->acknowledge (ref.sequence);
+            }
+
+            // its reliable messages are resent on the resend timer; only counted here
+            void lost (record &rec)
+            {
+                rec.resolved = true;
+                ++stats_.packets_lost;
+                stats_.loss += (1.f - stats_.loss) / 16;
+            }
+
+            void refill (time_point now)
+            {
+                if (bandwidth_ > 0 && refilled_ != time_point {})
+                {
+                    double seconds = std::chrono::duration <double> (now - refilled_).count ();
+                    budget_ = std::min (budget_ + seconds * bandwidth_, double (bandwidth_) / 10 + mtu_);
+                }
+
+                refilled_ = now;
+            }
+
+            // streams with anything to send, by accumulated priority
+            void rank ()
+            {
+                ranked_.clear ();
+
+                for (auto &entry : channels_)
+                {
+                    for (auto &s : entry.second->streams ())
+                    {
+                        if (s->idle ())
+                            continue;
+
+                        s->credit += entry.second->priority () * s->weight ();
+                        ranked_.push_back (s.get ());
+                    }
+                }
+
+                std::sort (ranked_.begin (), ranked_.end (),
+                        [] (stream const *a, stream const *b) { return a->credit > b->credit; });
+            }
+
+        private:
+            socket::address const   remote_;
+            size_t const            mtu_;
+            size_t const            max_payload_;
+            size_t const            max_streams_;
+            size_t                  remote_streams_ = 0;
+            statistics              stats_;
+
+            std::map <uint16_t, std::unique_ptr <channel>>  channels_;
+            std::vector <stream *>                          ranked_;
+
+            // local packets
+            sequence_type           sequence_ = 0;
+            sequence_type           oldest_ = 0;        // oldest possibly unresolved
+            sequence_type           latest_ack_ = 0;
+            bool                    acked_any_ = false;
+            std::vector <record>    sent_;
+
+            // remote packets
+            sequence_type           remote_sequence_ = 0;
+            uint32_t                remote_bits_ = 0;
+            bool                    remote_any_ = false;
+            bool                    ack_pending_ = false;
+
+            size_t                  bandwidth_ = 0;
+            double                  budget_ = 0;
+            time_point              refilled_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Owns the local socket and its connections; connections are created
+    // on connect, or on the first valid packet from an unknown endpoint.
+    // Not thread-safe; update is expected to be called once per frame.
+
+    class nexus
+    {
+        public:
+            using receiver = std::function <void (connection &, uint16_t channel, uint8_t stream,
+                    memory::bytebuffer const &payload)>;
+
+            using listener = std::function <void (connection &)>;
+
+            // incoming packets for which the filter returns false are dropped
+            using filter = std::function <bool (socket::address const &, memory::bytebuffer const &)>;
+
+        public:
+            // streams caps those each remote side may open on its connection
+            nexus (socket::address const &local, uint16_t protocol, size_t mtu = 1200, size_t slots = 256,
+                    size_t streams = 64) :
+                socket_ {socket::type::UDP, local.family ()},
+                protocol_ {protocol}, mtu_ {mtu}, streams_ {streams},
+                sends_ {slots, mtu}, receives_ {slots, mtu}
+            {
+                if (socket_) socket_.bind (local);
+                if (socket_) socket_.set_nonblocking ();
+            }
+
+            nexus (nexus const &) = delete;
+            nexus &operator= (nexus const &) = delete;
+
+        public:
+            connection &connect (socket::address const &remote)
+            {
+                auto &slot = connections_[remote];
+                if (!slot)
+                    slot.reset (new connection {remote, mtu_, streams_});
+
+                return *slot;
+            }
+
+            connection *find (socket::address const &remote)
+            {
+                auto found = connections_.find (remote);
+                return found != connections_.end ()? found->second.get () : nullptr;
+            }
+
+            void disconnect (socket::address const &remote)
+            {
+                connections_.erase (remote);
+            }
+
+            void on_connect (listener callback) { on_connect_ = std::move (callback); }
+            void on_receive (receiver callback) { on_receive_ = std::move (callback); }
+            void set_filter (filter callback) { filter_ = std::move (callback); }
+
+            socket::address local_address () { return socket_.local_address (); }
+
+        public:
+            std::error_code update (time_point now)
+            {
+                receive (now);
+                flush (now);
+                return error ();
+            }
+
+            // drains the socket, dispatching delivered messages to the receiver
+            std::error_code receive (time_point now)
+            {
+                size_t received = 0;
+
+                do
+                {
+                    auto result = receives_.receive (socket_, received);
+
+                    while (!receives_.empty ())
+                    {
+                        auto packet = receives_.front ();
+                        dispatch (packet.data, packet.remote, now);
+                        receives_.pop ();
+                    }
+
+                    if (result && !socket::would_block (result))
+                        return error_ = result;
+                }
+                while (received > 0);
+
+                return {};
+            }
+
+            std::error_code flush (time_point now)
+            {
+                size_t sent = 0;
+
+                for (auto &entry : connections_)
+                {
+                    // send whenever the ring fills so every connection gets a turn
+                    while (entry.second->flush (sends_, protocol_, now) > 0 && sends_.full ())
+                        if (send (sent) || sent == 0)
+                            break;
+                }
+
+                return sends_.empty ()? std::error_code {} : send (sent);
+            }
+
+        public:
+            operator bool () const { return !error (); }
+            std::error_code error () const { return error_? error_ : socket_.error (); }
+
+        private:
+            void dispatch (memory::bytebuffer const &data, socket::address const &remote, time_point now)
+            {
+                if (filter_ && !filter_ (remote, data))
+                    return;
+
+                core::netstream in {data, data.bytes};
+                packet_header header;
+
+                // stray datagrams too short for a header are dropped before parsing
+                if (in.occupied () < packet_header::wire_size ||
+                        !data::schema::deserialize (in, header) || header.protocol != protocol_)
+                    return;
+
+                connection *conn = find (remote);
+                if (conn == nullptr)
+                {
+                    conn = &connect (remote);
+                    if (on_connect_)
+                        on_connect_ (*conn);
+                }
+
+                conn->receive (header, in, now, [&] (uint16_t ch, uint8_t st, memory::bytebuffer const &payload)
+                {
+                    if (on_receive_)
+                        on_receive_ (*conn, ch, st, payload);
+                });
+            }
+
+            // packets the socket would not take stay queued for the next flush
+            std::error_code send (size_t &sent)
+            {
+                auto result = sends_.send (socket_, sent);
+
+                if (result && !socket::would_block (result))
+                    error_ = result;
+
+                return result;
+            }
+
+        private:
+            socket              socket_;
+            uint16_t const      protocol_;
+            size_t const        mtu_;
+            size_t const        streams_;
+
+            datagram_ring       sends_;
+            datagram_ring       receives_;
+
+            std::unordered_map <socket::address, std::unique_ptr <connection>, socket::address::hasher> connections_;
+
+            listener            on_connect_;
+            receiver            on_receive_;
+            filter              filter_;
+            std::error_code     error_;
+    };
+
+} } }
+
+#endif
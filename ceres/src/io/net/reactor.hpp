@@ -0,0 +1,268 @@
+#ifndef _IO_NET_REACTOR_HPP_
+#define _IO_NET_REACTOR_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Edge-triggered readiness reactor owning a set of non-blocking sockets.
+    // Handlers are told which events fired and must drain the socket until
+    // it would block, since an edge is only reported once per transition.
+    // A reactor is driven by one thread; only stop () may be called from
+    // elsewhere. Handlers run inline, or are posted to an executor if given.
+
+    class reactor
+    {
+        public:
+            using handler = std::function <void (socket &, uint32_t events)>;
+            using work = std::function <void ()>;
+            using executor = std::function <void (work)>;
+
+            enum : uint32_t
+            {
+                readable = system::event::readable,
+                writable = system::event::writable,
+                hangup = system::event::hangup,
+                failure = system::event::failure,
+            };
+
+        public:
+            reactor ()
+            {
+                if (!system::event::try_open (handle_) ||
+                    !system::event::try_open_wakeup (wakeup_) ||
+                    !system::event::try_add (handle_, wakeup_, readable, nullptr))
+                    system::load_last_error_code (error_);
+            }
+
+            ~reactor ()
+            {
+                entries_.clear ();
+
+                if (wakeup_ != system::event::INVALID)
+                    system::event::try_close (wakeup_);
+
+                if (handle_ != system::event::INVALID)
+                    system::event::try_close (handle_);
+            }
+
+            reactor (reactor const &) = delete;
+            reactor &operator= (reactor const &) = delete;
+
+        public:
+            // takes ownership of the socket and switches it to non-blocking
+            // mode; a socket that can't be added is dropped and its error
+            // returned, leaving the reactor running the others
+            std::error_code add (socket &&sock, handler callback,
+                    uint32_t events = readable | writable)
+            {
+                auto handle = sock.handle ();
+                auto item = std::make_shared <entry> (std::move (sock), std::move (callback));
+
+                if (item->sock.set_nonblocking ())
+                    return item->sock.error ();
+
+                auto flags = events | hangup | system::event::edge_triggered;
+
+                if (!system::event::try_add (handle_, handle, flags, item.get ()))
+                {
+                    std::error_code result;
+                    system::load_last_error_code (result);
+                    return result;
+                }
+
+                entries_[handle] = std::move (item);
+                return {};
+            }
+
+            // safe to call from a handler; the socket is closed after dispatch
+            std::error_code remove (socket::handle_type handle)
+            {
+                auto found = entries_.find (handle);
+                if (found == entries_.end ())
+                    return std::make_error_code (std::errc::bad_file_descriptor);
+
+                std::error_code result;
+
+                if (!system::event::try_remove (handle_, handle))
+                    system::load_last_error_code (result);
+
+                retired_.push_back (std::move (found->second));
+                entries_.erase (found);
+
+                return result;
+            }
+
+            void dispatch_to (executor exec)
+            {
+                executor_ = std::move (exec);
+            }
+
+        public:
+            // waits up to timeout (negative: indefinitely) and dispatches events
+            size_t poll (int timeout_ms = -1)
+            {
+                int ready = 0;
+
+                if (!system::event::try_wait (handle_, records_, max_records, timeout_ms, ready))
+                {
+                    std::error_code result;
+                    system::load_last_error_code (result);
+
+                    if (result != std::errc::interrupted)
+                        error_ = result;
+
+                    return 0;
+                }
+
+                for (int i = 0; i < ready; ++i)
+                {
+                    auto events = system::event::events_of (records_[i]);
+                    auto context = system::event::context_of (records_[i]);
+
+                    if (context == nullptr)
+                        system::event::try_clear_wakeup (wakeup_);
+                    else
+                        dispatch (static_cast <entry *> (context), events);
+                }
+
+                retired_.clear ();
+
+                return ready;
+            }
+
+            void run ()
+            {
+                while (!stopped_.load (std::memory_order_acquire) && !error_)
+                    poll ();
+            }
+
+            // thread-safe and sticky; interrupts a blocked poll
+            void stop ()
+            {
+                stopped_.store (true, std::memory_order_release);
+                system::event::try_signal_wakeup (wakeup_);
+            }
+
+        public:
+            size_t size () const { return entries_.size (); }
+
+            // set only when the reactor itself fails to open or wait, which
+            // stops run (); errors adding or removing a socket are returned
+            operator bool () const { return !error_; }
+            std::error_code error () const { return error_; }
+
+        private:
+            struct entry
+            {
+                socket  sock;
+                handler callback;
+
+                entry (socket &&s, handler &&h) :
+                    sock {std::move (s)}, callback {std::move (h)} {}
+            };
+
+            void dispatch (entry *item, uint32_t events)
+            {
+                if (!executor_)
+                    return item->callback (item->sock, events);
+
+                // keep the entry alive until the posted handler has run
+                auto found = entries_.find (item->sock.handle ());
+                if (found != entries_.end ())
+                {
+                    auto shared = found->second;
+                    executor_ ([shared, events] { shared->callback (shared->sock, events); });
+                }
+            }
+
+        private:
+            constexpr static int max_records = 256;
+
+            system::event::handle_type  handle_ = system::event::INVALID;
+            system::event::handle_type  wakeup_ = system::event::INVALID;
+            system::event::record_type  records_ [max_records];
+
+            std::unordered_map <socket::handle_type, std::shared_ptr <entry>> entries_;
+            std::vector <std::shared_ptr <entry>> retired_;
+
+            executor                    executor_;
+            std::atomic <bool>          stopped_ {false};
+            std::error_code             error_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Opens a socket bound with SO_REUSEPORT so each reactor in a group can
+    // own its own socket on a shared address; TCP sockets are left listening
+
+    inline socket open_sharded (socket::type kind, socket::address const &local)
+    {
+        socket sock {kind, local.family ()};
+
+        if (sock) sock.set_reuse_address ();
+        if (sock) sock.set_reuse_port ();
+        if (sock) sock.bind (local);
+
+        if (sock && kind == socket::type::TCP)
+            sock.listen (128);
+
+        return sock;
+    }
+
+    //-------------------------------------------------------------------------
+    // One reactor per core, each running on its own thread pinned to its core
+
+    class reactor_group
+    {
+        public:
+            // runs on each reactor's own thread before its loop starts
+            using setup = std::function <void (reactor &, size_t index)>;
+
+        public:
+            explicit reactor_group (size_t count = system::thread::core_count ())
+            {
+                for (size_t i = 0; i < count; ++i)
+                    reactors_.emplace_back (new reactor);
+            }
+
+            ~reactor_group ()
+            {
+                stop ();
+            }
+
+            reactor_group (reactor_group const &) = delete;
+            reactor_group &operator= (reactor_group const &) = delete;
+
+        public:
+            void start (setup init)
+            {
+                for (size_t i = 0; i < reactors_.size (); ++i)
+                {
+                    reactor *r = reactors_[i].get ();
+
+                    threads_.emplace_back (new scoped_thread {std::thread {
+                        [r, i, init] { init (*r, i); r->run (); }}});
+
+                    system::thread::try_set_affinity (threads_.back ()->thread, i);
+                }
+            }
+
+            void stop ()
+            {
+                for (auto &r : reactors_)
+                    r->stop ();
+
+                threads_.clear (); // joins
+            }
+
+        public:
+            size_t size () const { return reactors_.size (); }
+            reactor &operator[] (size_t index) { return *reactors_[index]; }
+
+        private:
+            std::vector <std::unique_ptr <reactor>>         reactors_;
+            std::vector <std::unique_ptr <scoped_thread>>   threads_;
+    };
+
+} } }
+
+#endif
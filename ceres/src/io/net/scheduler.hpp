@@ -0,0 +1,210 @@
+#ifndef _IO_NET_SCHEDULER_HPP_
+#define _IO_NET_SCHEDULER_HPP_
+
+namespace ceres { namespace io { namespace net {
+
+    //=========================================================================
+    // Chooses which entity updates go to each connection per tick. Entities
+    // carry an owner priority and the size of their next update; connections
+    // carry a relevancy per entity and a token bucket of bytes. Each tick an
+    // entity's combined priority (priority x relevancy) is added to its
+    // accumulated priority on every connection, so entities passed over age
+    // upward until sent, when theirs is reset. Selection takes the top of
+    // the accumulated priorities by partial sort, in rounds sized to the
+    // remaining budget, and fills the budget greedily.
+
+    class scheduler
+    {
+        public:
+            typedef uint32_t entity_id;
+            typedef uint32_t connection_id;
+
+        public:
+            scheduler (size_t entities, size_t connections) :
+                priority_ (entities, 0), size_ (entities, 0), connections_ (connections)
+            {
+                for (auto &conn : connections_)
+                {
+                    conn.relevancy.assign (entities, 1);
+                    conn.accumulated.assign (entities, 0);
+                }
+            }
+
+        public:
+            size_t entities () const { return priority_.size (); }
+            size_t connections () const { return connections_.size (); }
+
+            // owner importance; zero when there is nothing to send
+            void set_priority (entity_id entity, float priority) { priority_[entity] = priority; }
+
+            // wire bytes of the entity's next update
+            void set_size (entity_id entity, uint32_t bytes) { size_[entity] = bytes; }
+
+            // observer interest; zero stops the entity being sent to the connection
+            void set_relevancy (connection_id conn, entity_id entity, float relevancy)
+            {
+                connections_[conn].relevancy[entity] = relevancy;
+            }
+
+            // one bit per entity: relevancy one where set, zero where clear
+            void set_relevancy (connection_id conn, memory::buffer <uint64_t const> mask)
+            {
+                auto &relevancy = connections_[conn].relevancy;
+
+                for (entity_id entity = 0; entity < entities (); ++entity)
+                    relevancy[entity] = mask.items[entity / 64] >> (entity % 64) & 1;
+            }
+
+            // refill rate and bucket depth; unsent budget carries up to the depth
+            void set_bandwidth (connection_id conn, double bytes_per_second, double burst_bytes)
+            {
+                connections_[conn].rate = bytes_per_second;
+                connections_[conn].burst = burst_bytes;
+            }
+
+            float accumulated (connection_id conn, entity_id entity) const
+            {
+                return connections_[conn].accumulated[entity];
+            }
+
+            double tokens (connection_id conn) const { return connections_[conn].tokens; }
+
+        public:
+            // refills every bucket by the elapsed time and schedules every connection
+            void tick (double seconds)
+            {
+                for (connection_id conn = 0; conn < connections (); ++conn)
+                    schedule (conn, seconds);
+            }
+
+            void schedule (connection_id id, double seconds)
+            {
+                connection &conn = connections_[id];
+                conn.tokens = std::min (conn.tokens + conn.rate * seconds, conn.burst);
+                conn.selected.clear ();
+
+                // only entities within a margin of the lowest sent last tick are
+                // ranked; the rest are collected too if those can't fill the budget
+                double bytes = collect (conn, conn.cutoff, true);
+
+                if (bytes < conn.tokens && conn.cutoff > 0)
+                    bytes = collect (conn, 0, false);
+
+                if (conn.candidates.empty ())
+                    return;
+
+                auto higher = [] (candidate const &a, candidate const &b)
+                {
+                    return a.accumulated > b.accumulated;
+                };
+
+                double average = std::max (bytes / conn.candidates.size (), 1.0);
+                auto first = conn.candidates.begin (), last = conn.candidates.end ();
+                auto &sizes = size_;
+                float lowest = 0;
+
+                // each round drops what no longer fits, then ranks only as many
+                // as the remaining budget could take
+                while (first != last)
+                {
+                    double tokens = conn.tokens;
+                    last = std::partition (first, last, [&sizes, tokens] (candidate const &c)
+                    {
+                        return sizes[c.entity] <= tokens;
+                    });
+
+                    if (first == last)
+                        break;
+
+                    auto count = std::min <ptrdiff_t> (std::max (tokens / average, 1.0), last - first);
+                    auto middle = first + count;
+
+                    if (middle != last)
+                        std::nth_element (first, middle, last, higher);
+
+                    std::sort (first, middle, higher);
+
+                    for (auto c = first; c != middle; ++c)
+                    {
+                        if (size_[c->entity] > conn.tokens)
+                            continue;
+
+                        conn.tokens -= size_[c->entity];
+                        conn.accumulated[c->entity] = 0;
+                        conn.selected.push_back (c->entity);
+                        lowest = c->accumulated;
+                    }
+
+                    first = middle;
+                }
+
+                conn.cutoff = lowest * cutoff_margin;
+            }
+
+            // entities chosen for the connection by the last tick, highest first
+            memory::buffer <entity_id const> scheduled (connection_id conn) const
+            {
+                auto &selected = connections_[conn].selected;
+                return {selected.data (), selected.size ()};
+            }
+
+        private:
+            struct candidate
+            {
+                float                       accumulated;
+                entity_id                   entity;
+            };
+
+            struct connection
+            {
+                double                      rate = 0;
+                double                      burst = 0;
+                double                      tokens = 0;
+                float                       cutoff = 0;
+
+                std::vector <float>         relevancy;
+                std::vector <float>         accumulated;
+
+                // scratch reused across ticks to avoid reallocation
+                std::vector <candidate>     candidates;
+                std::vector <entity_id>     selected;
+            };
+
+            // gathers relevant entities at or above the cutoff, ageing them
+            // first if asked; returns their total update bytes
+            double collect (connection &conn, float cutoff, bool age)
+            {
+                // branch free: relevancy and the cutoff are unpredictable per entity
+                conn.candidates.resize (entities ());
+                size_t count = 0;
+                uint64_t bytes = 0;
+
+                for (entity_id entity = 0; entity < entities (); ++entity)
+                {
+                    float combined = priority_[entity] * conn.relevancy[entity];
+                    float &accumulated = conn.accumulated[entity];
+                    accumulated += age? combined : 0;
+
+                    bool keep = (combined > 0) & (accumulated >= cutoff);
+                    conn.candidates[count] = {accumulated, entity};
+                    bytes += keep? size_[entity] : 0;
+                    count += keep;
+                }
+
+                conn.candidates.resize (count);
+                return bytes;
+            }
+
+        private:
+            // fraction of last tick's lowest sent priority to rank from
+            constexpr static float cutoff_margin = 0.8f;
+
+        private:
+            std::vector <float>             priority_;
+            std::vector <uint32_t>          size_;
+            std::vector <connection>        connections_;
+    };
+
+} } }
+
+#endif
@@ -29,18 +29,22 @@ namespace ceres { namespace io { namespace net {
             static const handle_type INVALID = system::socket::INVALID;
 
             enum class type { NONE, TCP, UDP }; // TODO: VDP et al.
+            enum class family { NONE, INET4, INET6 };
 
             class address
             {
                 public:
                     using native_type = system::socket::address_type;
 
+                    // longest formatted address: "[v6]:port" plus terminator
+                    constexpr static size_t max_string_size = INET6_ADDRSTRLEN + 8;
+
                 public:
                     address ()
                     {
                         std::memset (&address_, 0, sizeof (address_));
-                        address_.sin_family = AF_INET;
-                        error_ = std::errc::bad_address;
+                        address_.ss_family = AF_UNSPEC;
+                        error_ = std::make_error_code (std::errc::bad_address);
                     }
 
                     address (address const &other) = default;
@@ -48,30 +52,54 @@ namespace ceres { namespace io { namespace net {
                     ~address () = default;
 
                 public:
-                    address (std::string const &addr)
+                    // parses without allocating: "a.b.c.d[:port]", "[v6][:port]" or "v6"
+                    address (char const *str, size_t length) : address {}
                     {
-                        if (!system::socket::try_string_to_inet4 (addr, address_))
+                        if (system::socket::try_parse_address (str, length, address_))
+                            error_.clear ();
+                        else
                             system::load_last_error_code (error_);
                     }
 
+                    address (char const *str) : 
+                        address {str, std::strlen (str)} {}
+
+                    address (std::string const &str) : 
+                        address {str.data (), str.size ()} {}
+
+                    // formats into the caller's buffer; returns length, 0 on failure
+                    size_t format (char *str, size_t size) const
+                    {
+                        size_t length = 0;
+                        system::socket::try_format_address (address_, str, size, length);
+                        return length;
+                    }
+
                     operator std::string () const 
                     {
-                        std::string result;
-                        system::socket::try_inet4_to_string (address_, result);
-                        return result;
+                        char str [max_string_size];
+                        return {str, format (str, sizeof (str))};
                     }
 
-                    operator sockaddr* () 
+                    // explicit so that a non-const address tests via operator bool
+                    explicit operator sockaddr* () 
                     { 
                         return reinterpret_cast<sockaddr *> (&address_); 
                     }
 
-                    operator sockaddr const* () const
+                    explicit operator sockaddr const* () const
                     { 
                         return reinterpret_cast<sockaddr const *> (&address_); 
                     }
 
+                    // size of the address held, for calls that read an address
                     size_type sockaddr_size () const
+                    {
+                        return system::socket::address_size (address_);
+                    }
+
+                    // size of the storage, for calls that write an address
+                    size_type sockaddr_capacity () const
                     {
                         return sizeof (address_);
                     }
@@ -81,14 +109,31 @@ namespace ceres { namespace io { namespace net {
                     std::error_code error () const { return error_; }
 
                 public:
+                    socket::family family () const
+                    {
+                        switch (address_.ss_family)
+                        {
+                            case AF_INET: return family::INET4;
+                            case AF_INET6: return family::INET6;
+                            default: return family::NONE;
+                        }
+                    }
+
                     bool has_same_port (address const &other) const
                     {
-                        return address_.sin_port == other.address_.sin_port;
+                        return port () == other.port ();
                     }
 
                     bool has_same_host (address const &other) const
                     {
-                        return address_.sin_addr.s_addr == other.address_.sin_addr.s_addr;
+                        if (address_.ss_family != other.address_.ss_family)
+                            return false;
+
+                        if (address_.ss_family == AF_INET6)
+                            return std::memcmp (&inet6 ().sin6_addr, &other.inet6 ().sin6_addr, 
+                                    sizeof (in6_addr)) == 0;
+
+                        return inet4 ().sin_addr.s_addr == other.inet4 ().sin_addr.s_addr;
                     }
 
                     bool operator== (address const &other) const 
@@ -96,12 +141,78 @@ namespace ceres { namespace io { namespace net {
                         return has_same_port (other) && has_same_host (other);
                     }
 
+                    bool operator!= (address const &other) const 
+                    {
+                        return !(*this == other);
+                    }
+
                 public:
-                    uint16_t port () const { return ntohs (address_.sin_port); }
-                    void set_port (uint16_t port) { address_.sin_port = htons (port); }
+                    // hashes family, port and host; keys flat peer tables per packet
+                    uint32_t hash () const
+                    {
+                        uint8_t key [2 + 2 + sizeof (in6_addr)] = {};
+                        size_t length = 4;
+
+                        uint16_t fam = address_.ss_family, net_port = htons (port ());
+                        std::memcpy (key, &fam, 2);
+                        std::memcpy (key + 2, &net_port, 2);
+
+                        if (address_.ss_family == AF_INET6)
+                            std::memcpy (key + 4, &inet6 ().sin6_addr, sizeof (in6_addr)), 
+                                length += sizeof (in6_addr);
+                        else if (address_.ss_family == AF_INET)
+                            std::memcpy (key + 4, &inet4 ().sin_addr, sizeof (in_addr)), 
+                                length += sizeof (in_addr);
+
+                        return core::crc32c_hash (key, length);
+                    }
+
+                    struct hasher
+                    {
+                        size_t operator() (address const &addr) const { return addr.hash (); }
+                    };
+
+                public:
+                    uint16_t port () const 
+                    { 
+                        return ntohs (address_.ss_family == AF_INET6? 
+                                inet6 ().sin6_port : inet4 ().sin_port); 
+                    }
+
+                    void set_port (uint16_t port) 
+                    { 
+                        if (address_.ss_family == AF_INET6)
+                            inet6 ().sin6_port = htons (port);
+                        else
+                            inet4 ().sin_port = htons (port); 
+                    }
+
+                    // IPv4 host only
+                    uint32_t host () const 
+                    { 
+                        ASSERTF (address_.ss_family == AF_INET, "not an IPv4 address");
+                        return ntohl (inet4 ().sin_addr.s_addr); 
+                    }
 
-                    uint32_t host () const { return ntohl (address_.sin_addr.s_addr); }
-                    void set_host (uint32_t host) { address_.sin_addr.s_addr = htonl (host); }
+                    void set_host (uint32_t host) 
+                    { 
+                        address_.ss_family = AF_INET;
+                        inet4 ().sin_addr.s_addr = htonl (host); 
+                    }
+
+                private:
+                    sockaddr_in &inet4 () { return reinterpret_cast <sockaddr_in &> (address_); }
+                    sockaddr_in6 &inet6 () { return reinterpret_cast <sockaddr_in6 &> (address_); }
+
+                    sockaddr_in const &inet4 () const 
+                    { 
+                        return reinterpret_cast <sockaddr_in const &> (address_); 
+                    }
+
+                    sockaddr_in6 const &inet6 () const 
+                    { 
+                        return reinterpret_cast <sockaddr_in6 const &> (address_); 
+                    }
 
                 private:
                     native_type     address_;
@@ -110,33 +221,45 @@ namespace ceres { namespace io { namespace net {
 
         public:
             socket () = default;
-            socket (socket const &other) = default;
-            socket &operator= (socket const &socket) = default;
 
-            socket (socket &&other) :
-                socket {other} 
+            // handles are uniquely owned: copies would double-close
+            socket (socket const &other) = delete;
+            socket &operator= (socket const &socket) = delete;
+
+            socket (socket &&other) noexcept :
+                handle_ {other.handle_}, type_ {other.type_}, error_ {other.error_}
             { 
                 other.invalidate (); 
             }
 
-            socket &operator= (socket &&other) 
+            socket &operator= (socket &&other) noexcept
             {
-                *this = other;
-                other.invalidate ();
+                if (this != &other)
+                {
+                    close ();
+                    handle_ = other.handle_;
+                    type_ = other.type_;
+                    error_ = other.error_;
+                    other.invalidate ();
+                }
+
+                return *this;
             }
 
-            socket (type kind) { open (kind); }
+            socket (type kind, family fam = family::INET4) { open (kind, fam); }
             ~socket () { close (); }
 
         public:
             void invalidate () { handle_ = INVALID; }
             socket::type get_type () const { return type_; }
+            handle_type handle () const { return handle_; }
 
         public:
-            std::error_code open (type kind)
+            // an INET6 socket is dual-stack unless set_v6_only is called before bind
+            std::error_code open (type kind, family fam = family::INET4)
             {
                 int sockfam, socktype, sockproto;
-                map_socket_type (kind, sockfam, socktype, sockproto);
+                map_socket_type (kind, fam, sockfam, socktype, sockproto);
                 type_ = kind;
 
                 if (!system::socket::try_open (sockfam, socktype, sockproto, handle_))
@@ -147,6 +270,9 @@ namespace ceres { namespace io { namespace net {
 
             std::error_code close ()
             {
+                if (handle_ == INVALID)
+                    return error_;
+
                 if (!system::socket::try_close (handle_))
                     system::load_last_error_code (error_);
 
@@ -188,22 +314,160 @@ namespace ceres { namespace io { namespace net {
 
             std::error_code accept (socket &accepted)
             {
+                std::error_code result;
                 address remote;
                 auto addr = (sockaddr *) remote;
-                auto size = remote.sockaddr_size ();
+                auto size = remote.sockaddr_capacity ();
 
                 if (!system::socket::try_accept (handle_, addr, size, accepted.handle_))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+        public:
+            std::error_code set_nonblocking (bool enable = true)
+            {
+                if (!system::socket::try_set_nonblocking (handle_, enable))
+                    system::load_last_error_code (error_);
+
+                return error_;
+            }
+
+            std::error_code set_reuse_address (bool enable = true)
+            {
+                if (!system::socket::try_set_reuse_address (handle_, enable))
+                    system::load_last_error_code (error_);
+
+                return error_;
+            }
+
+            std::error_code set_v6_only (bool enable = true)
+            {
+                if (!system::socket::try_set_v6_only (handle_, enable))
+                    system::load_last_error_code (error_);
+
+                return error_;
+            }
+
+            // lets sockets in several threads bind one address; the kernel shards
+            // incoming connections and datagrams between them
+            std::error_code set_reuse_port (bool enable = true)
+            {
+                if (!system::socket::try_set_reuse_port (handle_, enable))
                     system::load_last_error_code (error_);
 
                 return error_;
             }
 
+        public:
+            // On non-blocking sockets would_block is returned rather than recorded 
+            // in error (), since it only means the operation should be retried 
+
+            std::error_code send (memory::bytebuffer const &buf, size_t &sent)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_send (handle_, buf.pointer, buf.bytes, sent))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            std::error_code receive (memory::bytebuffer const &buf, size_t &received)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_receive (handle_, buf.items, buf.bytes, received))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            std::error_code send_to (memory::bytebuffer const &buf, address const &remote, size_t &sent)
+            {
+                std::error_code result;
+                auto addr = (sockaddr const *) remote;
+                auto size = remote.sockaddr_size ();
+
+                if (!system::socket::try_send_to (handle_, buf.pointer, buf.bytes, addr, size, sent))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            std::error_code receive_from (memory::bytebuffer const &buf, address &remote, size_t &received)
+            {
+                std::error_code result;
+                auto addr = (sockaddr *) remote;
+                auto size = remote.sockaddr_capacity ();
+
+                if (!system::socket::try_receive_from (handle_, buf.items, buf.bytes, addr, size, received))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            // Batched datagram calls: one system call for many messages; see
+            // io::net::datagram_ring for preallocated message storage
+
+            using message_type = system::socket::message_type;
+
+            std::error_code send_batch (memory::buffer<message_type> const &messages, size_t &sent)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_send_batch (handle_, messages.items, size (messages), sent))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            std::error_code receive_batch (memory::buffer<message_type> const &messages, size_t &received)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_receive_batch (handle_, messages.items, size (messages), received))
+                    system::load_last_error_code (result);
+
+                return track (result);
+            }
+
+            // Optional offloads: an error means the kernel lacks support and 
+            // is not recorded in error (); the socket stays usable without it
+
+            std::error_code set_udp_segment (uint16_t segment)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_set_udp_segment (handle_, segment))
+                    system::load_last_error_code (result);
+
+                return result;
+            }
+
+            std::error_code set_udp_gro (bool enable = true)
+            {
+                std::error_code result;
+
+                if (!system::socket::try_set_udp_gro (handle_, enable))
+                    system::load_last_error_code (result);
+
+                return result;
+            }
+
+            static bool would_block (std::error_code const &error)
+            {
+                return error == std::errc::operation_would_block || 
+                    error == std::errc::resource_unavailable_try_again;
+            }
+
         public:
             address local_address ()
             {
                 address local;
                 auto addr = (sockaddr *) local;
-                auto size = local.sockaddr_size ();
+                auto size = local.sockaddr_capacity ();
 
                 if (!system::socket::try_get_local_address (handle_, addr, size))
                     system::load_last_error_code (error_);
@@ -215,7 +479,7 @@ namespace ceres { namespace io { namespace net {
             {
                 address remote;
                 auto addr = (sockaddr *) remote;
-                auto size = remote.sockaddr_size ();
+                auto size = remote.sockaddr_capacity ();
 
                 if (!system::socket::try_get_remote_address (handle_, addr, size))
                     system::load_last_error_code (error_);
@@ -228,18 +492,26 @@ namespace ceres { namespace io { namespace net {
             std::error_code error () const { return error_; }
 
         private:
-            void map_socket_type (type kind, int &sockfam, int &socktype, int &sockprot)
+            std::error_code track (std::error_code const &result)
+            {
+                if (result && !would_block (result))
+                    error_ = result;
+
+                return result;
+            }
+
+            void map_socket_type (type kind, family fam, int &sockfam, int &socktype, int &sockprot)
             {
+                sockfam = (fam == family::INET6)? AF_INET6 : AF_INET;
+
                 switch (kind)
                 {
                     case type::TCP:
-                        sockfam = AF_INET;
                         socktype = SOCK_STREAM;
                         sockprot = IPPROTO_TCP;
                         break;
 
                     case type::UDP:
-                        sockfam = AF_INET;
                         socktype = SOCK_DGRAM;
                         sockprot = IPPROTO_UDP;
                         break;
@@ -7,13 +7,21 @@
 #include <core/bits.hpp>
 #include <memory/core.hpp>
 #include <core/hash.hpp>
+#include <core/name_table.hpp>
 #include <core/name.hpp>
 #include <core/container.hpp>
 #include <state/state.hpp>
+#include <state/machine_array.hpp>
+#include <entity/store.hpp>
+#include <entity/transaction.hpp>
+#include <entity/page.hpp>
+#include <entity/history.hpp>
+#include <entity/replica.hpp>
 
 #include <memory/layout.hpp>
 #include <io/file/chunk.hpp>
 #include <io/file/format.hpp>
+#include <io/file/archive.hpp>
 #include <data/endian.hpp>
 #include <data/encoding/bit.hpp>
 #include <data/map.hpp>
@@ -21,9 +29,27 @@
 
 #include <policy/data/mapper.hpp>
 #include <core/stream.hpp>
+#include <data/schema.hpp>
 
 #include <system/platform.hpp>
+#include <io/file/mapping.hpp>
+#include <memory/allocation.hpp>
+#include <memory/arena.hpp>
+#include <memory/frame.hpp>
+#include <memory/epoch.hpp>
+#include <entity/snapshot.hpp>
 #include <io/net/socket.hpp>
+#include <io/net/reactor.hpp>
+#include <io/net/datagram.hpp>
+#include <io/net/completion.hpp>
+#include <io/net/message.hpp>
+#include <io/net/nexus.hpp>
+#include <io/net/scheduler.hpp>
+#include <io/net/interest.hpp>
+#include <task/pool.hpp>
+#include <task/graph.hpp>
+#include <event/stream.hpp>
+#include <event/pipeline.hpp>
 
 // TODO: per-namespace meta-include file
 
@@ -143,6 +169,18 @@ int main (int argc, char **argv)
         file.close();
     }
 
+    io::file::mapping mapped ("test.txt");
+
+    if (mapped)
+    {
+        io::file::format::ini_reader reader {mapped.text ()};
+        data::file::heap_description descr;
+
+        while (descr.read (reader))
+            cout << descr.name << " " << descr.page_size << " " 
+                << descr.min_pages << " " << descr.max_pages << endl;
+    }
+
     state::singular_machine <State1, State2, State3> machine;
     machine.react (1);
     machine.react (2);
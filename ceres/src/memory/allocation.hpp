@@ -0,0 +1,173 @@
+#ifndef MEMORY_ALLOCATION_HPP_
+#define MEMORY_ALLOCATION_HPP_
+
+namespace ceres { namespace memory {
+
+    //=========================================================================
+    // Owned storage for the buffer views in memory/core: cache line aligned 
+    // heap blocks for small buffers, page mappings for large ones, with a
+    // transparent huge page hint when the size warrants it. Storage is
+    // uninitialized on the heap and zeroed in pages, so only trivial types.
+
+    constexpr size_t cache_line_size = 64;
+
+    enum class placement { heap, pages, huge_pages };
+
+    template <typename Type>
+    class unique_buffer
+    {
+        static_assert (std::is_trivial <Type>::value, "storage is not constructed");
+
+        public:
+            unique_buffer () = default;
+            unique_buffer (unique_buffer const &) = delete;
+            unique_buffer &operator= (unique_buffer const &) = delete;
+
+            unique_buffer (unique_buffer &&other) :
+                data_ {other.data_}, count_ {other.count_}, bytes_ {other.bytes_}, 
+                placement_ {other.placement_}, error_ {other.error_}
+            {
+                other.invalidate ();
+            }
+
+            unique_buffer &operator= (unique_buffer &&other)
+            {
+                if (this != &other)
+                {
+                    release ();
+
+                    data_ = other.data_;
+                    count_ = other.count_;
+                    bytes_ = other.bytes_;
+                    placement_ = other.placement_;
+                    error_ = other.error_;
+                    other.invalidate ();
+                }
+
+                return *this;
+            }
+
+            unique_buffer (size_t count, size_t alignment, memory::placement where) 
+            { 
+                allocate (count, alignment, where); 
+            }
+
+            ~unique_buffer () { release (); }
+
+        public:
+            void invalidate () { data_ = nullptr; count_ = bytes_ = 0; }
+
+            Type *data () const { return data_; }
+            size_t size () const { return count_; }
+            memory::placement placement () const { return placement_; }
+
+            buffer<Type> view () const { return {data_, count_}; }
+
+            // the largest power of two prefix, for mask-indexed rings
+            pow2_size_buffer<Type> pow2_view () const { return {data_, count_}; }
+
+            operator buffer<Type> () const { return view (); }
+
+        public:
+            std::error_code allocate (size_t count, size_t alignment, memory::placement where)
+            {
+                release ();
+                error_.clear ();
+
+                size_t bytes = count * sizeof (Type);
+                void *data = nullptr;
+                bool success = true;
+
+                if (where == memory::placement::heap)
+                {
+                    alignment = std::max (alignment, sizeof (void *));
+                    success = system::pages::try_allocate (bytes, alignment, data);
+                }
+                else
+                {
+                    // huge pages only back whole, aligned huge page ranges
+                    size_t huge = system::pages::huge_page_size ();
+                    bool hint = where == memory::placement::huge_pages && huge && bytes >= huge;
+
+                    if (hint)
+                    {
+                        bytes = (bytes + huge - 1) & ~(huge - 1);
+                        alignment = std::max (alignment, huge);
+                    }
+
+                    success = system::pages::try_map (bytes, alignment, data);
+
+                    if (success && hint)
+                        system::pages::try_advise_huge (data, bytes);
+                }
+
+                if (success)
+                {
+                    data_ = static_cast <Type *> (data);
+                    count_ = count;
+                    bytes_ = bytes;
+                    placement_ = where;
+                }
+                else
+                    system::load_last_error_code (error_);
+
+                return error_;
+            }
+
+            void release ()
+            {
+                void *data = data_;
+
+                if (data && placement_ == memory::placement::heap)
+                    system::pages::deallocate (data);
+                else if (data)
+                    system::pages::try_unmap (data, bytes_);
+
+                invalidate ();
+            }
+
+        public:
+            operator bool () const { return !error_ && data_; }
+            std::error_code error () const { return error_; }
+
+        private:
+            Type               *data_ = nullptr;
+            size_t              count_ = 0;
+            size_t              bytes_ = 0;
+            memory::placement   placement_ = memory::placement::heap;
+            std::error_code     error_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Factories; failures are reported through the buffer's error ()
+
+    // cache line aligned, from the heap
+    template <typename Type>
+    unique_buffer<Type> allocate_aligned (size_t count, size_t alignment = cache_line_size)
+    {
+        return {count, alignment, placement::heap};
+    }
+
+    // page aligned and zeroed; huge pages are hinted for buffers of a huge
+    // page or more, whose size is then rounded up to whole huge pages
+    template <typename Type>
+    unique_buffer<Type> allocate_pages (size_t count, bool huge = true)
+    {
+        return {count, 0, huge? placement::huge_pages : placement::pages};
+    }
+
+    // count rounded up to a power of two, so the whole of it is a 
+    // pow2_size_buffer; large rings get pages
+    template <typename Type>
+    unique_buffer<Type> allocate_pow2 (size_t count, size_t alignment = cache_line_size)
+    {
+        count = count > 1? size_t (1) << core::bit::log2_ceil (count) : 1;
+
+        return (count * sizeof (Type) >= system::pages::page_size ())?
+            unique_buffer<Type> {count, alignment, placement::huge_pages} :
+            unique_buffer<Type> {count, alignment, placement::heap};
+    }
+
+} }
+
+#endif
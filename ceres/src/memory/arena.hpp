@@ -0,0 +1,104 @@
+#ifndef MEMORY_ARENA_HPP_
+#define MEMORY_ARENA_HPP_
+
+namespace ceres { namespace memory {
+
+    //=========================================================================
+    // Bump allocator over a chain of blocks, for storage that all dies at
+    // once. Nothing is freed singly; reset rewinds to the first block in
+    // constant time and keeps every block for reuse, so an arena reset each
+    // frame stops allocating once it has grown to the frame's peak. Without
+    // chaining the arena is its first block alone, and fails past it rather
+    // than take more from the heap. Not thread safe: give each thread its own.
+
+    class arena
+    {
+        public:
+            explicit arena (size_t block_size = 64 * 1024, bool chained = true) :
+                block_size_ {block_size}, chained_ {chained} {}
+
+            arena (arena const &) = delete;
+            arena &operator= (arena const &) = delete;
+
+        public:
+            // null when the heap is exhausted, or unchained and full
+            void *allocate (size_t bytes, size_t alignment = alignof (std::max_align_t))
+            {
+                ASSERTF (core::bit::is_power_2 (alignment), "alignment is not a power of two");
+
+                while (true)
+                {
+                    if (block_ < blocks_.size ())
+                    {
+                        auto &block = blocks_[block_];
+                        size_t address = reinterpret_cast <size_t> (block.data ()) + offset_;
+                        size_t padding = (alignment - address % alignment) % alignment;
+
+                        if (offset_ + padding + bytes <= block.size ())
+                        {
+                            offset_ += padding + bytes;
+                            used_ += padding + bytes;
+                            return reinterpret_cast <void *> (address + padding);
+                        }
+
+                        // unchained, the block stays usable for smaller requests
+                        if (!chained_)
+                            return nullptr;
+
+                        // later blocks may be the oversized ones
+                        ++block_;
+                        offset_ = 0;
+                        continue;
+                    }
+
+                    if (!chained_ && !blocks_.empty ())
+                        return nullptr;
+
+                    size_t size = chained_? std::max (block_size_, bytes + alignment) : block_size_;
+                    blocks_.push_back (allocate_aligned <char> (size));
+
+                    if (!blocks_.back ())
+                    {
+                        blocks_.pop_back ();
+                        return nullptr;
+                    }
+                }
+            }
+
+            template <typename Type>
+            Type *allocate_array (size_t count)
+            {
+                return static_cast <Type *> (allocate (count * sizeof (Type), alignof (Type)));
+            }
+
+            void reset ()
+            {
+                block_ = offset_ = used_ = 0;
+            }
+
+        public:
+            // bytes handed out since the last reset, padding included
+            size_t used () const { return used_; }
+
+            size_t capacity () const
+            {
+                size_t total = 0;
+
+                for (auto &block : blocks_)
+                    total += block.size ();
+
+                return total;
+            }
+
+        private:
+            std::vector <unique_buffer <char>>      blocks_;
+            size_t                                  block_size_;
+            bool                                    chained_;
+            size_t                                  block_ = 0;
+            size_t                                  offset_ = 0;
+            size_t                                  used_ = 0;
+    };
+
+} }
+
+#endif
@@ -37,6 +37,7 @@ namespace ceres
                     using value_type = ConcreteType;
 
                 public:
+                    // layers pass these up from the terminal allocator
                     using propagate_on_container_copy_assignment = 
                         typename Composite::propagate_on_container_copy_assignment;
 
@@ -19,6 +19,12 @@
 //                     memory::allocator::static_buffer<N>>, 
 //                 typename core::min_word_size<N-1>::type>>, 
 //         typename std::map<K,V>::value_type>;
+//
+// template <typename T>
+// using frame_allocator = 
+//     memory::allocator::concrete<
+//         memory::allocator::compat<
+//             memory::allocator::frame>, T>;
 
 namespace ceres
 {
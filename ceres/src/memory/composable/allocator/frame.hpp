@@ -0,0 +1,83 @@
+#ifndef _FRAME_ALLOCATOR_HPP_
+#define _FRAME_ALLOCATOR_HPP_
+
+namespace ceres
+{
+    namespace memory
+    {
+        namespace allocator
+        {
+            //=========================================================================
+            // Implements per-frame bump allocation from the thread's frame arena
+            // * Deallocation does nothing; storage dies two flips after it was taken
+            // * Containers must be used on one thread, and gone by then
+            // Fulfills stateful allocator concept
+            // Fulfills composable allocator concept
+            // Fulfills terminal allocator concept
+
+            namespace impl
+            {
+                template <typename Base, typename State, typename Type>
+                class frame : public Base
+                {
+                    public:
+                        // default constructor
+                        frame () :
+                            Base {} {}
+
+                        // copy constructor
+                        frame (frame const &copy) :
+                            Base {copy} {}
+
+                        // stateful constructor
+                        explicit frame (State const &state) :
+                            Base {state} {}
+
+                        // destructor
+                        ~frame () {}
+
+                    public:
+                        // max available to allocate
+                        size_t max_size () const
+                        {
+                            return std::numeric_limits <size_t>::max () / sizeof (Type);
+                        }
+
+                        // allocate number of items
+                        Type *allocate (size_t num, const void* = 0)
+                        {
+                            Type *items = frame_arena::local ().allocate_array <Type> (num);
+                            ASSERTF (items != nullptr, "frame arena exhausted");
+
+                            return items;
+                        }
+
+                        // deallocate number of items
+                        void deallocate (Type *ptr, size_t num)
+                        {
+                        }
+
+                    public:
+                        // all draw on the same thread's arena
+                        bool operator== (frame const &other) const { return true; }
+                        bool operator!= (frame const &other) const { return false; }
+                };
+            }
+
+            struct frame
+            {
+                template <typename T>
+                using state_type = basic_state<T>;
+
+                template <typename S, typename T>
+                using concrete_type = impl::frame <get_concrete_type <terminal, S, T>, S, T>;
+
+                using propagate_on_container_copy_assignment = std::false_type;
+                using propagate_on_container_move_assignment = std::false_type;
+                using propagate_on_container_swap = std::false_type;
+            };
+        }
+    }
+}
+
+#endif
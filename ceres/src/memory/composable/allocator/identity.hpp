@@ -62,9 +62,9 @@ namespace ceres
                 template <typename S, typename T>
                 using concrete_type = impl::identity <get_concrete_type <Base, S, T>, S, T>;
                 
-                using propagate_on_container_copy_assignment = std::true_type;
-                using propagate_on_container_move_assignment = std::true_type;
-                using propagate_on_container_swap = std::true_type;
+                using propagate_on_container_copy_assignment = typename Base::propagate_on_container_copy_assignment;
+                using propagate_on_container_move_assignment = typename Base::propagate_on_container_move_assignment;
+                using propagate_on_container_swap = typename Base::propagate_on_container_swap;
             };
         }
     }
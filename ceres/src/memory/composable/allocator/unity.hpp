@@ -126,9 +126,9 @@ namespace ceres
                 template <typename S, typename T>
                 using concrete_type = impl::unity <get_concrete_type <Base, S, impl::block<Index,T>>, S, T, Index>;
             
-                using propagate_on_container_copy_assignment = std::true_type;
-                using propagate_on_container_move_assignment = std::true_type;
-                using propagate_on_container_swap = std::true_type;
+                using propagate_on_container_copy_assignment = typename Base::propagate_on_container_copy_assignment;
+                using propagate_on_container_move_assignment = typename Base::propagate_on_container_move_assignment;
+                using propagate_on_container_swap = typename Base::propagate_on_container_swap;
             };
         }
     }
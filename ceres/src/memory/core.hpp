@@ -63,13 +63,13 @@ namespace ceres { namespace memory {
         buffer (Type *begin, Type *end) :
             items {begin}, bytes {(end - begin) * sizeof (Type)} 
         {
-            ASSERTF (end < begin, "invalid range passed");
+            ASSERTF (begin <= end, "invalid range passed");
         }
 
         buffer (void const *begin, void const *end) :
-            items {begin}, bytes {(uintptr_t) end - (uintptr_t) begin} 
+            pointer {begin}, bytes {(uintptr_t) end - (uintptr_t) begin} 
         {
-            ASSERTF (end < begin, "invalid range passed");
+            ASSERTF (begin <= end, "invalid range passed");
         }
 
         template <typename U>
@@ -78,7 +78,7 @@ namespace ceres { namespace memory {
 
         template <typename U, size_t N>
         buffer (static_buffer<U, N> const &copy) :
-            pointer {copy.pointer, N / sizeof (U)} {}
+            buffer {static_cast <void const *> (copy.items), N * sizeof (U)} {}
 
         operator bool () const { return pointer != nullptr; }
         size_t size () const { return bytes / sizeof (Type); }
@@ -214,7 +214,7 @@ namespace ceres { namespace memory {
     inline size_t aligned_offset (void const *pointer, uintptr_t alignment)
     {
         auto p = reinterpret_cast <uintptr_t const> (pointer);
-        return reinterpret_cast <size_t> (p & (alignment-1));
+        return p & (alignment-1);
     }
 
     template <typename Type>
@@ -226,7 +226,7 @@ namespace ceres { namespace memory {
     inline size_t aligned_overhead (void const *pointer, uintptr_t alignment)
     {
         auto p = reinterpret_cast <uintptr_t const> (pointer);
-        return reinterpret_cast <size_t> ((alignment - (p & alignment-1)) & alignment-1);
+        return (alignment - (p & (alignment-1))) & (alignment-1);
     }
 
     template <typename Type>
@@ -249,14 +249,15 @@ namespace ceres { namespace memory {
 
     // aligned buffer =========================================================
 
-    template <typename U, typename Type>
-    buffer<U> make_aligned_buffer (buffer<Type> const &buf, uintptr_t alignment)
+    // the aligned part of buf; empty if buf is too small to reach alignment
+    template <typename Type>
+    buffer<Type> make_aligned_buffer (buffer<Type> const &buf, uintptr_t alignment)
     {
-        auto pointer = next_aligned<void const *> (buf.pointer, alignment);
         auto overhead = aligned_overhead (buf.pointer, alignment);
-        auto bytes = (count_bytes (buf) > overhead)? count_bytes (buf) - overhead : 0;
+        auto bytes = (buf.bytes > overhead)? buf.bytes - overhead : 0;
+        auto pointer = static_cast <uint8_t const *> (buf.pointer) + (bytes? overhead : 0);
 
-        return {pointer, bytes};
+        return {static_cast <void const *> (pointer), bytes};
     }
 
     template <typename Type, uintptr_t Alignment>
@@ -282,10 +283,12 @@ namespace ceres { namespace memory {
 
     // power size buffer ======================================================
     
+    // the largest power of two prefix of buf, so indices wrap with a mask
     template <typename Type>
     buffer<Type> make_pow2_size_buffer (buffer<Type> const &buf)
     {
-        return {buf.items, 1 << core::bit::log2_floor (buf.size ())};
+        size_t items = buf.size ()? size_t (1) << core::bit::log2_floor (buf.size ()) : 0;
+        return {buf.items, items};
     }
 
     template <typename Type>
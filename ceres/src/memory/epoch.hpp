@@ -0,0 +1,215 @@
+#ifndef MEMORY_EPOCH_HPP_
+#define MEMORY_EPOCH_HPP_
+
+namespace ceres { namespace memory {
+
+    //=========================================================================
+    // Epoch based reclamation for read-copy-update. Readers announce the
+    // global epoch in their own slot on entering a read section and clear it
+    // on leaving: a store and a fence, no read-modify-write. Writers unlink
+    // old versions and retire them at the current epoch. The epoch advances
+    // once every reader inside a section has announced it, and what was
+    // retired two epochs back can then no longer be seen and is freed.
+
+    class epoch_domain
+    {
+        public:
+            explicit epoch_domain (size_t readers = 64) :
+                slots_ {new slot [readers]}, capacity_ {readers} {}
+
+            ~epoch_domain ()
+            {
+                for (auto &item : retired_)
+                    item.deleter (item.pointer);
+            }
+
+            epoch_domain (epoch_domain const &) = delete;
+            epoch_domain &operator= (epoch_domain const &) = delete;
+
+        public:
+            //-----------------------------------------------------------------
+            // A reading thread's slot, claimed for its lifetime; claiming more
+            // than the domain was made for aborts
+
+            class reader
+            {
+                public:
+                    explicit reader (epoch_domain &domain) :
+                        domain_ (domain), slot_ {domain.claim ()} {}
+
+                    ~reader ()
+                    {
+                        ASSERTF (depth_ == 0, "reader destroyed inside a read section");
+                        domain_.slots_[slot_].owned.store (false, std::memory_order_release);
+                    }
+
+                    reader (reader const &) = delete;
+                    reader &operator= (reader const &) = delete;
+
+                public:
+                    // sections nest; only the outermost announces
+                    void lock ()
+                    {
+                        if (depth_++ == 0)
+                        {
+                            // acquire: seeing an epoch means seeing what was
+                            // unlinked before it began
+                            auto &announced = domain_.slots_[slot_].epoch;
+                            announced.store (domain_.epoch_.load (std::memory_order_acquire), std::memory_order_relaxed);
+
+                            // orders the announcement before any pointer read
+                            std::atomic_thread_fence (std::memory_order_seq_cst);
+                        }
+                    }
+
+                    void unlock ()
+                    {
+                        ASSERTF (depth_ > 0, "unlock outside a read section");
+
+                        if (--depth_ == 0)
+                            domain_.slots_[slot_].epoch.store (quiescent, std::memory_order_release);
+                    }
+
+                private:
+                    epoch_domain           &domain_;
+                    size_t                  slot_;
+                    size_t                  depth_ = 0;
+            };
+
+            // read section for a scope
+            class guard
+            {
+                public:
+                    explicit guard (reader &owner) : owner_ (owner) { owner_.lock (); }
+                    ~guard () { owner_.unlock (); }
+
+                    guard (guard const &) = delete;
+                    guard &operator= (guard const &) = delete;
+
+                private:
+                    reader                 &owner_;
+            };
+
+        public:
+            uint64_t epoch () const { return epoch_.load (std::memory_order_relaxed); }
+
+            // frees pointer with deleter once no reader can hold it; call
+            // after unlinking it
+            void retire (void *pointer, void (*deleter) (void *))
+            {
+                std::lock_guard <std::mutex> lock {mutex_};
+                retired_.push_back ({pointer, deleter, epoch_.load (std::memory_order_seq_cst)});
+            }
+
+            template <typename Type>
+            void retire (Type *pointer)
+            {
+                retire (pointer, [] (void *item) { delete static_cast <Type *> (item); });
+            }
+
+            // advances the epoch if every reader has caught up, and frees what
+            // is safe; returns how many were freed. Never waits on readers.
+            size_t collect ()
+            {
+                std::vector <retired> expired;
+
+                {
+                    std::lock_guard <std::mutex> lock {mutex_};
+                    advance ();
+
+                    uint64_t current = epoch_.load (std::memory_order_relaxed);
+                    auto safe = std::partition (retired_.begin (), retired_.end (),
+                            [current] (retired const &item) { return item.epoch + 2 > current; });
+
+                    expired.assign (safe, retired_.end ());
+                    retired_.erase (safe, retired_.end ());
+                }
+
+                for (auto &item : expired)
+                    item.deleter (item.pointer);
+
+                return expired.size ();
+            }
+
+            // waits until everything retired so far is freed
+            void synchronize ()
+            {
+                while (pending ())
+                {
+                    if (!collect ())
+                        std::this_thread::yield ();
+                }
+            }
+
+            size_t pending () const
+            {
+                std::lock_guard <std::mutex> lock {mutex_};
+                return retired_.size ();
+            }
+
+        private:
+            constexpr static uint64_t quiescent = 0;
+
+            // padded so readers don't share a line
+            struct slot
+            {
+                std::atomic <uint64_t>      epoch {quiescent};
+                std::atomic <bool>          owned {false};
+                char                        padding [cache_line_size - 2 * sizeof (uint64_t)];
+            };
+
+            struct retired
+            {
+                void                       *pointer;
+                void                      (*deleter) (void *);
+                uint64_t                    epoch;
+            };
+
+        private:
+            size_t claim ()
+            {
+                for (size_t index = 0; index < capacity_; ++index)
+                {
+                    bool owned = false;
+
+                    if (slots_[index].owned.compare_exchange_strong (owned, true, std::memory_order_acquire))
+                        return index;
+                }
+
+                // sharing a slot would let one reader leaving clear the epoch
+                // another still reads under, so running out fails in every build
+                std::fprintf (stderr, "*** epoch domain: all %zu reader slots are claimed\n", capacity_);
+                std::abort ();
+            }
+
+            // with the mutex held
+            void advance ()
+            {
+                uint64_t current = epoch_.load (std::memory_order_relaxed);
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+
+                for (size_t index = 0; index < capacity_; ++index)
+                {
+                    uint64_t announced = slots_[index].epoch.load (std::memory_order_acquire);
+
+                    if (announced != quiescent && announced != current)
+                        return;
+                }
+
+                epoch_.store (current + 1, std::memory_order_seq_cst);
+            }
+
+        private:
+            std::unique_ptr <slot []>       slots_;
+            size_t                          capacity_;
+
+            // epochs start above quiescent
+            alignas (64) std::atomic <uint64_t> epoch_ {1};
+
+            mutable std::mutex              mutex_;
+            std::vector <retired>           retired_;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef MEMORY_FRAME_HPP_
+#define MEMORY_FRAME_HPP_
+
+namespace ceres { namespace memory {
+
+    //=========================================================================
+    // Pair of arenas for transient data of a frame, such as the input events
+    // held in stream buffers and the temporaries that process them. Storage
+    // comes from the current arena; flipping at the end of the frame makes it
+    // the previous one and resets the other, in constant time, to be current.
+    // So what a frame allocates stays readable through the next frame, and
+    // dies at the end of that. Each thread has its own in local (), flipped
+    // by that thread.
+
+    class frame_arena
+    {
+        public:
+            explicit frame_arena (size_t block_size = 64 * 1024, bool chained = true) :
+                first_ {block_size, chained}, second_ {block_size, chained} {}
+
+            frame_arena (frame_arena const &) = delete;
+            frame_arena &operator= (frame_arena const &) = delete;
+
+            // the calling thread's, made on first use
+            static frame_arena &local ()
+            {
+                static thread_local frame_arena instance;
+                return instance;
+            }
+
+        public:
+            // null when the heap is exhausted, or unchained and full
+            void *allocate (size_t bytes, size_t alignment = alignof (std::max_align_t))
+            {
+                return current_->allocate (bytes, alignment);
+            }
+
+            template <typename Type>
+            Type *allocate_array (size_t count)
+            {
+                return current_->allocate_array <Type> (count);
+            }
+
+            // ends the frame
+            void flip ()
+            {
+                std::swap (current_, previous_);
+                current_->reset ();
+                ++frame_;
+            }
+
+        public:
+            arena &current () { return *current_; }
+            arena &previous () { return *previous_; }
+
+            // flips so far
+            uint64_t frame () const { return frame_; }
+
+            size_t capacity () const { return first_.capacity () + second_.capacity (); }
+
+        private:
+            arena                           first_;
+            arena                           second_;
+            arena                          *current_ = &first_;
+            arena                          *previous_ = &second_;
+            uint64_t                        frame_ = 0;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,123 @@
+#include <core/standard.hpp>
+
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <platform/posix/event.hpp>
+
+namespace ceres { namespace platform { namespace posix { namespace event {
+
+    bool try_open (handle_type &handle)
+    {
+        using ::epoll_create1;
+
+        handle_type result = epoll_create1 (EPOLL_CLOEXEC);
+        bool success = result != INVALID;
+
+        if (success)
+            handle = result;
+
+        return success;
+    }
+
+    bool try_close (handle_type &handle)
+    {
+        using ::close;
+
+        int result = close (handle);
+        bool success = result == 0;
+
+        if (success)
+            handle = INVALID;
+
+        return success;
+    }
+
+    bool try_add (handle_type handle, int target, uint32_t events, void *context)
+    {
+        using ::epoll_ctl;
+
+        epoll_event record {};
+        record.events = events;
+        record.data.ptr = context;
+
+        int result = epoll_ctl (handle, EPOLL_CTL_ADD, target, &record);
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_modify (handle_type handle, int target, uint32_t events, void *context)
+    {
+        using ::epoll_ctl;
+
+        epoll_event record {};
+        record.events = events;
+        record.data.ptr = context;
+
+        int result = epoll_ctl (handle, EPOLL_CTL_MOD, target, &record);
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_remove (handle_type handle, int target)
+    {
+        using ::epoll_ctl;
+
+        epoll_event record {}; // ignored, but required before Linux 2.6.9
+        int result = epoll_ctl (handle, EPOLL_CTL_DEL, target, &record);
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_wait (handle_type handle, record_type *records, int count, 
+            int timeout_ms, int &ready)
+    {
+        using ::epoll_wait;
+
+        int result = epoll_wait (handle, records, count, timeout_ms);
+        bool success = result != INVALID;
+
+        if (success)
+            ready = result;
+
+        return success;
+    }
+
+    bool try_open_wakeup (handle_type &handle)
+    {
+        using ::eventfd;
+
+        handle_type result = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        bool success = result != INVALID;
+
+        if (success)
+            handle = result;
+
+        return success;
+    }
+
+    bool try_signal_wakeup (handle_type handle)
+    {
+        using ::eventfd_write;
+
+        int result = eventfd_write (handle, 1);
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_clear_wakeup (handle_type handle)
+    {
+        using ::eventfd_read;
+
+        eventfd_t value;
+        int result = eventfd_read (handle, &value);
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+} } } }
@@ -0,0 +1,44 @@
+#ifndef _PLATFORM_POSIX_EVENT_HPP_
+#define _PLATFORM_POSIX_EVENT_HPP_
+
+#include <sys/epoll.h>
+
+// NOTE: readiness notification is epoll-based and therefore Linux-only
+
+namespace ceres { namespace platform { namespace posix { namespace event {
+
+    using handle_type = int;
+    using record_type = epoll_event;
+
+    static const handle_type INVALID = -1;
+
+    enum : uint32_t 
+    { 
+        readable = EPOLLIN, 
+        writable = EPOLLOUT, 
+        hangup = EPOLLHUP | EPOLLRDHUP, 
+        failure = EPOLLERR,
+        edge_triggered = EPOLLET,
+    };
+
+    bool try_open (handle_type &handle);
+    bool try_close (handle_type &handle);
+
+    bool try_add (handle_type handle, int target, uint32_t events, void *context);
+    bool try_modify (handle_type handle, int target, uint32_t events, void *context);
+    bool try_remove (handle_type handle, int target);
+
+    bool try_wait (handle_type handle, record_type *records, int count, 
+            int timeout_ms, int &ready);
+
+    inline uint32_t events_of (record_type const &record) { return record.events; }
+    inline void *context_of (record_type const &record) { return record.data.ptr; }
+
+    // wakeup handles are readable after signal until cleared
+    bool try_open_wakeup (handle_type &handle);
+    bool try_signal_wakeup (handle_type handle);
+    bool try_clear_wakeup (handle_type handle);
+
+} } } }
+
+#endif
@@ -0,0 +1,85 @@
+#include <core/standard.hpp>
+
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <platform/posix/file.hpp>
+
+namespace ceres { namespace platform { namespace posix { namespace file {
+
+    bool try_open (char const *path, handle_type &handle)
+    {
+        using ::open;
+
+        handle_type result = open (path, O_RDONLY | O_CLOEXEC);
+        bool success = result >= 0;
+
+        if (success)
+            handle = result;
+
+        return success;
+    }
+
+    bool try_close (handle_type &handle)
+    {
+        using ::close;
+
+        handle_type result = close (handle);
+        bool success = result == 0;
+
+        if (success)
+            handle = INVALID;
+
+        return success;
+    }
+
+    bool try_get_size (handle_type handle, size_t &size)
+    {
+        struct stat status;
+        bool success = ::fstat (handle, &status) == 0;
+
+        if (success)
+            size = status.st_size;
+
+        return success;
+    }
+
+    bool try_map (handle_type handle, size_t size, void const *&data)
+    {
+        if (size == 0)
+        {
+            data = nullptr;
+            return true;
+        }
+
+        void *result = ::mmap (nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0);
+        bool success = result != MAP_FAILED;
+
+        if (success)
+        {
+            // advisory only; failure leaves the default read-ahead
+            ::madvise (result, size, MADV_SEQUENTIAL);
+            data = result;
+        }
+
+        return success;
+    }
+
+    bool try_unmap (void const *&data, size_t size)
+    {
+        if (data == nullptr)
+            return true;
+
+        bool success = ::munmap (const_cast <void *> (data), size) == 0;
+
+        if (success)
+            data = nullptr;
+
+        return success;
+    }
+
+} } } }
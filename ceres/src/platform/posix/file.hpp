@@ -0,0 +1,22 @@
+#ifndef _PLATFORM_POSIX_FILE_HPP_
+#define _PLATFORM_POSIX_FILE_HPP_
+
+namespace ceres { namespace platform { namespace posix { namespace file {
+
+    using handle_type = int;
+
+    static const handle_type INVALID = -1;
+
+    bool try_open (char const *path, handle_type &handle);
+    bool try_close (handle_type &handle);
+
+    bool try_get_size (handle_type handle, size_t &size);
+
+    // read-only private mapping of the whole file, advised for sequential 
+    // reads; an empty file maps to null without error
+    bool try_map (handle_type handle, size_t size, void const *&data);
+    bool try_unmap (void const *&data, size_t size);
+
+} } } }
+
+#endif
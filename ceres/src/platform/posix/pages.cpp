@@ -0,0 +1,107 @@
+#include <core/standard.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <platform/posix/pages.hpp>
+
+namespace ceres { namespace platform { namespace posix { namespace pages {
+
+    namespace
+    {
+        size_t read_huge_page_size ()
+        {
+            // NOTE: Linux-specific; PMD-sized pages are the ones THP provides
+            std::ifstream file ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+            size_t size = 0;
+
+            return (file >> size)? size : 0;
+        }
+    }
+
+    size_t page_size ()
+    {
+        static size_t const size = ::sysconf (_SC_PAGESIZE);
+        return size;
+    }
+
+    size_t huge_page_size ()
+    {
+        static size_t const size = read_huge_page_size ();
+        return size;
+    }
+
+    bool try_map (size_t size, size_t alignment, void *&data)
+    {
+        size_t page = page_size ();
+        size = (size + page - 1) & ~(page - 1);
+        alignment = std::max (alignment, page);
+
+        // map enough to align the start, then return the excess at each end
+        size_t mapped = size + alignment - page;
+        void *result = ::mmap (nullptr, mapped, PROT_READ | PROT_WRITE, 
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (result == MAP_FAILED)
+            return false;
+
+        auto base = reinterpret_cast <uintptr_t> (result);
+        auto aligned = (base + alignment - 1) & ~(alignment - 1);
+
+        if (aligned > base)
+            ::munmap (result, aligned - base);
+
+        if (base + mapped > aligned + size)
+            ::munmap (reinterpret_cast <void *> (aligned + size), base + mapped - aligned - size);
+
+        data = reinterpret_cast <void *> (aligned);
+        return true;
+    }
+
+    bool try_unmap (void *&data, size_t size)
+    {
+        if (data == nullptr)
+            return true;
+
+        size_t page = page_size ();
+        bool success = ::munmap (data, (size + page - 1) & ~(page - 1)) == 0;
+
+        if (success)
+            data = nullptr;
+
+        return success;
+    }
+
+    bool try_advise_huge (void *data, size_t size)
+    {
+#ifdef MADV_HUGEPAGE
+        return ::madvise (data, size, MADV_HUGEPAGE) == 0;
+#else
+        errno = ENOTSUP;
+        return false;
+#endif
+    }
+
+    bool try_allocate (size_t size, size_t alignment, void *&data)
+    {
+        void *result = nullptr;
+        int error = ::posix_memalign (&result, alignment, size);
+
+        if (error)
+            errno = error;
+        else
+            data = result;
+
+        return !error;
+    }
+
+    void deallocate (void *&data)
+    {
+        std::free (data);
+        data = nullptr;
+    }
+
+} } } }
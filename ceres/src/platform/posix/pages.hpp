@@ -0,0 +1,25 @@
+#ifndef _PLATFORM_POSIX_PAGES_HPP_
+#define _PLATFORM_POSIX_PAGES_HPP_
+
+namespace ceres { namespace platform { namespace posix { namespace pages {
+
+    size_t page_size ();
+
+    // transparent huge page size, or zero where the kernel has none
+    size_t huge_page_size ();
+
+    // zeroed private anonymous pages; size is rounded up to whole pages and 
+    // the start aligned to alignment, which is a power of two
+    bool try_map (size_t size, size_t alignment, void *&data);
+    bool try_unmap (void *&data, size_t size);
+
+    // asks for transparent huge pages over the range; advisory only
+    bool try_advise_huge (void *data, size_t size);
+
+    // heap storage aligned to a power of two multiple of sizeof (void *)
+    bool try_allocate (size_t size, size_t alignment, void *&data);
+    void deallocate (void *&data);
+
+} } } }
+
+#endif
@@ -1,6 +1,9 @@
 #include <core/standard.hpp>
 
+#include <cerrno>
+
 #include <unistd.h>
+#include <fcntl.h>
 #include <arpa/inet.h>
 
 #include <platform/posix/socket.hpp>
@@ -8,43 +11,147 @@
 
 namespace ceres { namespace platform { namespace posix { namespace socket {
 
-    bool try_string_to_inet4 (std::string const &str, address_type &addr)
+    namespace
+    {
+        bool parse_port (char const *str, size_t length, in_port_t &port)
+        {
+            uint32_t value = 0;
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (str[i] < '0' || str[i] > '9')
+                    return false;
+
+                value = value * 10 + (str[i] - '0');
+                if (value > 0xFFFF)
+                    return false;
+            }
+
+            port = htons (value);
+            return length > 0;
+        }
+
+        size_t format_port (in_port_t port, char *str)
+        {
+            char digits [5];
+            size_t count = 0;
+
+            for (uint32_t value = ntohs (port); count == 0 || value > 0; value /= 10)
+                digits[count++] = '0' + value % 10;
+
+            for (size_t i = 0; i < count; ++i)
+                str[i] = digits[count - i - 1];
+
+            return count;
+        }
+    }
+
+    bool try_parse_address (char const *str, size_t length, address_type &addr)
     {
-        using std::string;
-        using std::stoul; // WARN: can throw
+        char host [INET6_ADDRSTRLEN];
+        char const *end = str + length;
+        char const *host_begin = str, *host_end = end, *port = nullptr;
 
-        string host;
-        size_t portmark = str.rfind (':');
+        auto colon = std::find (str, end, ':');
+        bool bracketed = length > 0 && str[0] == '[';
+        bool inet6 = bracketed || std::find (colon + (colon != end), end, ':') != end;
 
-        host = str.substr (0, portmark);
-        if (portmark != string::npos) 
-            addr.sin_port = htons (stoul (str.substr (portmark + 1)));
+        if (bracketed)
+        {
+            host_begin = str + 1;
+            host_end = std::find (host_begin, end, ']');
+
+            if (host_end == end || (host_end + 1 != end && host_end[1] != ':'))
+                return errno = EINVAL, false;
 
-        int result = inet_pton (AF_INET, host.c_str(), &addr.sin_addr);
-        bool success = result > 0;
+            if (host_end + 1 != end)
+                port = host_end + 2;
+        }
+        else if (!inet6 && colon != end)
+        {
+            host_end = colon;
+            port = colon + 1;
+        }
+
+        size_t host_length = host_end - host_begin;
+        if (host_length >= sizeof (host))
+            return errno = EINVAL, false;
+
+        std::memcpy (host, host_begin, host_length);
+        host[host_length] = '\0';
+
+        std::memset (&addr, 0, sizeof (addr));
+        bool success;
+
+        if (inet6)
+        {
+            auto &in6 = reinterpret_cast <sockaddr_in6 &> (addr);
+            in6.sin6_family = AF_INET6;
+            success = inet_pton (AF_INET6, host, &in6.sin6_addr) > 0 &&
+                (!port || parse_port (port, end - port, in6.sin6_port));
+        }
+        else
+        {
+            auto &in4 = reinterpret_cast <sockaddr_in &> (addr);
+            in4.sin_family = AF_INET;
+            success = inet_pton (AF_INET, host, &in4.sin_addr) > 0 &&
+                (!port || parse_port (port, end - port, in4.sin_port));
+        }
+
+        if (!success)
+            errno = EINVAL;
 
         return success;
     }
 
-    bool try_inet4_to_string (address_type const &addr, std::string &str)
+    bool try_format_address (address_type const &addr, char *str, size_t size, size_t &length)
     {
-        using std::to_string; // WARN: can throw
+        constexpr size_t port_space = 7; // "]:65535"
+
+        bool inet6 = addr.ss_family == AF_INET6;
+        auto &in4 = reinterpret_cast <sockaddr_in const &> (addr);
+        auto &in6 = reinterpret_cast <sockaddr_in6 const &> (addr);
 
-        char buf [INET6_ADDRSTRLEN];
+        if (!inet6 && addr.ss_family != AF_INET)
+            return errno = EAFNOSUPPORT, false;
 
-        char const *result = inet_ntop (AF_INET, &addr.sin_addr, buf, sizeof (buf));
-        bool success = result != nullptr;
+        if (size < port_space + 2)
+            return errno = ENOSPC, false;
+
+        char *host = str + inet6;
+        socklen_t space = size - port_space - inet6;
+
+        bool success = inet6?
+            inet_ntop (AF_INET6, &in6.sin6_addr, host, space) != nullptr :
+            inet_ntop (AF_INET, &in4.sin_addr, host, space) != nullptr;
 
         if (success)
         {
-            str = buf; 
-            str += ':';
-            str += to_string (ntohs (addr.sin_port));
+            char *cursor = host + std::strlen (host);
+
+            if (inet6)
+                str[0] = '[', *cursor++ = ']';
+
+            *cursor++ = ':';
+            cursor += format_port (inet6? in6.sin6_port : in4.sin_port, cursor);
+            *cursor = '\0';
+
+            length = cursor - str;
         }
 
         return success;
     }
 
+    size_type address_size (address_type const &addr)
+    {
+        switch (addr.ss_family)
+        {
+            case AF_INET: return sizeof (sockaddr_in);
+            case AF_INET6: return sizeof (sockaddr_in6);
+            default: return sizeof (addr);
+        }
+    }
+
     bool try_open (int family, int type, int protocol, int &handle)
     {
         using ::socket;
@@ -135,4 +242,193 @@ namespace ceres { namespace platform { namespace posix { namespace socket {
         return success;
     }
 
+    bool try_set_nonblocking (handle_type handle, bool enable)
+    {
+        using ::fcntl;
+
+        int flags = fcntl (handle, F_GETFL, 0);
+        bool success = flags != INVALID;
+
+        if (success)
+        {
+            flags = enable? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+            success = fcntl (handle, F_SETFL, flags) != INVALID;
+        }
+
+        return success;
+    }
+
+    bool try_set_reuse_address (handle_type handle, bool enable)
+    {
+        using ::setsockopt;
+
+        int value = enable;
+        int result = setsockopt (handle, SOL_SOCKET, SO_REUSEADDR, &value, sizeof (value));
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_set_reuse_port (handle_type handle, bool enable)
+    {
+        using ::setsockopt;
+
+        int value = enable;
+        int result = setsockopt (handle, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value));
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_set_v6_only (handle_type handle, bool enable)
+    {
+        using ::setsockopt;
+
+        int value = enable;
+        int result = setsockopt (handle, IPPROTO_IPV6, IPV6_V6ONLY, &value, sizeof (value));
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_send (handle_type handle, void const *data, size_t size, size_t &sent)
+    {
+        using ::send;
+
+        ssize_t result = send (handle, data, size, MSG_NOSIGNAL);
+        bool success = result >= 0;
+
+        if (success)
+            sent = result;
+
+        return success;
+    }
+
+    bool try_receive (handle_type handle, void *data, size_t size, size_t &received)
+    {
+        using ::recv;
+
+        ssize_t result = recv (handle, data, size, 0);
+        bool success = result >= 0;
+
+        if (success)
+            received = result;
+
+        return success;
+    }
+
+    bool try_send_to (handle_type handle, void const *data, size_t size, 
+            sockaddr const *addr, size_type addrsize, size_t &sent)
+    {
+        using ::sendto;
+
+        ssize_t result = sendto (handle, data, size, MSG_NOSIGNAL, addr, addrsize);
+        bool success = result >= 0;
+
+        if (success)
+            sent = result;
+
+        return success;
+    }
+
+    bool try_receive_from (handle_type handle, void *data, size_t size, 
+            sockaddr *addr, size_type &addrsize, size_t &received)
+    {
+        using ::recvfrom;
+
+        ssize_t result = recvfrom (handle, data, size, 0, addr, &addrsize);
+        bool success = result >= 0;
+
+        if (success)
+            received = result;
+
+        return success;
+    }
+
+    bool try_send_batch (handle_type handle, message_type *messages, size_t count, size_t &sent)
+    {
+        using ::sendmmsg;
+
+        int result = sendmmsg (handle, messages, count, MSG_NOSIGNAL);
+        bool success = result >= 0;
+
+        if (success)
+            sent = result;
+
+        return success;
+    }
+
+    bool try_receive_batch (handle_type handle, message_type *messages, size_t count, size_t &received)
+    {
+        using ::recvmmsg;
+
+        // blocking sockets return as soon as one message is available
+        int result = recvmmsg (handle, messages, count, MSG_WAITFORONE, nullptr);
+        bool success = result >= 0;
+
+        if (success)
+            received = result;
+
+        return success;
+    }
+
+    bool try_set_udp_segment (handle_type handle, uint16_t segment)
+    {
+        using ::setsockopt;
+
+        int value = segment;
+        int result = setsockopt (handle, SOL_UDP, UDP_SEGMENT, &value, sizeof (value));
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    bool try_set_udp_gro (handle_type handle, bool enable)
+    {
+        using ::setsockopt;
+
+        int value = enable;
+        int result = setsockopt (handle, SOL_UDP, UDP_GRO, &value, sizeof (value));
+        bool success = result != INVALID;
+
+        return success;
+    }
+
+    size_t segment_control_size ()
+    {
+        return CMSG_SPACE (sizeof (int));
+    }
+
+    void set_segment_control (message_type &message, void *control, uint16_t segment)
+    {
+        message.msg_hdr.msg_control = control;
+        message.msg_hdr.msg_controllen = CMSG_SPACE (sizeof (uint16_t));
+
+        cmsghdr *header = CMSG_FIRSTHDR (&message.msg_hdr);
+        header->cmsg_level = SOL_UDP;
+        header->cmsg_type = UDP_SEGMENT;
+        header->cmsg_len = CMSG_LEN (sizeof (uint16_t));
+        std::memcpy (CMSG_DATA (header), &segment, sizeof (segment));
+    }
+
+    uint16_t get_segment_control (message_type const &message)
+    {
+        if (message.msg_hdr.msg_control == nullptr)
+            return 0;
+
+        auto hdr = const_cast <msghdr *> (&message.msg_hdr);
+
+        for (cmsghdr *header = CMSG_FIRSTHDR (hdr); header; header = CMSG_NXTHDR (hdr, header))
+        {
+            if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO)
+            {
+                int segment;
+                std::memcpy (&segment, CMSG_DATA (header), sizeof (segment));
+                return segment;
+            }
+        }
+
+        return 0;
+    }
+
 } } } }
@@ -3,17 +3,30 @@
 
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
+
+// NOTE: batched and segmented UDP calls are Linux-specific
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 
 namespace ceres { namespace platform { namespace posix { namespace socket {
 
     using handle_type = int;
     using size_type = socklen_t;
-    using address_type = sockaddr_in;
+    using address_type = sockaddr_storage;
+    using message_type = mmsghdr;
 
     static const handle_type INVALID = -1;
 
-    bool try_string_to_inet4 (std::string const &str, address_type &addr);
-    bool try_inet4_to_string (address_type const &addr, std::string &str);
+    // "a.b.c.d[:port]", "[v6][:port]" or bare "v6"; writes nothing on the heap
+    bool try_parse_address (char const *str, size_t length, address_type &addr);
+    bool try_format_address (address_type const &addr, char *str, size_t size, size_t &length);
+
+    size_type address_size (address_type const &addr);
 
     bool try_open (int family, int type, int protocol, int &handle);
     bool try_close (handle_type &handle);
@@ -28,6 +41,30 @@ namespace ceres { namespace platform { namespace posix { namespace socket {
     bool try_get_local_address (handle_type handle, sockaddr *addr, size_type &size);
     bool try_get_remote_address (handle_type handle, sockaddr *addr, size_type &size);
 
+    bool try_set_nonblocking (handle_type handle, bool enable);
+    bool try_set_reuse_address (handle_type handle, bool enable);
+    bool try_set_reuse_port (handle_type handle, bool enable);
+    bool try_set_v6_only (handle_type handle, bool enable);
+
+    bool try_send (handle_type handle, void const *data, size_t size, size_t &sent);
+    bool try_receive (handle_type handle, void *data, size_t size, size_t &received);
+
+    bool try_send_to (handle_type handle, void const *data, size_t size, 
+            sockaddr const *addr, size_type addrsize, size_t &sent);
+    bool try_receive_from (handle_type handle, void *data, size_t size, 
+            sockaddr *addr, size_type &addrsize, size_t &received);
+
+    bool try_send_batch (handle_type handle, message_type *messages, size_t count, size_t &sent);
+    bool try_receive_batch (handle_type handle, message_type *messages, size_t count, size_t &received);
+
+    bool try_set_udp_segment (handle_type handle, uint16_t segment);
+    bool try_set_udp_gro (handle_type handle, bool enable);
+
+    // per-message control data carrying a UDP segment size (GSO out, GRO in)
+    size_t segment_control_size ();
+    void set_segment_control (message_type &message, void *control, uint16_t segment);
+    uint16_t get_segment_control (message_type const &message);
+
 } } } }
 
  #endif
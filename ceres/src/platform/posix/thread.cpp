@@ -0,0 +1,34 @@
+#include <core/standard.hpp>
+
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+
+#include <platform/posix/thread.hpp>
+
+namespace ceres { namespace platform { namespace posix { namespace thread {
+
+    size_t core_count ()
+    {
+        auto count = std::thread::hardware_concurrency ();
+        return count? count : 1;
+    }
+
+    bool try_set_affinity (std::thread &thread, size_t core)
+    {
+        using ::pthread_setaffinity_np;
+
+        cpu_set_t cores;
+        CPU_ZERO (&cores);
+        CPU_SET (core % core_count (), &cores);
+
+        int result = pthread_setaffinity_np (thread.native_handle (), sizeof (cores), &cores);
+        bool success = result == 0;
+
+        if (!success)
+            errno = result; // pthread functions return the error rather than set it
+
+        return success;
+    }
+
+} } } }
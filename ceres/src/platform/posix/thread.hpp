@@ -0,0 +1,12 @@
+#ifndef _PLATFORM_POSIX_THREAD_HPP_
+#define _PLATFORM_POSIX_THREAD_HPP_
+
+namespace ceres { namespace platform { namespace posix { namespace thread {
+
+    size_t core_count ();
+
+    bool try_set_affinity (std::thread &thread, size_t core);
+
+} } } }
+
+#endif
@@ -0,0 +1,276 @@
+#include <core/standard.hpp>
+
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <platform/posix/uring.hpp>
+
+// glibc provides no wrappers for the io_uring system calls
+
+namespace ceres { namespace platform { namespace posix { namespace uring {
+
+    namespace
+    {
+        int setup (unsigned entries, io_uring_params &params)
+        {
+            return ::syscall (__NR_io_uring_setup, entries, &params);
+        }
+
+        int enter (int handle, unsigned submit, unsigned wait, unsigned flags,
+                void const *arg, size_t size)
+        {
+            return ::syscall (__NR_io_uring_enter, handle, submit, wait, flags, arg, size);
+        }
+
+        int enroll (int handle, unsigned opcode, void const *arg, unsigned count)
+        {
+            return ::syscall (__NR_io_uring_register, handle, opcode, arg, count);
+        }
+
+        void unmap (ring_type &ring)
+        {
+            if (ring.sqes)
+                ::munmap (ring.sqes, ring.sqes_map_size);
+
+            if (ring.cq_map && ring.cq_map != ring.sq_map)
+                ::munmap (ring.cq_map, ring.cq_map_size);
+
+            if (ring.sq_map)
+                ::munmap (ring.sq_map, ring.sq_map_size);
+
+            ring.sqes = nullptr;
+            ring.sq_map = ring.cq_map = nullptr;
+        }
+
+        template <typename T>
+        T *at (void *base, unsigned offset)
+        {
+            return reinterpret_cast <T *> (static_cast <uint8_t *> (base) + offset);
+        }
+    }
+
+    bool is_supported ()
+    {
+        ring_type ring;
+        buffer_ring_type buffers;
+
+        if (!try_open (ring, 4))
+            return false;
+
+        bool success = try_register_buffer_ring (ring, buffers, 0, 4) &&
+            try_unregister_buffer_ring (ring, buffers);
+
+        int saved = errno;
+        try_close (ring);
+        errno = saved;
+
+        return success;
+    }
+
+    bool try_open (ring_type &ring, unsigned entries)
+    {
+        io_uring_params params {};
+        params.flags = IORING_SETUP_SUBMIT_ALL;
+
+        int handle = setup (entries, params);
+
+        // older kernels reject unknown setup flags
+        if (handle < 0 && errno == EINVAL)
+        {
+            params = io_uring_params {};
+            handle = setup (entries, params);
+        }
+
+        if (handle < 0)
+            return false;
+
+        ring.handle = handle;
+        ring.features = params.features;
+
+        ring.sq_map_size = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+        ring.cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof (completion_type);
+        ring.sqes_map_size = params.sq_entries * sizeof (submission_type);
+
+        // both queues share one mapping when the kernel allows
+        if (ring.features & IORING_FEAT_SINGLE_MMAP)
+            ring.sq_map_size = ring.cq_map_size = std::max (ring.sq_map_size, ring.cq_map_size);
+
+        void *sq = ::mmap (nullptr, ring.sq_map_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQ_RING);
+        bool success = sq != MAP_FAILED;
+
+        if (success)
+        {
+            ring.sq_map = sq;
+            ring.cq_map = sq;
+
+            if (!(ring.features & IORING_FEAT_SINGLE_MMAP))
+            {
+                void *cq = ::mmap (nullptr, ring.cq_map_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_CQ_RING);
+                success = cq != MAP_FAILED;
+                ring.cq_map = success? cq : nullptr;
+            }
+        }
+
+        if (success)
+        {
+            void *sqes = ::mmap (nullptr, ring.sqes_map_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQES);
+            success = sqes != MAP_FAILED;
+            ring.sqes = success? static_cast <submission_type *> (sqes) : nullptr;
+        }
+
+        if (!success)
+        {
+            int saved = errno;
+            unmap (ring);
+            ::close (handle);
+            ring.handle = INVALID;
+            errno = saved;
+            return false;
+        }
+
+        ring.sq_head = at <unsigned> (ring.sq_map, params.sq_off.head);
+        ring.sq_tail = at <unsigned> (ring.sq_map, params.sq_off.tail);
+        ring.sq_array = at <unsigned> (ring.sq_map, params.sq_off.array);
+        ring.sq_mask = *at <unsigned> (ring.sq_map, params.sq_off.ring_mask);
+        ring.sq_entries = params.sq_entries;
+        ring.sq_staged = *ring.sq_tail;
+
+        ring.cq_head = at <unsigned> (ring.cq_map, params.cq_off.head);
+        ring.cq_tail = at <unsigned> (ring.cq_map, params.cq_off.tail);
+        ring.cq_mask = *at <unsigned> (ring.cq_map, params.cq_off.ring_mask);
+        ring.cqes = at <completion_type> (ring.cq_map, params.cq_off.cqes);
+
+        return true;
+    }
+
+    bool try_close (ring_type &ring)
+    {
+        unmap (ring);
+
+        int result = ::close (ring.handle);
+        bool success = result == 0;
+
+        if (success)
+            ring.handle = INVALID;
+
+        return success;
+    }
+
+    bool try_submit (ring_type &ring, unsigned wait, int timeout_ms, unsigned &submitted)
+    {
+        unsigned pending = ring.sq_staged - *ring.sq_tail;
+        __atomic_store_n (ring.sq_tail, ring.sq_staged, __ATOMIC_RELEASE);
+
+        unsigned flags = wait? IORING_ENTER_GETEVENTS : 0;
+        void const *arg = nullptr;
+        size_t size = 0;
+
+        __kernel_timespec timeout {timeout_ms / 1000, (timeout_ms % 1000) * 1000000ll};
+        io_uring_getevents_arg extended {};
+
+        if (wait && timeout_ms >= 0)
+        {
+            extended.sigmask_sz = _NSIG / 8;
+            extended.ts = reinterpret_cast <uint64_t> (&timeout);
+
+            flags |= IORING_ENTER_EXT_ARG;
+            arg = &extended;
+            size = sizeof (extended);
+        }
+
+        int result = enter (ring.handle, pending, wait, flags, arg, size);
+
+        // an expired wait or a signal still leaves submissions consumed
+        if (result < 0 && (errno == ETIME || errno == EINTR))
+            result = pending;
+
+        bool success = result >= 0;
+
+        if (success)
+            submitted = result;
+
+        return success;
+    }
+
+    bool try_register_files (ring_type &ring, unsigned count)
+    {
+        std::vector <int> handles (count, -1);
+
+        int result = enroll (ring.handle, IORING_REGISTER_FILES, handles.data (), count);
+        bool success = result == 0;
+
+        return success;
+    }
+
+    bool try_update_file (ring_type &ring, unsigned slot, int handle)
+    {
+        io_uring_files_update update {};
+        update.offset = slot;
+        update.fds = reinterpret_cast <uint64_t> (&handle);
+
+        int result = enroll (ring.handle, IORING_REGISTER_FILES_UPDATE, &update, 1);
+        bool success = result == 1;
+
+        return success;
+    }
+
+    bool try_register_buffer_ring (ring_type &ring, buffer_ring_type &buffers,
+            uint16_t group, unsigned entries)
+    {
+        size_t size = entries * sizeof (io_uring_buf);
+
+        void *memory = ::mmap (nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (memory == MAP_FAILED)
+            return false;
+
+        io_uring_buf_reg reg {};
+        reg.ring_addr = reinterpret_cast <uint64_t> (memory);
+        reg.ring_entries = entries;
+        reg.bgid = group;
+
+        int result = enroll (ring.handle, IORING_REGISTER_PBUF_RING, &reg, 1);
+        bool success = result == 0;
+
+        if (success)
+        {
+            buffers.buffers = static_cast <io_uring_buf_ring *> (memory);
+            buffers.entries = entries;
+            buffers.group = group;
+            buffers.staged = 0;
+            buffers.map_size = size;
+        }
+        else
+        {
+            int saved = errno;
+            ::munmap (memory, size);
+            errno = saved;
+        }
+
+        return success;
+    }
+
+    bool try_unregister_buffer_ring (ring_type &ring, buffer_ring_type &buffers)
+    {
+        io_uring_buf_reg reg {};
+        reg.bgid = buffers.group;
+
+        int result = enroll (ring.handle, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        bool success = result == 0;
+
+        if (success)
+        {
+            ::munmap (buffers.buffers, buffers.map_size);
+            buffers.buffers = nullptr;
+        }
+
+        return success;
+    }
+
+} } } }
@@ -0,0 +1,174 @@
+#ifndef _PLATFORM_POSIX_URING_HPP_
+#define _PLATFORM_POSIX_URING_HPP_
+
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+
+// NOTE: io_uring is Linux-only; multishot receive and provided buffer rings
+// need Linux 6.0, and the ring may be disabled by policy (seccomp or the
+// kernel.io_uring_disabled sysctl), so callers should check is_supported
+
+namespace ceres { namespace platform { namespace posix { namespace uring {
+
+    using submission_type = io_uring_sqe;
+    using completion_type = io_uring_cqe;
+
+    static const int INVALID = -1;
+
+    // Submission and completion queues shared with the kernel. Submissions
+    // are staged locally and published to the kernel by try_submit.
+    struct ring_type
+    {
+        int                 handle = INVALID;
+        unsigned            features = 0;
+
+        unsigned           *sq_head = nullptr;
+        unsigned           *sq_tail = nullptr;
+        unsigned           *sq_array = nullptr;
+        unsigned            sq_mask = 0;
+        unsigned            sq_entries = 0;
+        unsigned            sq_staged = 0;      // local tail, ahead of *sq_tail
+        submission_type    *sqes = nullptr;
+
+        unsigned           *cq_head = nullptr;
+        unsigned           *cq_tail = nullptr;
+        unsigned            cq_mask = 0;
+        completion_type    *cqes = nullptr;
+
+        void               *sq_map = nullptr;
+        void               *cq_map = nullptr;
+        size_t              sq_map_size = 0;
+        size_t              cq_map_size = 0;
+        size_t              sqes_map_size = 0;
+    };
+
+    // Buffers the kernel picks from for IOSQE_BUFFER_SELECT receives
+    struct buffer_ring_type
+    {
+        io_uring_buf_ring  *buffers = nullptr;
+        unsigned            entries = 0;
+        uint16_t            group = 0;
+        uint16_t            staged = 0;         // local tail, ahead of the shared tail
+        size_t              map_size = 0;
+    };
+
+    // probes for a ring with provided buffer ring support
+    bool is_supported ();
+
+    bool try_open (ring_type &ring, unsigned entries);
+    bool try_close (ring_type &ring);
+
+    // publishes staged submissions and optionally waits for completions;
+    // a negative timeout waits indefinitely, an expired one is not an error
+    bool try_submit (ring_type &ring, unsigned wait, int timeout_ms, unsigned &submitted);
+
+    // fixed file table of the given size with every slot empty
+    bool try_register_files (ring_type &ring, unsigned count);
+    bool try_update_file (ring_type &ring, unsigned slot, int handle);
+
+    bool try_register_buffer_ring (ring_type &ring, buffer_ring_type &buffers,
+            uint16_t group, unsigned entries);
+    bool try_unregister_buffer_ring (ring_type &ring, buffer_ring_type &buffers);
+
+    //-------------------------------------------------------------------------
+    // Queue access; inline as these run once per operation
+
+    inline submission_type *next_submission (ring_type &ring)
+    {
+        unsigned head = __atomic_load_n (ring.sq_head, __ATOMIC_ACQUIRE);
+
+        if (ring.sq_staged - head >= ring.sq_entries)
+            return nullptr;
+
+        submission_type *sqe = &ring.sqes [ring.sq_staged & ring.sq_mask];
+        ring.sq_array [ring.sq_staged & ring.sq_mask] = ring.sq_staged & ring.sq_mask;
+        ++ring.sq_staged;
+
+        *sqe = submission_type {};
+        return sqe;
+    }
+
+    inline completion_type *peek_completion (ring_type &ring)
+    {
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n (ring.cq_tail, __ATOMIC_ACQUIRE);
+
+        return head != tail? &ring.cqes [head & ring.cq_mask] : nullptr;
+    }
+
+    inline void advance_completion (ring_type &ring)
+    {
+        __atomic_store_n (ring.cq_head, *ring.cq_head + 1, __ATOMIC_RELEASE);
+    }
+
+    inline uint64_t data_of (completion_type const &cqe) { return cqe.user_data; }
+    inline int result_of (completion_type const &cqe) { return cqe.res; }
+    inline bool has_more (completion_type const &cqe) { return cqe.flags & IORING_CQE_F_MORE; }
+    inline bool has_buffer (completion_type const &cqe) { return cqe.flags & IORING_CQE_F_BUFFER; }
+    inline uint16_t buffer_of (completion_type const &cqe) { return cqe.flags >> IORING_CQE_BUFFER_SHIFT; }
+
+    // stages a buffer for the kernel; visible after publish_buffers
+    inline void provide_buffer (buffer_ring_type &buffers, void *data, unsigned size, uint16_t id)
+    {
+        // indexed from the base: in C++ the header's flex array member is
+        // preceded by an empty struct of size 1, which misplaces bufs
+        io_uring_buf *bufs = reinterpret_cast <io_uring_buf *> (buffers.buffers);
+        io_uring_buf &buf = bufs [buffers.staged++ & (buffers.entries - 1)];
+        buf.addr = reinterpret_cast <uint64_t> (data);
+        buf.len = size;
+        buf.bid = id;
+    }
+
+    inline void publish_buffers (buffer_ring_type &buffers)
+    {
+        __atomic_store_n (&buffers.buffers->tail, buffers.staged, __ATOMIC_RELEASE);
+    }
+
+    //-------------------------------------------------------------------------
+    // Operations; sockets are addressed by fixed file slot
+
+    inline void prepare_receive_multishot (submission_type *sqe, unsigned slot,
+            uint16_t group, uint64_t data)
+    {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = slot;
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->buf_group = group;
+        sqe->user_data = data;
+    }
+
+    // waits for the whole buffer on stream sockets; link orders the next submission after this
+    inline void prepare_send (submission_type *sqe, unsigned slot,
+            void const *buf, size_t size, uint64_t data, bool link)
+    {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = slot;
+        sqe->flags = IOSQE_FIXED_FILE | (link? IOSQE_IO_LINK : 0);
+        sqe->addr = reinterpret_cast <uint64_t> (buf);
+        sqe->len = size;
+        sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+        sqe->user_data = data;
+    }
+
+    inline void prepare_read (submission_type *sqe, int handle, void *buf, size_t size, uint64_t data)
+    {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = handle;
+        sqe->addr = reinterpret_cast <uint64_t> (buf);
+        sqe->len = size;
+        sqe->off = -1; // current position; required for non-seekable files
+        sqe->user_data = data;
+    }
+
+    inline void prepare_cancel (submission_type *sqe, uint64_t target, uint64_t data)
+    {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = target;
+        sqe->user_data = data;
+    }
+
+} } } }
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef _STATE_MACHINE_ARRAY_HPP_
+#define _STATE_MACHINE_ARRAY_HPP_
+
+namespace ceres
+{
+    namespace state
+    {
+        //=====================================================================
+        // Many identical state machines, one per entity, stored as columns:
+        // a state ID column and one slot column per state type. A batch of
+        // entities reacts to an event by grouping the entities by active
+        // state, then running each state's transition over its whole group
+        // in a single loop. Transitions use traits::state::transition as for
+        // singular_machine. An entity whose next state throws on construction
+        // stays in its current state; those before it in the batch have moved.
+
+        template <typename Default, typename ...States>
+        class machine_array
+        {
+            public:
+                typedef uint32_t entity_id;
+
+                constexpr static size_t nstates = 1 + sizeof...(States);
+
+                typedef typename core::min_word_size <nstates>::type state_id;
+
+                template <typename Event>
+                using reaction = void (*) (machine_array &,
+                        entity_id const *, entity_id const *, Event const &);
+
+            public:
+                explicit machine_array (size_t count) :
+                    active_ (count, id_of <Default> ()),
+                    columns_ (column <Default> (count), column <States> (count)...),
+                    offsets_ (nstates + 1)
+                {
+                    for (entity_id entity = 0; entity < count; ++entity)
+                        new (get_column <Default> ().at (entity)) Default ();
+                }
+
+                ~machine_array ()
+                {
+                    constexpr static void (*table []) (machine_array &, entity_id) =
+                        { &destroy <Default>, &destroy <States>... };
+
+                    for (entity_id entity = 0; entity < size (); ++entity)
+                        table [active_ [entity]] (*this, entity);
+                }
+
+                machine_array (machine_array const &) = delete;
+                machine_array &operator= (machine_array const &) = delete;
+
+            public:
+                size_t size () const
+                {
+                    return active_.size ();
+                }
+
+                size_t active (entity_id entity) const
+                {
+                    return active_ [entity];
+                }
+
+                template <typename State>
+                bool is_active (entity_id entity) const
+                {
+                    return active_ [entity] == id_of <State> ();
+                }
+
+                template <typename State>
+                State &get (entity_id entity)
+                {
+                    ASSERTF (is_active <State> (entity), "accessing inactive state");
+                    return *get_column <State> ().at (entity);
+                }
+
+            public:
+                // reacts the given entities; each entity should appear at most once
+                template <typename Event>
+                void react (memory::buffer <entity_id const> const &entities, Event const &event)
+                {
+                    ASSERTF (distinct (begin (entities), end (entities)), "entity reacts more than once");
+
+                    group (begin (entities), end (entities));
+                    dispatch (event);
+                }
+
+                // reacts every entity in the array
+                template <typename Event>
+                void react (Event const &event)
+                {
+                    group_all ();
+                    dispatch (event);
+                }
+
+            private:
+                template <typename State>
+                struct column
+                {
+                    std::vector <memory::aligned_storage <State>> slots;
+
+                    explicit column (size_t count) : slots (count) {}
+
+                    State *at (entity_id entity)
+                    {
+                        return reinterpret_cast <State *> (&slots [entity]);
+                    }
+                };
+
+                template <typename State>
+                constexpr static state_id id_of ()
+                {
+                    return state_index <State, Default, States...>::value;
+                }
+
+                template <typename State>
+                column <State> &get_column ()
+                {
+                    return std::get <id_of <State> ()> (columns_);
+                }
+
+            private:
+                template <typename Iterator>
+                bool distinct (Iterator first, Iterator last) const
+                {
+                    std::vector <bool> seen (size ());
+
+                    for (auto entity = first; entity != last; ++entity)
+                    {
+                        if (*entity >= size () || seen [*entity])
+                            return false;
+
+                        seen [*entity] = true;
+                    }
+
+                    return true;
+                }
+
+                // counting sort of entities into per-state runs of grouped_
+                template <typename Iterator>
+                void group (Iterator first, Iterator last)
+                {
+                    std::fill (offsets_.begin (), offsets_.end (), 0);
+
+                    for (auto entity = first; entity != last; ++entity)
+                        ++offsets_ [active_ [*entity] + 1];
+
+                    for (size_t id = 0; id < nstates; ++id)
+                        offsets_ [id + 1] += offsets_ [id];
+
+                    grouped_.resize (offsets_ [nstates]);
+                    cursors_.assign (offsets_.begin (), offsets_.end () - 1);
+
+                    for (auto entity = first; entity != last; ++entity)
+                        grouped_ [cursors_ [active_ [*entity]]++] = *entity;
+                }
+
+                void group_all ()
+                {
+                    std::fill (offsets_.begin (), offsets_.end (), 0);
+
+                    for (auto id : active_)
+                        ++offsets_ [id + 1];
+
+                    for (size_t id = 0; id < nstates; ++id)
+                        offsets_ [id + 1] += offsets_ [id];
+
+                    grouped_.resize (size ());
+                    cursors_.assign (offsets_.begin (), offsets_.end () - 1);
+
+                    for (entity_id entity = 0; entity < size (); ++entity)
+                        grouped_ [cursors_ [active_ [entity]]++] = entity;
+                }
+
+                // runs are fixed before any transition, so an entity reacts once
+                template <typename Event>
+                void dispatch (Event const &event)
+                {
+                    constexpr static reaction <Event> table [] =
+                        { select <Default, Event> (), select <States, Event> ()... };
+
+                    for (size_t id = 0; id < nstates; ++id)
+                    {
+                        auto first = grouped_.data () + offsets_ [id];
+                        auto last = grouped_.data () + offsets_ [id + 1];
+
+                        if (table [id] && first != last)
+                            table [id] (*this, first, last, event);
+                    }
+                }
+
+            private:
+                template <typename Curr, typename Next, typename Event>
+                static void transit (machine_array &machines,
+                        entity_id const *first, entity_id const *last, Event const &event)
+                {
+                    auto &curr = machines.get_column <Curr> ();
+                    auto &next = machines.get_column <Next> ();
+
+                    // the states have separate slots, so the next is built first
+                    for (auto entity = first; entity != last; ++entity)
+                    {
+                        new (next.at (*entity)) Next (event);
+                        curr.at (*entity)-> ~Curr ();
+                        machines.active_ [*entity] = id_of <Next> ();
+                    }
+                }
+
+                template <typename State>
+                static void destroy (machine_array &machines, entity_id entity)
+                {
+                    machines.get_column <State> ().at (entity)-> ~State ();
+                }
+
+                // table entry is null when the state has no transition on the event
+                template <typename State, typename Event,
+                         typename Next = typename traits::state::transition <State, Event>::next>
+                struct selector
+                {
+                    constexpr static reaction <Event> get () { return &transit <State, Next, Event>; }
+                };
+
+                template <typename State, typename Event>
+                struct selector <State, Event, traits::state::null>
+                {
+                    constexpr static reaction <Event> get () { return nullptr; }
+                };
+
+                template <typename State, typename Event>
+                constexpr static reaction <Event> select ()
+                {
+                    return selector <State, Event>::get ();
+                }
+
+            private:
+                std::vector <state_id>                                  active_;
+                std::tuple <column <Default>, column <States>...>       columns_;
+
+                // scratch reused across reactions to avoid reallocation
+                std::vector <size_t>                                    offsets_;
+                std::vector <size_t>                                    cursors_;
+                std::vector <entity_id>                                 grouped_;
+        };
+    }
+}
+
+#endif
@@ -39,168 +39,23 @@ namespace ceres
         //=====================================================================
         
         //---------------------------------------------------------------------
-        // Mapping of state types to constant integer IDs for use in CRTP types
+        // Maps a state type to its constant integer ID: its position in the 
+        // machine's state list; naming a state outside the list fails to compile
 
-        template <int StateID, typename State>
-        struct state_descriptor
-        {
-            constexpr static int    state_id = StateID;
-            typedef State           state_type;
-        };
-
-        //---------------------------------------------------------------------
-        // Creates a list of descriptors from variadic template list
-
-        template <int StateID, typename ...States>
-        struct state_enumerator 
-        {
-            typedef traits::state::null descriptor_type;
-            typedef traits::state::null next_type;
-        };
-
-        template <int StateID, typename State, typename ...States>
-        struct state_enumerator <StateID, State, States...> : 
-        public state_enumerator <StateID+1, States...>
-        {
-            typedef state_descriptor <StateID, State>       descriptor_type;
-            typedef state_enumerator <StateID+1, States...> next_type;
-        };
-
-        //---------------------------------------------------------------------
-        // Recursively creates a single class with per-state overloaded state 
-        // de/activation methods; dependent objects must pre-declare before using
-            
-        template <typename Context, 
-                 typename CurrEnum,
-                 typename NextEnum = typename CurrEnum::next_type>
-
-        struct state_machine_activator : 
-        public state_machine_activator <Context, NextEnum>
-        {
-            typedef state_machine_activator <Context, NextEnum> base;
-
-            typedef typename CurrEnum::descriptor_type          Descriptor;
-            typedef typename Descriptor::state_type             State;
-
-            // introduce base type overloads into this namespace
-            using base::activate;
-            using base::deactivate;    
-
-            template <typename Event> 
-            inline void activate (Context &ctx, Event const &event, core::dispatch_tag<State>)
-            {
-                // dispatch trick uses overload lookup to find needed state descriptor
-                ctx.template activate <Descriptor> (event);
-            }
-
-            inline void activate (Context &ctx, core::dispatch_tag<State>)
-            {
-                // dispatch trick uses overload lookup to find needed state descriptor
-                ctx.template activate <Descriptor> ();
-            }
-
-            inline void deactivate (Context &ctx, core::dispatch_tag<State>)
-            {
-                // dispatch trick uses overload lookup to find needed state descriptor
-                ctx.template deactivate <Descriptor> ();
-            }
-        };
-        
-        template <typename Context, typename CurrEnum>
-        struct state_machine_activator <Context, CurrEnum, traits::state::null>
-        {
-            template <typename Event> 
-            inline void activate (Context &, Event const &, core::dispatch_tag <traits::state::null>) {}
-            inline void activate (Context &, core::dispatch_tag <traits::state::null>) {}
-            inline void deactivate (Context &, core::dispatch_tag <traits::state::null>) {}
-        };
-
-        //---------------------------------------------------------------------
-        // Uses activator class to implement state init/term and event-reactions 
-            
-        template <typename Context, 
-                 typename BaseEnum, 
-                 typename CurrEnum = BaseEnum, 
-                 typename NextEnum = typename CurrEnum::next_type>
-
-        struct state_machine_reactor : 
-        public state_machine_reactor <Context, BaseEnum, NextEnum>
-        {
-            typedef state_machine_reactor <Context, BaseEnum, NextEnum> base;
-            typedef state_machine_activator <Context, BaseEnum> activator;
-
-            // introduce base type overloads into this namespace
-            using base::activate;
-            using base::deactivate;    
-
-            typedef typename CurrEnum::descriptor_type  Descriptor;
-            typedef typename Descriptor::state_type     State;
-
-            template <typename InitialState> 
-            inline void initialize (Context &ctx)
-            {
-                using std::is_same;
-                using core::dispatch_tag;
-
-                if (is_same <InitialState, State>::value)
-                    activate (ctx, dispatch_tag <State> ());
+        template <typename State, typename ...States>
+        struct state_index;
 
-                base::template initialize <State> (ctx);
-            }
+        template <typename State, typename ...States>
+        struct state_index <State, State, States...> :
+        public std::integral_constant <size_t, 0> {};
 
-            inline void terminate (Context &ctx)
-            {
-                using core::dispatch_tag;
+        template <typename State, typename Other, typename ...States>
+        struct state_index <State, Other, States...> :
+        public std::integral_constant <size_t, 1 + state_index <State, States...>::value> {};
 
-                if (ctx.template is_active <Descriptor> ())
-                    deactivate (ctx, dispatch_tag <State> ());
-
-                base::terminate (ctx);
-            }
-
-            template <typename Event> 
-            inline void react (Context &ctx, Event const &event)
-            {
-                using std::is_same;
-                using core::dispatch_tag;
-                using traits::state::null;
-                using traits::state::transition;
-
-                typedef null                                        NullState;
-                typedef State                                       CurrState;
-                typedef typename transition <State, Event>::next    NextState;
-
-                if (!is_same <NextState, NullState>::value && 
-                    ctx.template is_active <Descriptor> ())
-                {
-                    deactivate (ctx, dispatch_tag <CurrState> ());
-                    activate (ctx, event, dispatch_tag <NextState> ());
-                }
-
-                base::template react <Event> (ctx, event);
-            }
-        };
-
-        template <typename Context, typename BaseEnum, typename CurrEnum>
-        struct state_machine_reactor <Context, BaseEnum, CurrEnum, traits::state::null> :
-        public state_machine_activator <Context, BaseEnum>
-        {
-            typedef state_machine_activator <Context, BaseEnum> base;
-
-            // introduce base type overloads into this namespace
-            using base::activate;
-            using base::deactivate;    
-
-            template <typename InitState> 
-            inline void initialize (Context &) {}
-            inline void terminate (Context &) {}
-
-            template <typename Event> 
-            inline void react (Context &, Event const &) {}
-        };
-            
         //---------------------------------------------------------------------
-        // holds all dynamic state context: active state id and state object itself
+        // holds all dynamic state context: active state id and state object 
+        // itself, constructed in place in a buffer suited to every state type
 
         template <typename ...States>
         class singular_context
@@ -208,81 +63,154 @@ namespace ceres
             public:
                 constexpr static size_t nstates = sizeof...(States);
 
-                template <typename Descriptor>
+                size_t active () const
+                {
+                    return active_;
+                }
+
+                template <typename State>
                 inline bool is_active () const
                 {
-                    return curr_active == Descriptor::state_id;
+                    return active_ == state_index <State, States...>::value;
                 }
 
-                template <typename Descriptor>
-                inline void activate ()
+                template <typename State>
+                inline State &get ()
                 {
-                    typedef typename Descriptor::state_type State;
-                    new (reinterpret_cast <void *> (buffer)) State ();
-                    
-                    next_active = Descriptor::state_id;
+                    ASSERTF (is_active <State> (), "accessing inactive state");
+                    return *reinterpret_cast <State *> (&buffer_);
                 }
 
-                template <typename Descriptor, typename Event>
-                inline void activate (Event const &event)
+                template <typename State, typename ...Args>
+                inline void activate (Args const &...args)
                 {
-                    typedef typename Descriptor::state_type State;
-                    new (reinterpret_cast <void *> (buffer)) State (event);
+                    ASSERTF (active_ == nstates, "activating over an active state");
+                    new (reinterpret_cast <void *> (&buffer_)) State (args...);
                     
-                    next_active = Descriptor::state_id;
+                    active_ = state_index <State, States...>::value;
                 }
 
-                template <typename Descriptor>
+                template <typename State>
                 inline void deactivate ()
                 {
-                    typedef typename Descriptor::state_type State;
-                    reinterpret_cast <State *> (buffer)-> ~State();
-                }
+                    get <State> ().~State ();
 
-                void commit ()
-                {
-                    curr_active = next_active;
+                    active_ = nstates;
                 }
 
             private:
-                size_t  curr_active = nstates;
-                size_t  next_active = nstates;
-                uint8_t buffer [core::max_type_size<States...>()];
+                typedef typename std::aligned_storage <
+                    core::max_type_size <States...> (),
+                    core::max_type_align <States...> ()>::type storage;
+
+                size_t  active_ = nstates;
+                storage buffer_;
         };
 
         //---------------------------------------------------------------------
+        // Reactions are resolved through a dense per-event dispatch table 
+        // indexed by active state ID; each row is generated at compile time 
+        // from traits::state::transition, so reacting costs one indirect call.
+        // A transition whose next state throws on construction leaves no state
+        // active; the tables carry a trailing entry for that ID which does nothing
 
         template <typename Default, typename ...States>
         class singular_machine
         {
             public:
-                typedef singular_context <Default, States...>           Context;
-                typedef state_enumerator <0, Default, States...>        Enumeration;
-                typedef state_machine_reactor <Context, Enumeration>    Reactor;
+                typedef singular_context <Default, States...>   Context;
+
+                constexpr static size_t nstates = Context::nstates;
+
+                template <typename Event>
+                using reaction = void (*) (Context &, Event const &);
 
                 singular_machine () 
                 { 
-                    reactor_.template initialize <Default> (context_); 
-                    context_.commit ();
+                    context_.template activate <Default> ();
                 }
 
                 ~singular_machine () 
                 { 
-                    reactor_.terminate (context_); 
+                    deactivate_table [context_.active ()] (context_);
                 }
 
+                singular_machine (singular_machine const &) = delete;
+                singular_machine &operator= (singular_machine const &) = delete;
+
                 template <typename Event> 
                 void react (Event const &event) 
                 { 
-                    reactor_.template react <Event> (context_, event); 
-                    context_.commit ();
+                    constexpr static reaction <Event> table [] = 
+                        { select <Default, Event> (), select <States, Event> ()..., nullptr };
+
+                    auto transit = table [context_.active ()];
+
+                    if (transit)
+                        transit (context_, event);
+                }
+
+                size_t active () const 
+                { 
+                    return context_.active (); 
+                }
+
+                template <typename State>
+                bool is_active () const 
+                { 
+                    return context_.template is_active <State> (); 
+                }
+
+            private:
+                template <typename Curr, typename Next, typename Event>
+                static void transit (Context &ctx, Event const &event)
+                {
+                    ctx.template deactivate <Curr> ();
+                    ctx.template activate <Next> (event);
+                }
+
+                template <typename State>
+                static void deactivate (Context &ctx)
+                {
+                    ctx.template deactivate <State> ();
+                }
+
+                static void deactivate_none (Context &)
+                {
+                }
+
+                // table entry is null when the state has no transition on the event
+                template <typename State, typename Event, 
+                         typename Next = typename traits::state::transition <State, Event>::next>
+                struct selector
+                {
+                    constexpr static reaction <Event> get () { return &transit <State, Next, Event>; }
+                };
+
+                template <typename State, typename Event>
+                struct selector <State, Event, traits::state::null>
+                {
+                    constexpr static reaction <Event> get () { return nullptr; }
+                };
+
+                template <typename State, typename Event>
+                constexpr static reaction <Event> select ()
+                {
+                    return selector <State, Event>::get ();
                 }
 
             private:
-                Context     context_;
-                Reactor     reactor_;
+                constexpr static void (*deactivate_table [nstates + 1]) (Context &) =
+                    { &deactivate <Default>, &deactivate <States>..., &deactivate_none };
+
+                Context context_;
         };
 
+        template <typename Default, typename ...States>
+        constexpr void (*singular_machine <Default, States...>::deactivate_table 
+                [singular_machine <Default, States...>::nstates + 1]) 
+            (typename singular_machine <Default, States...>::Context &);
+
         //---------------------------------------------------------------------
         
         //template <typename ...States>
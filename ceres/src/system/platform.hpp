@@ -4,6 +4,11 @@
 
 #include <platform/posix/error.hpp>
 #include <platform/posix/socket.hpp>
+#include <platform/posix/event.hpp>
+#include <platform/posix/thread.hpp>
+#include <platform/posix/uring.hpp>
+#include <platform/posix/file.hpp>
+#include <platform/posix/pages.hpp>
 
 namespace ceres { namespace system {
 
@@ -0,0 +1,265 @@
+#ifndef _TASK_GRAPH_HPP_
+#define _TASK_GRAPH_HPP_
+
+namespace ceres { namespace task {
+
+    //=========================================================================
+    // Task graph built once and run every frame. Each node counts down its
+    // predecessors atomically; a finishing node releases its successors,
+    // continuing with the first ready one on the same thread and queueing
+    // the rest for other workers to steal. A node whose work returns false
+    // cancels its dependents, which are skipped and cancel theirs in turn.
+    // A node with a deadline that has not started within it of the start of
+    // the run calls its expiry handler instead of its work. Running nodes
+    // may spawn more work, which the run also waits for.
+
+    class graph
+    {
+        public:
+            typedef uint32_t node_id;
+            typedef std::chrono::steady_clock clock;
+
+            typedef std::function <bool ()> work_type;
+            typedef std::function <void ()> expiry_type;
+
+        public:
+            graph () = default;
+            graph (graph const &) = delete;
+            graph &operator= (graph const &) = delete;
+
+        public:
+            // work returning bool decides whether dependents run; void always does
+            template <typename Work>
+            node_id add (Work &&work)
+            {
+                return add_node (wrap (std::forward <Work> (work),
+                            std::is_void <decltype (work ())> {}));
+            }
+
+            // after runs only once before has finished
+            void precede (node_id before, node_id after)
+            {
+                ASSERTF (before < size () && after < size (), "no such node");
+
+                nodes_[before].successors.push_back (after);
+                ++nodes_[after].predecessors;
+                roots_.clear ();
+            }
+
+            // within is measured from the start of each run
+            void set_deadline (node_id id, clock::duration within, expiry_type on_expired)
+            {
+                nodes_[id].deadline = within;
+                nodes_[id].expired = std::move (on_expired);
+            }
+
+            // queues more work from inside a running node
+            void spawn (std::function <void ()> work)
+            {
+                pending_.fetch_add (1, std::memory_order_relaxed);
+                workers_->submit (new spawned {*this, std::move (work)});
+            }
+
+            // runs every node once, helping on the calling thread until done;
+            // a graph with a cycle could never finish, so runs nothing and fails
+            bool run (pool &workers)
+            {
+                if (nodes_.empty ())
+                    return true;
+
+                if (roots_.empty ())
+                {
+                    bool acyclic = find_roots ();
+                    ASSERTF (acyclic, "the graph has a cycle");
+
+                    if (!acyclic)
+                        return false;
+                }
+
+                for (auto &node : nodes_)
+                {
+                    node.remaining.store (node.predecessors, std::memory_order_relaxed);
+                    node.cancelled.store (false, std::memory_order_relaxed);
+                }
+
+                expired_.store (0, std::memory_order_relaxed);
+                cancelled_.store (0, std::memory_order_relaxed);
+                pending_.store (nodes_.size (), std::memory_order_relaxed);
+                workers_ = &workers;
+                start_ = clock::now ();
+
+                for (auto root : roots_)
+                    workers.submit (root);
+
+                workers.help_while ([this]
+                {
+                    return pending_.load (std::memory_order_acquire) > 0;
+                });
+
+                return true;
+            }
+
+        public:
+            size_t size () const { return nodes_.size (); }
+
+            // of the last run
+            size_t expired () const { return expired_.load (std::memory_order_relaxed); }
+            size_t cancelled () const { return cancelled_.load (std::memory_order_relaxed); }
+
+            clock::time_point started () const { return start_; }
+
+        private:
+            struct node : job
+            {
+                node (graph &owner, work_type &&work) :
+                    owner (owner), work (std::move (work)) {}
+
+                void run (pool &workers) override { owner.execute (this, workers); }
+
+                graph                      &owner;
+                work_type                   work;
+                expiry_type                 expired;
+                clock::duration             deadline = clock::duration::zero ();
+
+                std::vector <node_id>       successors;
+                uint32_t                    predecessors = 0;
+
+                std::atomic <uint32_t>      remaining {0};
+                std::atomic <bool>          cancelled {false};
+            };
+
+            struct spawned : job
+            {
+                spawned (graph &owner, std::function <void ()> &&work) :
+                    owner (owner), work (std::move (work)) {}
+
+                void run (pool &) override
+                {
+                    graph &finished = owner;
+                    work ();
+                    delete this;
+                    finished.finish ();
+                }
+
+                graph                      &owner;
+                std::function <void ()>     work;
+            };
+
+        private:
+            template <typename Work>
+            static work_type wrap (Work &&work, std::false_type)
+            {
+                return work_type {std::forward <Work> (work)};
+            }
+
+            template <typename Work>
+            static work_type wrap (Work &&work, std::true_type)
+            {
+                typename std::decay <Work>::type copy {std::forward <Work> (work)};
+                return [copy] () mutable { copy (); return true; };
+            }
+
+            node_id add_node (work_type &&work)
+            {
+                nodes_.emplace_back (*this, std::move (work));
+                roots_.clear ();
+
+                return nodes_.size () - 1;
+            }
+
+            // sorts the nodes topologically, keeping those without predecessors;
+            // a sort that reaches fewer than every node has found a cycle
+            bool find_roots ()
+            {
+                std::vector <uint32_t> remaining (nodes_.size ());
+                std::vector <node_id> sorted;
+
+                for (node_id id = 0; id < nodes_.size (); ++id)
+                {
+                    remaining[id] = nodes_[id].predecessors;
+
+                    if (remaining[id] == 0)
+                    {
+                        sorted.push_back (id);
+                        roots_.push_back (&nodes_[id]);
+                    }
+                }
+
+                for (size_t i = 0; i < sorted.size (); ++i)
+                    for (auto id : nodes_[sorted[i]].successors)
+                        if (--remaining[id] == 0)
+                            sorted.push_back (id);
+
+                if (sorted.size () < nodes_.size ())
+                    roots_.clear ();
+
+                return !roots_.empty ();
+            }
+
+            void execute (node *current, pool &workers)
+            {
+                while (current)
+                {
+                    bool proceed = false;
+
+                    if (current->cancelled.load (std::memory_order_relaxed))
+                        cancelled_.fetch_add (1, std::memory_order_relaxed);
+
+                    else if (current->deadline != clock::duration::zero () &&
+                            clock::now () - start_ > current->deadline)
+                    {
+                        expired_.fetch_add (1, std::memory_order_relaxed);
+                        proceed = true;
+
+                        if (current->expired)
+                            current->expired ();
+                    }
+                    else
+                        proceed = current->work ();
+
+                    node *next = nullptr;
+
+                    for (auto id : current->successors)
+                    {
+                        node &successor = nodes_[id];
+
+                        if (!proceed)
+                            successor.cancelled.store (true, std::memory_order_relaxed);
+
+                        // the release orders the cancellation and this node's
+                        // results before the successor runs
+                        if (successor.remaining.fetch_sub (1, std::memory_order_acq_rel) == 1)
+                        {
+                            if (next)
+                                workers.submit (&successor);
+                            else
+                                next = &successor;
+                        }
+                    }
+
+                    finish ();
+                    current = next;
+                }
+            }
+
+            // the run may return, and the graph be reused, once this hits zero
+            void finish ()
+            {
+                pending_.fetch_sub (1, std::memory_order_acq_rel);
+            }
+
+        private:
+            std::deque <node>               nodes_;     // stable addresses for queued nodes
+            std::vector <node *>            roots_;
+
+            pool                           *workers_ = nullptr;
+            clock::time_point               start_;
+
+            std::atomic <size_t>            pending_ {0};
+            std::atomic <size_t>            expired_ {0};
+            std::atomic <size_t>            cancelled_ {0};
+    };
+
+} }
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef _TASK_POOL_HPP_
+#define _TASK_POOL_HPP_
+
+namespace ceres { namespace task {
+
+    class pool;
+
+    //=========================================================================
+    // Unit of work queued on the pool; owned by whoever queued it
+
+    struct job
+    {
+        virtual ~job () {}
+        virtual void run (pool &workers) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    // Chase-Lev work-stealing deque of fixed capacity: the owner pushes and
+    // pops at the bottom, thieves take from the top. Orderings follow Le et
+    // al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+
+    class steal_deque
+    {
+        public:
+            explicit steal_deque (size_t capacity) :
+                jobs_ (size_t (1) << core::bit::log2_ceil (capacity)), mask_ {jobs_.size () - 1} {}
+
+        public:
+            // owner only; false when full
+            bool push (job *item)
+            {
+                auto bottom = bottom_.load (std::memory_order_relaxed);
+                auto top = top_.load (std::memory_order_acquire);
+
+                if (bottom - top > int64_t (mask_))
+                    return false;
+
+                // a release store rather than the paper's fence, which race
+                // detectors model; the same instructions on x86
+                jobs_[bottom & mask_].store (item, std::memory_order_relaxed);
+                bottom_.store (bottom + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            // owner only; most recently pushed first
+            job *pop ()
+            {
+                auto bottom = bottom_.load (std::memory_order_relaxed) - 1;
+                bottom_.store (bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+                auto top = top_.load (std::memory_order_relaxed);
+
+                if (top > bottom)
+                {
+                    bottom_.store (bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                job *item = jobs_[bottom & mask_].load (std::memory_order_relaxed);
+
+                if (top == bottom)
+                {
+                    // last item: race the thieves for it
+                    if (!top_.compare_exchange_strong (top, top + 1,
+                                std::memory_order_seq_cst, std::memory_order_relaxed))
+                        item = nullptr;
+
+                    bottom_.store (bottom + 1, std::memory_order_relaxed);
+                }
+
+                return item;
+            }
+
+            // any thread; oldest first
+            job *steal ()
+            {
+                auto top = top_.load (std::memory_order_acquire);
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+                auto bottom = bottom_.load (std::memory_order_acquire);
+
+                if (top >= bottom)
+                    return nullptr;
+
+                job *item = jobs_[top & mask_].load (std::memory_order_relaxed);
+
+                if (!top_.compare_exchange_strong (top, top + 1,
+                            std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+
+                return item;
+            }
+
+            bool empty () const
+            {
+                return bottom_.load (std::memory_order_relaxed) <= top_.load (std::memory_order_relaxed);
+            }
+
+        private:
+            std::vector <std::atomic <job *>>   jobs_;
+            size_t                              mask_;
+
+            // padded apart so the owner and thieves don't share a line; padding
+            // rather than alignas keeps the deque allocatable with plain new
+            char                                before_top_ [memory::cache_line_size];
+            std::atomic <int64_t>               top_ {0};
+            char                                after_top_ [memory::cache_line_size - sizeof (int64_t)];
+            std::atomic <int64_t>               bottom_ {0};
+            char                                after_bottom_ [memory::cache_line_size - sizeof (int64_t)];
+    };
+
+    //=========================================================================
+    // Work-stealing thread pool. Each worker owns a deque; jobs queued from
+    // a worker go on its own deque, and from other threads on a shared
+    // injection queue. Idle workers steal from the others, then sleep until
+    // more work is queued. Threads outside the pool can help with help_while.
+
+    class pool
+    {
+        public:
+            explicit pool (size_t threads = system::thread::core_count (), size_t capacity = 4096)
+            {
+                threads = std::max <size_t> (threads, 1);
+
+                for (size_t index = 0; index < threads; ++index)
+                    deques_.emplace_back (new steal_deque {capacity});
+
+                for (size_t index = 0; index < threads; ++index)
+                    threads_.emplace_back (&pool::work, this, index);
+            }
+
+            ~pool ()
+            {
+                {
+                    std::lock_guard <std::mutex> lock {mutex_};
+                    running_ = false;
+                }
+
+                wake_.notify_all ();
+
+                for (auto &thread : threads_)
+                    thread.join ();
+            }
+
+            pool (pool const &) = delete;
+            pool &operator= (pool const &) = delete;
+
+        public:
+            // deques are all built before any thread starts, so workers may read this
+            size_t size () const { return deques_.size (); }
+
+            // index of the calling worker, or size () off the pool
+            size_t current () const
+            {
+                return current_pool () == this? current_index () : size ();
+            }
+
+            // queues a job; from a worker it is pushed on that worker's deque
+            void submit (job *item)
+            {
+                size_t index = current ();
+
+                if (index == size () || !deques_[index]->push (item))
+                {
+                    std::lock_guard <std::mutex> lock {injected_mutex_};
+                    injected_.push_back (item);
+                    injected_size_.fetch_add (1, std::memory_order_relaxed);
+                }
+
+                queued_.fetch_add (1, std::memory_order_seq_cst);
+                notify ();
+            }
+
+            // runs queued jobs on the calling thread while the condition holds
+            template <typename Condition>
+            void help_while (Condition &&condition)
+            {
+                size_t spins = 0;
+
+                while (condition ())
+                {
+                    if (job *item = find (current ()))
+                    {
+                        item->run (*this);
+                        spins = 0;
+                    }
+                    else if (++spins > spin_limit)
+                        std::this_thread::yield ();
+                }
+            }
+
+        private:
+            void work (size_t index)
+            {
+                current_pool () = this;
+                current_index () = index;
+
+                size_t spins = 0;
+
+                while (running_.load (std::memory_order_relaxed))
+                {
+                    if (job *item = find (index))
+                    {
+                        item->run (*this);
+                        spins = 0;
+                        continue;
+                    }
+
+                    if (++spins < spin_limit)
+                        continue;
+
+                    // sleepers is raised before queued is checked and submit
+                    // raises queued before checking sleepers, so one sees the other
+                    std::unique_lock <std::mutex> lock {mutex_};
+                    sleepers_.fetch_add (1, std::memory_order_seq_cst);
+
+                    wake_.wait (lock, [this]
+                    {
+                        return !running_ || queued_.load (std::memory_order_seq_cst) > 0;
+                    });
+
+                    sleepers_.fetch_sub (1, std::memory_order_relaxed);
+                    spins = 0;
+                }
+            }
+
+            // own deque first, then the injection queue, then the others
+            job *find (size_t index)
+            {
+                job *item = nullptr;
+
+                if (index < size ())
+                    item = deques_[index]->pop ();
+
+                if (!item && injected_size_.load (std::memory_order_relaxed) > 0)
+                {
+                    std::lock_guard <std::mutex> lock {injected_mutex_};
+
+                    if (!injected_.empty ())
+                    {
+                        item = injected_.front ();
+                        injected_.pop_front ();
+                        injected_size_.fetch_sub (1, std::memory_order_relaxed);
+                    }
+                }
+
+                for (size_t offset = 1; !item && offset <= size (); ++offset)
+                    item = deques_[(index + offset) % size ()]->steal ();
+
+                if (item)
+                    queued_.fetch_sub (1, std::memory_order_relaxed);
+
+                return item;
+            }
+
+            void notify ()
+            {
+                if (sleepers_.load (std::memory_order_seq_cst) > 0)
+                {
+                    // the lock orders this after a sleeper's check of queued
+                    { std::lock_guard <std::mutex> lock {mutex_}; }
+                    wake_.notify_one ();
+                }
+            }
+
+            static pool *&current_pool () { static thread_local pool *current = nullptr; return current; }
+            static size_t &current_index () { static thread_local size_t index = 0; return index; }
+
+        private:
+            constexpr static size_t spin_limit = 256;
+
+        private:
+            std::vector <std::unique_ptr <steal_deque>> deques_;
+            std::vector <std::thread>                   threads_;
+
+            std::mutex                                  injected_mutex_;
+            std::deque <job *>                          injected_;
+            std::atomic <size_t>                        injected_size_ {0};
+
+            // may dip below zero while a stolen job's submit is in flight
+            std::atomic <int64_t>                       queued_ {0};
+            std::atomic <size_t>                        sleepers_ {0};
+            std::atomic <bool>                          running_ {true};
+            std::mutex                                  mutex_;
+            std::condition_variable                     wake_;
+    };
+
+} }
+
+#endif
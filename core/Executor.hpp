@@ -3,22 +3,26 @@
 
 #include <chrono>
 
+#include "core/common.hpp"
 #include "core/Handle.hpp"
 
 namespace core {
 
-class Executor {
+template <template <typename> class Function = Handler>
+class BasicExecutor {
  public:
-  using Work = std::function<void()>;
+  using Work = Function<void()>;
   using Duration = std::chrono::milliseconds;
   using Handle = core::Handle<uint64_t>;
 
  public:
-  virtual ~Executor() {}
+  virtual ~BasicExecutor() {}
   virtual bool Remove(Handle handle) = 0;
   virtual Handle Schedule(Work item, Duration expiry = {}, Duration period = {}) = 0;
 };
 
+using Executor = BasicExecutor<>;
+
 }  // namespace core
 
 #endif
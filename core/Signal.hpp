@@ -6,23 +6,31 @@
 namespace core {
 
 inline namespace signal {
-template<typename ...Args> class Slot;
-template<typename ...Args> class Signal;
+template <template <typename> class Function, typename ...Args> class BasicSlot;
+template <template <typename> class Function, typename ...Args> class BasicSignal;
 
-using handle_type = uint8_t;
+// Signals and slots whose handlers are Handler; name another Function,
+// e.g. an inplace_function alias, for handlers that never allocate.
+template <typename ...Args>
+using Signal = BasicSignal<Handler, Args...>;
 
 template <typename ...Args>
-class Signal final {
+using Slot = BasicSlot<Handler, Args...>;
+
+using handle_type = uint8_t;
+
+template <template <typename> class Function, typename ...Args>
+class BasicSignal final {
  public:
-  Signal() = default;
+  BasicSignal() = default;
 
-  Signal(Signal &&) = delete;
-  Signal &operator=(Signal &&) = delete;
+  BasicSignal(BasicSignal &&) = delete;
+  BasicSignal &operator=(BasicSignal &&) = delete;
 
-  Signal(const Signal &) = delete;
-  Signal &operator=(const Signal &) = delete;
+  BasicSignal(const BasicSignal &) = delete;
+  BasicSignal &operator=(const BasicSignal &) = delete;
 
-  ~Signal();
+  ~BasicSignal();
 
  public:
   size_t connection_count() const;
@@ -47,39 +55,39 @@ class Signal final {
   void clear();
 
  public:
-  void connect(Slot<Args...> &slot);  // NOLINT
-  void connect(Slot<Args...> *slot);
-  void disconnect(Slot<Args...> &slot);  // NOLINT
-  void disconnect(Slot<Args...> *slot);
+  void connect(BasicSlot<Function, Args...> &slot);  // NOLINT
+  void connect(BasicSlot<Function, Args...> *slot);
+  void disconnect(BasicSlot<Function, Args...> &slot);  // NOLINT
+  void disconnect(BasicSlot<Function, Args...> *slot);
 
  public:
-  void forward(Signal<Args...> &target);  // NOLINT
-  void forward(Signal<Args...> *target);
-  void disconnect(Signal<Args...> &signal);  // NOLINT
-  void disconnect(Signal<Args...> *signal);
+  void forward(BasicSignal<Function, Args...> &target);  // NOLINT
+  void forward(BasicSignal<Function, Args...> *target);
+  void disconnect(BasicSignal<Function, Args...> &signal);  // NOLINT
+  void disconnect(BasicSignal<Function, Args...> *signal);
 
  private:
-  std::array<std::function<void(Args...)>, 4> handlers_;
+  std::array<Function<void(Args...)>, 4> handlers_;
 
  private:
   std::set<handle_type> whenhandles_;
   std::set<handle_type> oncehandles_;
-  std::set<Signal<Args...> *> signals_;
-  std::set<Slot<Args...> *> slots_;
+  std::set<BasicSignal<Function, Args...> *> signals_;
+  std::set<BasicSlot<Function, Args...> *> slots_;
 };
 
-template <typename ...Args>
-class Slot final {
+template <template <typename> class Function, typename ...Args>
+class BasicSlot final {
  public:
-  Slot() = default;
+  BasicSlot() = default;
 
-  Slot(const Slot &) = delete;
-  Slot &operator=(const Slot &) = delete;
+  BasicSlot(const BasicSlot &) = delete;
+  BasicSlot &operator=(const BasicSlot &) = delete;
 
-  Slot(Slot &&) = delete;
-  Slot &operator=(Slot &&) = delete;
+  BasicSlot(BasicSlot &&) = delete;
+  BasicSlot &operator=(BasicSlot &&) = delete;
 
-  ~Slot();
+  ~BasicSlot();
 
  public:
   size_t connection_count() const;
@@ -108,70 +116,70 @@ class Slot final {
   void clear();
 
  public:
-  void connect(Signal<Args...> &signal);  // NOLINT
-  void connect(Signal<Args...> *signal);
-  void disconnect(Signal<Args...> &signal);  // NOLINT
-  void disconnect(Signal<Args...> *signal);
+  void connect(BasicSignal<Function, Args...> &signal);  // NOLINT
+  void connect(BasicSignal<Function, Args...> *signal);
+  void disconnect(BasicSignal<Function, Args...> &signal);  // NOLINT
+  void disconnect(BasicSignal<Function, Args...> *signal);
 
  private:
-  std::vector<std::function<void(Args...)>> whenhandlers_;
-  std::vector<std::function<void(Args...)>> oncehandlers_;
+  std::vector<Function<void(Args...)>> whenhandlers_;
+  std::vector<Function<void(Args...)>> oncehandlers_;
 
  private:
-  std::map<Signal<Args...> *, std::vector<handle_type>> handlemap_;
+  std::map<BasicSignal<Function, Args...> *, std::vector<handle_type>> handlemap_;
 };
 
 
-template <typename ...Args, typename Functional>
-handle_type when(Signal<Args...> &signal, Functional &&functional) {
+template <template <typename> class Function, typename ...Args, typename Functional>
+handle_type when(BasicSignal<Function, Args...> &signal, Functional &&functional) {
   return signal.when(functional);
 }
 
-template <typename ...Args, typename Functional>
-handle_type once(Signal<Args...> &signal, Functional &&functional) {
+template <template <typename> class Function, typename ...Args, typename Functional>
+handle_type once(BasicSignal<Function, Args...> &signal, Functional &&functional) {
   return signal.once(functional);
 }
 
-template <typename ...Args, typename Functional>
-void when(Slot<Args...> &slot, Functional &&functional) {
+template <template <typename> class Function, typename ...Args, typename Functional>
+void when(BasicSlot<Function, Args...> &slot, Functional &&functional) {
   slot.when(functional);
 }
 
-template <typename ...Args, typename Functional>
-void once(Slot<Args...> &slot, Functional &&functional) {
+template <template <typename> class Function, typename ...Args, typename Functional>
+void once(BasicSlot<Function, Args...> &slot, Functional &&functional) {
   slot.once(functional);
 }
 
-template <typename ...Args>
-void connect(Signal<Args...> &signal, Slot<Args...> &slot) {
+template <template <typename> class Function, typename ...Args>
+void connect(BasicSignal<Function, Args...> &signal, BasicSlot<Function, Args...> &slot) {
   slot.connect(signal);
   signal.connect(slot);
 }
 
-template <typename ...Args>
-void connect(Slot<Args...> &slot, Signal<Args...> &signal) {
+template <template <typename> class Function, typename ...Args>
+void connect(BasicSlot<Function, Args...> &slot, BasicSignal<Function, Args...> &signal) {
   slot.connect(signal);
   signal.connect(slot);
 }
 
-template <typename ...Args>
-void disconnect(Signal<Args...> &signal) {
+template <template <typename> class Function, typename ...Args>
+void disconnect(BasicSignal<Function, Args...> &signal) {
   signal.disconnect();
 }
 
-template <typename ...Args>
-void disconnect(Slot<Args...> &slot) {
+template <template <typename> class Function, typename ...Args>
+void disconnect(BasicSlot<Function, Args...> &slot) {
   slot.disconnect();
 }
 
-template <typename ...Args>
-void disconnect(Signal<Args...> &signal, Slot<Args...> &slot) {
+template <template <typename> class Function, typename ...Args>
+void disconnect(BasicSignal<Function, Args...> &signal, BasicSlot<Function, Args...> &slot) {
   slot.disconnect(signal);
   signal.disconnect(slot);
 }
 
-template <typename ...Args>
-void disconnect(Slot<Args...> &slot, Signal<Args...> &signal) {
+template <template <typename> class Function, typename ...Args>
+void disconnect(BasicSlot<Function, Args...> &slot, BasicSignal<Function, Args...> &signal) {
   slot.disconnect(signal);
   signal.disconnect(slot);
 }
@@ -186,7 +194,7 @@ handle_type install(Handlers &handlers, Functional &&functional) {  // NOLINT
   assert(handler != end(handlers) && "Exceeded maximum active handlers");
   *handler = functional;
 
-  auto index = distance(begin(handlers), handler);
+  auto index = std::distance(begin(handlers), handler);
   assert(index <= static_cast<handle_type>(-1) && "Exceeded indexable handle range");
 
   return static_cast<handle_type>(index);
@@ -197,7 +205,7 @@ void erase(Handlers &handlers, handle_type index) {  // NOLINT
   assert(index < handlers.size() && "Exceeded handler bounds");
 
   auto handler = begin(handlers);
-  advance(handler, index);
+  std::advance(handler, index);
 
   *handler = nullptr;
 }
@@ -205,29 +213,29 @@ void erase(Handlers &handlers, handle_type index) {  // NOLINT
 }  // namespace
 
 
-template <typename ...Args>
-Signal<Args...>::~Signal() {
+template <template <typename> class Function, typename ...Args>
+BasicSignal<Function, Args...>::~BasicSignal() {
   disconnect();
 }
 
-template <typename ...Args>
-size_t Signal<Args...>::connection_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSignal<Function, Args...>::connection_count() const {
   return slots_.size() + signals_.size();
 }
 
-template <typename ...Args>
-size_t Signal<Args...>::when_handler_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSignal<Function, Args...>::when_handler_count() const {
   return whenhandles_.size();
 }
 
-template <typename ...Args>
-size_t Signal<Args...>::once_handler_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSignal<Function, Args...>::once_handler_count() const {
   return oncehandles_.size();
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename ...DeducedArgs>
-void Signal<Args...>::operator()(DeducedArgs &&...args) {
+void BasicSignal<Function, Args...>::operator()(DeducedArgs &&...args) {
   for (const auto &handler : handlers_) {
     if (handler) {
       handler(args...);
@@ -245,32 +253,32 @@ void Signal<Args...>::operator()(DeducedArgs &&...args) {
   oncehandles_.clear();
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template<typename Functional>
-handle_type Signal<Args...>::when(Functional &&functional) {
+handle_type BasicSignal<Function, Args...>::when(Functional &&functional) {
   auto handle = install(handlers_, functional);
   whenhandles_.insert(handle);
   return handle;
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template<typename Functional>
-handle_type Signal<Args...>::once(Functional &&functional) {
+handle_type BasicSignal<Function, Args...>::once(Functional &&functional) {
   auto handle = install(handlers_, functional);
   oncehandles_.insert(handle);
   return handle;
 }
 
-template <typename ...Args>
-void Signal<Args...>::remove(handle_type handle) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::remove(handle_type handle) {
   assert(handle < handlers_.size() && "Invalid handle");
   erase(handlers_, handle);
   whenhandles_.erase(handle);
   oncehandles_.erase(handle);
 }
 
-template <typename ...Args>
-void Signal<Args...>::disconnect() {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::disconnect() {
   for (auto slot : slots_) {
     slot->disconnect(this);
   }
@@ -282,8 +290,8 @@ void Signal<Args...>::disconnect() {
   signals_.clear();
 }
 
-template <typename ...Args>
-void Signal<Args...>::clear() {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::clear() {
   disconnect();
   for (auto &handler : handlers_) {
     handler = nullptr;
@@ -292,70 +300,70 @@ void Signal<Args...>::clear() {
   oncehandles_.clear();
 }
 
-template <typename ...Args>
-void Signal<Args...>::connect(Slot<Args...> &slot) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::connect(BasicSlot<Function, Args...> &slot) {
   connect(&slot);
 }
 
-template <typename ...Args>
-void Signal<Args...>::connect(Slot<Args...> *slot) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::connect(BasicSlot<Function, Args...> *slot) {
   slots_.insert(slot);
 }
 
-template <typename ...Args>
-void Signal<Args...>::disconnect(Slot<Args...> &slot) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::disconnect(BasicSlot<Function, Args...> &slot) {
   disconnect(&slot);
 }
 
-template <typename ...Args>
-void Signal<Args...>::disconnect(Slot<Args...> *slot) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::disconnect(BasicSlot<Function, Args...> *slot) {
   slots_.erase(slot);
 }
 
-template <typename ...Args>
-void Signal<Args...>::forward(Signal<Args...> &target) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::forward(BasicSignal<Function, Args...> &target) {
   forward(&target);
 }
 
-template <typename ...Args>
-void Signal<Args...>::forward(Signal<Args...> *target) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::forward(BasicSignal<Function, Args...> *target) {
   signals_.insert(target);
 }
 
-template <typename ...Args>
-void Signal<Args...>::disconnect(Signal<Args...> &target) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::disconnect(BasicSignal<Function, Args...> &target) {
   disconnect(&target);
 }
 
-template <typename ...Args>
-void Signal<Args...>::disconnect(Signal<Args...> *target) {
+template <template <typename> class Function, typename ...Args>
+void BasicSignal<Function, Args...>::disconnect(BasicSignal<Function, Args...> *target) {
   signals_.erase(target);
 }
 
 
-template <typename ...Args>
-Slot<Args...>::~Slot() {
+template <template <typename> class Function, typename ...Args>
+BasicSlot<Function, Args...>::~BasicSlot() {
   disconnect();
 }
 
-template <typename ...Args>
-size_t Slot<Args...>::connection_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSlot<Function, Args...>::connection_count() const {
   return handlemap_.size();
 }
 
-template <typename ...Args>
-size_t Slot<Args...>::when_handler_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSlot<Function, Args...>::when_handler_count() const {
   return whenhandlers_.size();
 }
 
-template <typename ...Args>
-size_t Slot<Args...>::once_handler_count() const {
+template <template <typename> class Function, typename ...Args>
+size_t BasicSlot<Function, Args...>::once_handler_count() const {
   return oncehandlers_.size();
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename Functional>
-void Slot<Args...>::when(Functional &&functional) {
+void BasicSlot<Function, Args...>::when(Functional &&functional) {
   for (auto &map : handlemap_) {
     auto signal = map.first;
     auto &handles = map.second;
@@ -366,9 +374,9 @@ void Slot<Args...>::when(Functional &&functional) {
   whenhandlers_.emplace_back(functional);
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename Functional>
-void Slot<Args...>::once(Functional &&functional) {
+void BasicSlot<Function, Args...>::once(Functional &&functional) {
   for (auto &map : handlemap_) {
     auto signal = map.first;
     auto &handles = map.second;
@@ -379,26 +387,26 @@ void Slot<Args...>::once(Functional &&functional) {
   oncehandlers_.emplace_back(functional);
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename Functional>
-void Slot<Args...>::operator*=(Functional &&functional) {
+void BasicSlot<Function, Args...>::operator*=(Functional &&functional) {
   when(functional);
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename Functional>
-void Slot<Args...>::operator+=(Functional &&functional) {
+void BasicSlot<Function, Args...>::operator+=(Functional &&functional) {
   once(functional);
 }
 
-template <typename ...Args>
+template <template <typename> class Function, typename ...Args>
 template <typename ...DeducedArgs>
-void Slot<Args...>::operator()(DeducedArgs &&...args) {
+void BasicSlot<Function, Args...>::operator()(DeducedArgs &&...args) {
   oncehandlers_.clear();
 }
 
-template <typename ...Args>
-void Slot<Args...>::disconnect() {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::disconnect() {
   for (auto &map : handlemap_) {
     auto signal = map.first;
     for (auto handle : map.second) {
@@ -408,20 +416,20 @@ void Slot<Args...>::disconnect() {
   }
 }
 
-template <typename ...Args>
-void Slot<Args...>::clear() {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::clear() {
   disconnect();
   whenhandlers_.clear();
   oncehandlers_.clear();
 }
 
-template <typename ...Args>
-void Slot<Args...>::connect(Signal<Args...> &signal) {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::connect(BasicSignal<Function, Args...> &signal) {
   connect(&signal);
 }
 
-template <typename ...Args>
-void Slot<Args...>::connect(Signal<Args...> *signal) {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::connect(BasicSignal<Function, Args...> *signal) {
   auto &handles = handlemap_[signal];
 
   for (const auto &handler : whenhandlers_) {
@@ -433,13 +441,13 @@ void Slot<Args...>::connect(Signal<Args...> *signal) {
   }
 }
 
-template <typename ...Args>
-void Slot<Args...>::disconnect(Signal<Args...> &signal) {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::disconnect(BasicSignal<Function, Args...> &signal) {
   disconnect(&signal);
 }
 
-template <typename ...Args>
-void Slot<Args...>::disconnect(Signal<Args...> *signal) {
+template <template <typename> class Function, typename ...Args>
+void BasicSlot<Function, Args...>::disconnect(BasicSignal<Function, Args...> *signal) {
   for (auto handle : handlemap_[signal]) {
     signal->remove(handle);
   }
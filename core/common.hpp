@@ -5,6 +5,12 @@ using namespace std::literals;  // NOLINT
 
 namespace core {
 
+// Callable type of signal handlers and executor work by default. The Basic
+// signal, slot and executor templates take any other with std::function's
+// interface.
+template <typename Signature>
+using Handler = std::function<Signature>;
+
 inline void tolower(std::string &str) {  // NOLINT
   for (auto &ch : str) {
     ch = std::tolower(ch);
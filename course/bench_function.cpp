@@ -0,0 +1,104 @@
+// Compares inplace_function with std::function.
+//
+//   construct: make and drop a function from a lambda capturing 8 bytes,
+//              which both keep inline, and 24, which std::function
+//              allocates for
+//   invoke:    call each of a set of functions in turn
+//   copy:      copy a set of functions, as signals install handlers
+//
+// `c++ --std=c++14 -O2 bench_function.cpp -o bench_function`
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "soln_function.cpp"
+
+template <typename Function>
+double nanoseconds(size_t n, Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         n;
+}
+
+void report(const char *name, double ns) {
+  std::cout << "  " << name << std::string(24 - std::strlen(name), ' ') << ns
+            << "\n";
+}
+
+volatile int sink = 0;
+
+template <typename Function, size_t Bytes>
+double construct(size_t n) {
+  std::array<uint64_t, Bytes / 8> capture{};
+  capture[0] = 1;
+  return nanoseconds(n, [&] {
+    for (size_t i = 0; i < n; ++i) {
+      Function f{[capture](int v) { return v + capture[0]; }};
+      sink = f(i);
+    }
+  });
+}
+
+template <typename Function>
+std::vector<Function> make(size_t count) {
+  std::vector<Function> functions;
+  for (size_t i = 0; i < count; ++i) {
+    std::array<uint64_t, 3> capture{};
+    capture[0] = i;
+    functions.emplace_back([capture](int v) { return v + capture[0]; });
+  }
+  return functions;
+}
+
+template <typename Function>
+double invoke(size_t n) {
+  auto functions = make<Function>(64);
+  return nanoseconds(n, [&] {
+    int total = 0;
+    for (size_t i = 0; i < n; ++i) {
+      total += functions[i % functions.size()](i);
+    }
+    sink = total;
+  });
+}
+
+template <typename Function>
+double copy(size_t n) {
+  auto functions = make<Function>(64);
+  return nanoseconds(n, [&] {
+    for (size_t i = 0; i < n / functions.size(); ++i) {
+      auto copied = functions;
+      sink = copied.back()(1);
+    }
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::stoul(argv[1]) : 10000000;
+
+  using standard = std::function<int(int)>;
+  using inplace = inplace_function<int(int)>;
+
+  std::cout << "construct (ns)\n";
+  report("std::function, 8", construct<standard, 8>(n));
+  report("inplace_function, 8", construct<inplace, 8>(n));
+  report("std::function, 24", construct<standard, 24>(n));
+  report("inplace_function, 24", construct<inplace, 24>(n));
+
+  std::cout << "invoke (ns)\n";
+  report("std::function", invoke<standard>(n));
+  report("inplace_function", invoke<inplace>(n));
+
+  std::cout << "copy (ns per function)\n";
+  report("std::function", copy<standard>(n));
+  report("inplace_function", copy<inplace>(n));
+}
@@ -0,0 +1,104 @@
+// Compares vector with std::vector.
+//
+//   push:     many short vectors, push_back until N each, then dropped
+//   large:    one vector, push_back to tens of millions of items, where
+//             growth is dominated by moving the buffer
+//   relocate: as push, of unique_ptr, which memcpy relocation moves as bytes
+//
+// `c++ --std=c++14 -O2 bench_vector.cpp -o bench_vector`
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "soln_vector.cpp"
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename Function>
+double milliseconds(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void report(const char *name, double ms) {
+  std::cout << "  " << name << std::string(24 - std::strlen(name), ' ') << ms
+            << "\n";
+}
+
+template <typename Vector>
+double push(size_t vectors, size_t n) {
+  size_t sum = 0;
+  double time = milliseconds([&] {
+    for (size_t v = 0; v < vectors; ++v) {
+      Vector p;
+      for (size_t i = 0; i < n; ++i) {
+        p.push_back(i);
+      }
+      sum += p.back();
+    }
+  });
+  return sum ? time : 0;
+}
+
+template <typename Vector>
+double large(size_t n) {
+  size_t sum = 0;
+  double time = milliseconds([&] {
+    Vector p;
+    for (size_t i = 0; i < n; ++i) {
+      p.emplace_back(i);
+    }
+    sum += p.back();
+  });
+  return sum ? time : 0;
+}
+
+template <typename Vector>
+double relocate(size_t vectors, size_t n) {
+  size_t sum = 0;
+  double time = milliseconds([&] {
+    for (size_t v = 0; v < vectors; ++v) {
+      Vector p;
+      for (size_t i = 0; i < n; ++i) {
+        p.emplace_back(new int(i));
+      }
+      sum += *p.back();
+    }
+  });
+  return sum ? time : 0;
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::stoul(argv[1]) : 1000;
+  size_t vectors = argc > 2 ? std::stoul(argv[2]) : 10000;
+  size_t big = argc > 3 ? std::stoul(argv[3]) : 1 << 26;
+
+  using items = int;
+  using owners = std::unique_ptr<int>;
+  using slow_growing = vector<items, std::allocator<items>, std::ratio<3, 2>>;
+  using reallocated = vector<items, realloc_allocator<items>>;
+
+  std::cout << "push " << vectors << " x " << n << " ints (ms)\n";
+  report("std::vector", push<std::vector<items>>(vectors, n));
+  report("vector", push<vector<items>>(vectors, n));
+  report("vector, growth 3/2", push<slow_growing>(vectors, n));
+  report("vector, realloc", push<reallocated>(vectors, n));
+
+  std::cout << "large " << big << " ints (ms)\n";
+  report("std::vector", large<std::vector<items>>(big));
+  report("vector", large<vector<items>>(big));
+  report("vector, realloc/mremap", large<reallocated>(big));
+
+  std::cout << "relocate " << vectors / 10 << " x " << n
+            << " unique_ptrs (ms)\n";
+  report("std::vector", relocate<std::vector<owners>>(vectors / 10, n));
+  report("vector, memcpy", relocate<vector<owners>>(vectors / 10, n));
+}
@@ -1,5 +1,9 @@
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 namespace impl {
 
@@ -63,3 +67,183 @@ class function<R(P...)> final {
   std::unique_ptr<impl::function_interface<R(P...)>> target_;
 };
 
+namespace impl {
+
+// what an inplace_function does with the callable in its storage, one
+// table per callable type
+template <typename R, typename... P>
+struct inplace_operations {
+  R (*invoke)(void* storage, P&&... params);
+  void (*copy)(void* to, const void* from);
+  void (*relocate)(void* to, void* from);  // move and destroy the source
+  void (*destroy)(void* storage);
+};
+
+template <typename Callable, typename R, typename... P>
+struct inplace_callable {
+  static R invoke(void* storage, P&&... params) {
+    return (*static_cast<Callable*>(storage))(std::forward<P>(params)...);
+  }
+
+  static void copy(void* to, const void* from) {
+    new (to) Callable(*static_cast<const Callable*>(from));
+  }
+
+  static void relocate(void* to, void* from) {
+    new (to) Callable(std::move(*static_cast<Callable*>(from)));
+    static_cast<Callable*>(from)->~Callable();
+  }
+
+  static void destroy(void* storage) {
+    static_cast<Callable*>(storage)->~Callable();
+  }
+
+  static constexpr inplace_operations<R, P...> operations{&invoke, &copy,
+                                                          &relocate, &destroy};
+};
+
+template <typename Callable, typename R, typename... P>
+constexpr inplace_operations<R, P...>
+    inplace_callable<Callable, R, P...>::operations;
+
+// whether a Callable lvalue can be called as the signature says
+template <typename Callable, typename Signature, typename = void>
+struct is_callable_as : std::false_type {};
+
+template <typename Callable, typename R, typename... P>
+struct is_callable_as<
+    Callable, R(P...),
+    std::enable_if_t<std::is_void<R>::value ||
+                     std::is_convertible<decltype(std::declval<Callable&>()(
+                                             std::declval<P>()...)),
+                                         R>::value>> : std::true_type {};
+
+// function pointers may be null, other callables may not
+template <typename Callable>
+bool is_null(Callable callable, std::true_type) {
+  return callable == nullptr;
+}
+
+template <typename Callable>
+bool is_null(const Callable&, std::false_type) {
+  return false;
+}
+
+}  // namespace impl
+
+// As function, with the callable stored in Capacity bytes inside the
+// object rather than on the heap: it never allocates, moving it moves the
+// callable between buffers, and a callable that doesn't fit fails to
+// compile. Constructing one from a null function pointer leaves it empty.
+template <typename, size_t Capacity = 32,
+          size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+template <typename R, typename... P, size_t Capacity, size_t Alignment>
+class inplace_function<R(P...), Capacity, Alignment> final {
+  using operations = impl::inplace_operations<R, P...>;
+
+  template <typename F, typename Callable = std::decay_t<F>>
+  using enable_if_callable = std::enable_if_t<
+      !std::is_same<Callable, inplace_function>::value &&
+      impl::is_callable_as<Callable, R(P...)>::value>;
+
+ public:
+  inplace_function() = default;
+  inplace_function(std::nullptr_t) {}
+
+  // whether the storage can hold a callable of the type
+  template <typename Callable>
+  static constexpr bool fits() {
+    return sizeof(Callable) <= Capacity && Alignment % alignof(Callable) == 0;
+  }
+
+  template <typename F, typename Callable = std::decay_t<F>,
+            typename = enable_if_callable<F>>
+  inplace_function(F&& f) {
+    static_assert(sizeof(Callable) <= Capacity,
+                  "callable too large for inplace_function capacity");
+    static_assert(Alignment % alignof(Callable) == 0,
+                  "callable too strictly aligned for inplace_function");
+    static_assert(std::is_copy_constructible<Callable>::value,
+                  "callable must be copy constructible");
+    static_assert(std::is_nothrow_move_constructible<Callable>::value,
+                  "callable must be nothrow move constructible");
+
+    if (impl::is_null(f, std::is_pointer<Callable>{})) {
+      return;
+    }
+
+    new (&storage_) Callable(std::forward<F>(f));
+    operations_ = &impl::inplace_callable<Callable, R, P...>::operations;
+  }
+
+  inplace_function(const inplace_function& that)
+      : operations_{that.operations_} {
+    if (operations_) {
+      operations_->copy(&storage_, &that.storage_);
+    }
+  }
+
+  inplace_function(inplace_function&& that) noexcept
+      : operations_{that.operations_} {
+    if (operations_) {
+      operations_->relocate(&storage_, &that.storage_);
+      that.operations_ = nullptr;
+    }
+  }
+
+  ~inplace_function() { reset(); }
+
+  inplace_function& operator=(const inplace_function& that) {
+    if (this != &that) {
+      reset();
+      if (that.operations_) {
+        that.operations_->copy(&storage_, &that.storage_);
+        operations_ = that.operations_;
+      }
+    }
+    return *this;
+  }
+
+  inplace_function& operator=(inplace_function&& that) noexcept {
+    if (this != &that) {
+      reset();
+      if (that.operations_) {
+        that.operations_->relocate(&storage_, &that.storage_);
+        operations_ = std::exchange(that.operations_, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  inplace_function& operator=(std::nullptr_t) {
+    reset();
+    return *this;
+  }
+
+  template <typename F, typename = enable_if_callable<F>>
+  inplace_function& operator=(F&& f) {
+    return *this = inplace_function{std::forward<F>(f)};
+  }
+
+  explicit operator bool() const { return operations_ != nullptr; }
+
+  R operator()(P... params) const {
+    if (!operations_) {
+      throw std::bad_function_call{};
+    }
+    return operations_->invoke(&storage_, std::forward<P>(params)...);
+  }
+
+ private:
+  void reset() {
+    if (operations_) {
+      operations_->destroy(&storage_);
+      operations_ = nullptr;
+    }
+  }
+
+  mutable std::aligned_storage_t<Capacity, Alignment> storage_;
+  const operations* operations_ = nullptr;
+};
@@ -1,41 +1,199 @@
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
 #include <memory>
+#include <new>
+#include <ratio>
+#include <type_traits>
 #include <utility>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Types whose objects may be moved by copying their bytes, leaving nothing
+// to destroy at the source. Trivially copyable types always are; specialize
+// for others that are (most types without self-pointers, e.g. unique_ptr).
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+namespace impl {
+
+template <typename...>
+using void_t = void;
+
+// Allocators may grow a block in place, or move it without copying, with
+// T *reallocate(T *p, size_t old_n, size_t new_n). The contents must be
+// trivially relocatable.
+template <typename Allocator, typename = void>
+struct has_reallocate : std::false_type {};
+
+template <typename Allocator>
+struct has_reallocate<
+    Allocator, void_t<decltype(std::declval<Allocator &>().reallocate(
+                   std::declval<typename Allocator::value_type *>(),
+                   size_t{}, size_t{}))>> : std::true_type {};
+
+}  // namespace impl
+
+// Allocates from malloc, and large blocks straight from mmap, so that
+// growth is realloc, or on Linux mremap, which moves large blocks by
+// remapping their pages rather than copying them.
 template <typename T>
+class realloc_allocator final {
+ public:
+  using value_type = T;
+
+  static constexpr size_t kMapThreshold = 1 << 20;
+
+  realloc_allocator() = default;
+
+  template <typename U>
+  realloc_allocator(const realloc_allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    void *p = mapped(n) ? map(bytes(n)) : std::malloc(bytes(n));
+    if (!p) {
+      throw std::bad_alloc{};
+    }
+    return static_cast<T *>(p);
+  }
+
+  void deallocate(T *p, size_t n) {
+    if (mapped(n)) {
+      unmap(p, bytes(n));
+    } else {
+      std::free(p);
+    }
+  }
+
+  T *reallocate(T *p, size_t old_n, size_t new_n) {
+    void *q = nullptr;
+    if (mapped(old_n) && mapped(new_n)) {
+      q = remap(p, bytes(old_n), bytes(new_n));
+    } else if (!mapped(old_n) && !mapped(new_n)) {
+      q = std::realloc(p, bytes(new_n));
+    } else {
+      q = allocate(new_n);
+      std::memcpy(q, p, bytes(std::min(old_n, new_n)));
+      deallocate(p, old_n);
+    }
+    if (!q) {
+      throw std::bad_alloc{};
+    }
+    return static_cast<T *>(q);
+  }
+
+ private:
+  static size_t bytes(size_t n) { return n * sizeof(T); }
+
+#ifdef __linux__
+  static bool mapped(size_t n) { return bytes(n) >= kMapThreshold; }
+
+  static size_t pages(size_t size) {
+    const size_t page = 4096;
+    return (size + page - 1) & ~(page - 1);
+  }
+
+  static void *map(size_t size) {
+    void *p = mmap(nullptr, pages(size), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+  }
+
+  static void unmap(void *p, size_t size) { munmap(p, pages(size)); }
+
+  static void *remap(void *p, size_t old_size, size_t new_size) {
+    void *q = mremap(p, pages(old_size), pages(new_size), MREMAP_MAYMOVE);
+    return q == MAP_FAILED ? nullptr : q;
+  }
+#else
+  static bool mapped(size_t) { return false; }
+  static void *map(size_t) { return nullptr; }
+  static void unmap(void *, size_t) {}
+  static void *remap(void *, size_t, size_t) { return nullptr; }
+#endif
+
+  friend bool operator==(const realloc_allocator &, const realloc_allocator &) {
+    return true;
+  }
+
+  friend bool operator!=(const realloc_allocator &, const realloc_allocator &) {
+    return false;
+  }
+};
+
+// Growth is the factor capacity grows by when full, as a std::ratio
+// greater than one; below 2 a freed block may be reused by later growth.
+template <typename T, typename Allocator = std::allocator<T>,
+          typename Growth = std::ratio<2>>
 class vector final {
+  static_assert(Growth::num > Growth::den, "growth factor must exceed one");
+
+  using traits = std::allocator_traits<Allocator>;
+
  public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = size_t;
+  using iterator = T *;
+  using const_iterator = const T *;
+
   vector() = default;
-  ~vector() = default;
 
-  vector(const vector<T> &that)
-      : data_{std::make_unique<T[]>(that.capacity_)},
-        size_{that.size_},
-        capacity_{that.capacity_} {
-    std::copy_n(that.data_.get(), that.size_, data_.get());
+  explicit vector(const Allocator &allocator) : allocator_{allocator} {}
+
+  ~vector() {
+    clear();
+    release();
+  }
+
+  vector(const vector &that)
+      : allocator_{
+            traits::select_on_container_copy_construction(that.allocator_)} {
+    try {
+      copy_from(that);
+    } catch (...) {
+      clear();
+      release();
+      throw;
+    }
   }
 
-  vector<T> &operator=(const vector<T> &that) {
+  vector &operator=(const vector &that) {
     if (this != &that) {
-      vector<T> copy{that};
-      swap(*this, copy);
+      clear();
+      using propagate = typename traits::propagate_on_container_copy_assignment;
+      assign_allocator(that, propagate{});
+      copy_from(that);
     }
     return *this;
   }
 
-  vector(vector<T> &&that) { swap(*this, that); }
+  vector(vector &&that) noexcept : allocator_{std::move(that.allocator_)} {
+    steal(that);
+  }
 
-  vector<T> &operator=(vector<T> &&that) {
+  vector &operator=(vector &&that) noexcept(
+      traits::propagate_on_container_move_assignment::value) {
     if (this != &that) {
-      swap(*this, that);
+      clear();
+      using propagate = typename traits::propagate_on_container_move_assignment;
+      move_from(that, propagate{});
     }
     return *this;
   }
 
+  allocator_type get_allocator() const { return allocator_; }
+
   size_t size() const { return size_; }
   size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
 
   T &operator[](size_t i) { return data_[i]; }
   const T &operator[](size_t i) const { return data_[i]; }
@@ -52,55 +210,242 @@ class vector final {
   T &back() { return data_[size_ - 1]; }
   const T &back() const { return data_[size_ - 1]; }
 
-  void push_back(T value) {
-    if (size_ == capacity_) {
-      reserve(capacity_ * 2);
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  T &emplace_back(Args &&... args) {
+    if (size_ < capacity_) {
+      traits::construct(allocator_, data_ + size_, std::forward<Args>(args)...);
+    } else {
+      grow(std::forward<Args>(args)...);
     }
-    data_[size_++] = std::move(value);
+    return data_[size_++];
+  }
+
+  void pop_back() { traits::destroy(allocator_, data_ + --size_); }
+
+  void clear() {
+    destroy(0, size_);
+    size_ = 0;
   }
 
   void resize(size_t size) {
-    if (size <= size_) {
-      for (auto i = size; i < size_; ++i) {
-        data_[i].~T();
-      }
-    } else if (size <= capacity_) {
-      for (auto i = size_; i < size; ++i) {
-        data_[i] = T();
+    if (size > capacity_) {
+      reserve(next_capacity(size));
+    }
+    auto i = size_;
+    try {
+      for (; i < size; ++i) {
+        traits::construct(allocator_, data_ + i);
       }
-    } else {
-      reserve(size);
+    } catch (...) {
+      destroy(size_, i);
+      throw;
     }
+    destroy(size, size_);
     size_ = size;
   }
 
   void reserve(size_t capacity) {
     if (capacity > capacity_) {
-      auto temp = std::make_unique<T[]>(capacity);
-      std::copy_n(std::make_move_iterator(data_.get()), size_, temp.get());
-      data_ = std::move(temp);
-      capacity_ = capacity;
+      relocate(nullptr, capacity);
+    }
+  }
+
+  void shrink_to_fit() {
+    if (size_ == 0) {
+      release();
+    } else if (size_ < capacity_) {
+      relocate(nullptr, size_);
     }
   }
 
  private:
-  friend void swap(vector<T> &a, vector<T> &b) {
+  static constexpr bool trivially_relocatable() {
+    return is_trivially_relocatable<T>::value;
+  }
+
+  static constexpr bool can_reallocate() {
+    return trivially_relocatable() && impl::has_reallocate<Allocator>::value;
+  }
+
+  size_t next_capacity(size_t needed) const {
+    size_t grown = capacity_ * Growth::num / Growth::den;
+    return std::max({needed, grown, capacity_ + 1});
+  }
+
+  // the arguments may refer into the old buffer, so the new element is
+  // made before the old ones relocate
+  template <typename... Args>
+  void grow(Args &&... args) {
+    size_t capacity = next_capacity(size_ + 1);
+    if (can_reallocate()) {
+      T value(std::forward<Args>(args)...);
+      relocate(nullptr, capacity);
+      traits::construct(allocator_, data_ + size_, std::move(value));
+      return;
+    }
+    T *grown = traits::allocate(allocator_, capacity);
+    try {
+      traits::construct(allocator_, grown + size_, std::forward<Args>(args)...);
+    } catch (...) {
+      traits::deallocate(allocator_, grown, capacity);
+      throw;
+    }
+    try {
+      relocate(grown, capacity);
+    } catch (...) {
+      traits::destroy(allocator_, grown + size_);
+      traits::deallocate(allocator_, grown, capacity);
+      throw;
+    }
+  }
+
+  // moves the elements into a buffer of the capacity: the one given, or
+  // one reallocated or allocated here. If an element throws, the vector is
+  // unchanged and a buffer allocated here is freed; one given is the
+  // caller's to free.
+  void relocate(T *grown, size_t capacity) {
+    if (!grown && can_reallocate() && data_) {
+      data_ = reallocate(data_, capacity);
+      capacity_ = capacity;
+      return;
+    }
+    if (!grown) {
+      T *allocated = traits::allocate(allocator_, capacity);
+      try {
+        relocate(allocated, capacity);
+      } catch (...) {
+        traits::deallocate(allocator_, allocated, capacity);
+        throw;
+      }
+      return;
+    }
+    if (trivially_relocatable()) {
+      if (size_) {
+        std::memcpy(static_cast<void *>(grown), data_, size_ * sizeof(T));
+      }
+    } else {
+      size_t i = 0;
+      try {
+        for (; i < size_; ++i) {
+          traits::construct(allocator_, grown + i,
+                            std::move_if_noexcept(data_[i]));
+        }
+      } catch (...) {
+        for (size_t j = 0; j < i; ++j) {
+          traits::destroy(allocator_, grown + j);
+        }
+        throw;
+      }
+      destroy(0, size_);
+    }
+    release();
+    data_ = grown;
+    capacity_ = capacity;
+  }
+
+  template <typename A = Allocator>
+  std::enable_if_t<impl::has_reallocate<A>::value, T *> reallocate(
+      T *p, size_t capacity) {
+    return allocator_.reallocate(p, capacity_, capacity);
+  }
+
+  template <typename A = Allocator>
+  std::enable_if_t<!impl::has_reallocate<A>::value, T *> reallocate(T *,
+                                                                    size_t) {
+    return nullptr;
+  }
+
+  void destroy(size_t first, size_t last) {
+    if (!std::is_trivially_destructible<T>::value) {
+      for (auto i = first; i < last; ++i) {
+        traits::destroy(allocator_, data_ + i);
+      }
+    }
+  }
+
+  // frees the buffer, whose elements are already gone
+  void release() {
+    if (data_) {
+      traits::deallocate(allocator_, data_, capacity_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+
+  void copy_from(const vector &that) {
+    reserve(that.size_);
+    for (auto &value : that) {
+      traits::construct(allocator_, data_ + size_, value);
+      ++size_;
+    }
+  }
+
+  void assign_allocator(const vector &that, std::true_type) {
+    if (allocator_ != that.allocator_) {
+      release();
+    }
+    allocator_ = that.allocator_;
+  }
+
+  void assign_allocator(const vector &, std::false_type) {}
+
+  void swap_allocator(vector &that, std::true_type) {
+    using std::swap;
+    swap(allocator_, that.allocator_);
+  }
+
+  void swap_allocator(vector &, std::false_type) {}
+
+  void move_from(vector &that, std::true_type) {
+    release();
+    allocator_ = std::move(that.allocator_);
+    steal(that);
+  }
+
+  // storage can't change hands between unequal allocators that stay put
+  void move_from(vector &that, std::false_type) {
+    if (allocator_ == that.allocator_) {
+      release();
+      steal(that);
+      return;
+    }
+    reserve(that.size_);
+    for (auto &value : that) {
+      traits::construct(allocator_, data_ + size_, std::move(value));
+      ++size_;
+    }
+    that.clear();
+  }
+
+  void steal(vector &that) {
+    data_ = std::exchange(that.data_, nullptr);
+    size_ = std::exchange(that.size_, 0);
+    capacity_ = std::exchange(that.capacity_, 0);
+  }
+
+  // allocators that don't propagate must be equal
+  friend void swap(vector &a, vector &b) {
     using std::swap;
+    using propagate = typename traits::propagate_on_container_swap;
+    a.swap_allocator(b, propagate{});
     swap(a.data_, b.data_);
     swap(a.size_, b.size_);
     swap(a.capacity_, b.capacity_);
   }
 
-  friend bool operator==(const vector<T> &a, const vector<T> &b) {
-    return std::equal(a.data_.get(), a.data_.get() + a.size_, b.data_.get(),
-                      b.data_.get() + b.size_);
+  friend bool operator==(const vector &a, const vector &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
   }
 
-  friend bool operator!=(const vector<T> &a, const vector<T> &b) {
+  friend bool operator!=(const vector &a, const vector &b) {
     return !(a == b);
   }
 
-  std::unique_ptr<T[]> data_;
+  Allocator allocator_;
+  T *data_ = nullptr;
   size_t size_ = 0;
   size_t capacity_ = 0;
 };
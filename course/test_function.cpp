@@ -1,5 +1,22 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "soln_function.cpp"
+
+// core's signals and executor; build with -I..
+#include "core/common.hpp"
+#include "core/Executor.hpp"
+#include "core/Signal.hpp"
 
 #define IT_SHOULD(test_name, test_body)     \
     struct it_should_##test_name {          \
@@ -33,6 +50,9 @@
 template <typename T>
 using type_under_test = std::function<T>;
 
+template <typename T>
+using solution = inplace_function<T>;
+
 int count = 0;
 const auto l = [capture = 1](int v) mutable -> int {
     ::count += v;
@@ -137,4 +157,162 @@ int main() {
             assert(g(6) == 13);
         });
     }
+    {
+        using some = solution<void()>;
+        IT_CAN_BE_DEFAULT_COPY_AND_MOVE_CONSTRUCTED
+    }
+    {
+        using some = solution<int(int)>;
+
+        IT_SHOULD(invoke_free_function, {
+            count = 0;
+            some f{fun};
+
+            f(5);
+            assert(count == 5);
+        });
+
+        IT_SHOULD(make_distinct_copies, {
+            some f{l};
+            some g{f};
+
+            assert(f(5) == 6);
+            assert(g(6) == 7);
+            assert(f(5) == 11);
+            assert(g(6) == 13);
+        });
+
+        IT_SHOULD(be_empty_after_default_construction, {
+            some f;
+            assert(!f);
+        });
+
+        IT_SHOULD(be_empty_after_null_assignment, {
+            some f{l};
+            assert(f);
+            f = nullptr;
+            assert(!f);
+        });
+
+        IT_SHOULD(be_empty_after_being_moved_from, {
+            some f{l};
+            some g{std::move(f)};
+            assert(!f);
+            assert(g);
+        });
+
+        IT_SHOULD(be_empty_from_null_function_pointer, {
+            int (*null)(int) = nullptr;
+            some f{null};
+            assert(!f);
+            f = fun;
+            assert(f);
+            f = null;
+            assert(!f);
+        });
+
+        IT_SHOULD(not_be_constructed_from_non_callables, {
+            static_assert(!std::is_convertible<int, some>::value, "");
+            static_assert(!std::is_constructible<some, int>::value, "");
+            static_assert(!std::is_assignable<some &, int>::value, "");
+        });
+
+        using fitting = std::array<char, 32>;
+        using handlers = std::array<solution<void(int)>, 4>;
+
+        IT_SHOULD(hold_callable_as_large_as_capacity, {
+            count = 0;
+            fitting padding{};
+            auto fitted = [padding](int v) { return ::count += v + padding[0]; };
+            static_assert(some::fits<decltype(fitted)>(), "");
+            some f{fitted};
+            assert(f(5) == 5);
+        });
+
+        IT_SHOULD(not_fit_callable_larger_than_capacity, {
+            char padding[33]{};
+            auto oversized = [padding](int v) { return v + padding[0]; };
+            static_assert(!some::fits<decltype(oversized)>(), "");
+            assert(oversized(1) == 1);
+        });
+
+        IT_CANNOT(hold_callable_larger_than_capacity, {
+            char padding[33]{};
+            some f{[padding](int v) { return v + padding[0]; }};
+        });
+
+        IT_SHOULD(destroy_callable_exactly_once, {
+            auto shared = std::make_shared<int>(1);
+            {
+                some f{[shared](int v) { return v + *shared; }};
+                some g{f};
+                some h{std::move(f)};
+                assert(shared.use_count() == 3);
+                g = h;
+                assert(shared.use_count() == 3);
+                g = nullptr;
+                assert(shared.use_count() == 2);
+            }
+            assert(shared.use_count() == 1);
+        });
+
+        IT_CAN(be_used_as_signal_handler, {
+            count = 0;
+            handlers installed;
+            installed[0] = [](int v) { ::count += v; };
+            installed[2] = installed[0];
+            installed[0] = nullptr;
+
+            const auto& invoked = installed;
+            for (const auto& handler : invoked) {
+                if (handler) {
+                    handler(5);
+                }
+            }
+            assert(count == 5);
+        });
+    }
+    {
+        using signal = core::BasicSignal<solution, int>;
+        using slot = core::BasicSlot<solution, int>;
+        using executor = core::BasicExecutor<solution>;
+
+        // runs work as soon as it is scheduled
+        struct immediate final : executor {
+            bool Remove(Handle) override { return false; }
+            Handle Schedule(Work item, Duration, Duration) override {
+                item();
+                return Handle{};
+            }
+        };
+
+        IT_SHOULD(run_core_signal_handlers_inline, {
+            count = 0;
+            signal s;
+            core::when(s, [](int v) { ::count += v; });
+            core::once(s, [](int v) { ::count += v * 10; });
+            s(1);
+            s(2);
+            assert(count == 13);
+        });
+
+        IT_SHOULD(run_core_slot_handlers_inline, {
+            count = 0;
+            signal s;
+            slot t;
+            t.when([](int v) { ::count += v; });
+            core::connect(s, t);
+            s(5);
+            core::disconnect(s, t);
+            s(5);
+            assert(count == 5);
+        });
+
+        IT_SHOULD(run_core_executor_work_inline, {
+            count = 0;
+            immediate e;
+            e.Schedule([] { ::count += 5; }, {}, {});
+            assert(count == 5);
+        });
+    }
 }
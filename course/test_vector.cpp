@@ -1,7 +1,28 @@
 #include <cassert>
 #include <cstddef>
+#include <string>
 #include <vector>
 
+#include "soln_vector.cpp"
+
+// ceres' frame allocator; build with
+// `c++ --std=c++14 -I../ceres/src test_vector.cpp ../ceres/src/platform/posix/*.cpp -lpthread`
+#include <core/debug.hpp>
+#include <core/standard.hpp>
+#include <core/types.hpp>
+#include <core/bits.hpp>
+#include <memory/core.hpp>
+#include <system/platform.hpp>
+#include <memory/allocation.hpp>
+#include <memory/arena.hpp>
+#include <memory/frame.hpp>
+#include <memory/composable/allocator/core.hpp>
+#include <memory/composable/allocator/stateful.hpp>
+#include <memory/composable/allocator/terminal.hpp>
+#include <memory/composable/allocator/compat.hpp>
+#include <memory/composable/allocator/concrete.hpp>
+#include <memory/composable/allocator/frame.hpp>
+
 #define IT_SHOULD(test_name, test_body) \
   struct it_should_##test_name {        \
     it_should_##test_name() { test(); } \
@@ -14,7 +35,71 @@ template <typename T>
 using type_under_test = std::vector<T>;
 
 template <typename T>
-void setup_sequence(type_under_test<T> &p, size_t I, size_t N) {
+using solution = vector<T>;
+
+// ceres' per-frame allocator, whose state is neither assignable nor swapped
+template <typename T>
+using frame_allocator = ceres::memory::allocator::concrete<
+    ceres::memory::allocator::compat<ceres::memory::allocator::frame>, T>;
+
+// counts what it hands out, shared between copies
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator(size_t *live) : live{live} {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &that) : live{that.live} {}
+
+  T *allocate(size_t n) {
+    ++*live;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T *p, size_t n) {
+    --*live;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool operator==(const counting_allocator &a,
+                         const counting_allocator &b) {
+    return a.live == b.live;
+  }
+
+  friend bool operator!=(const counting_allocator &a,
+                         const counting_allocator &b) {
+    return !(a == b);
+  }
+
+  size_t *live;
+};
+
+// counts live objects; construction throws once its budget runs out, and
+// moves may throw so growth copies
+struct fragile {
+  static int live;
+  static int budget;
+
+  fragile() { make(); }
+  fragile(int) { make(); }
+  fragile(const fragile &) { make(); }
+  fragile(fragile &&) noexcept(false) { make(); }
+  ~fragile() { --live; }
+
+  static void make() {
+    if (budget-- == 0) {
+      throw 0;
+    }
+    ++live;
+  }
+};
+
+int fragile::live = 0;
+int fragile::budget = -1;
+
+template <typename Vector>
+void setup_sequence(Vector &p, size_t I, size_t N) {
   for (size_t i = I; i < N; ++i) {
     p.push_back(i);
   }
@@ -304,4 +389,187 @@ int main() {
       verify_sequence(q, 0, N);
     });
   }
+
+  {
+    using some = solution<int>;
+
+    const size_t N = 100;
+
+    IT_SHOULD(transmit_values_to_solution_copies_and_moves, {
+      some p;
+      setup_sequence(p, 0, N);
+      some q{p};
+      some r;
+      r = q;
+      some s{std::move(q)};
+      some t;
+      t = std::move(r);
+      verify_sequence(p, 0, N);
+      verify_sequence(s, 0, N);
+      verify_sequence(t, 0, N);
+    });
+
+    using pairs = vector<std::pair<int, int>>;
+    using slow_growing = vector<int, std::allocator<int>, std::ratio<3, 2>>;
+    using counted = vector<int, counting_allocator<int>>;
+    using reallocated = vector<int, realloc_allocator<int>>;
+
+    IT_CAN(emplace_back_constructor_arguments, {
+      pairs p;
+      p.emplace_back(5, 6);
+      assert(p[0].first == 5);
+      assert(p[0].second == 6);
+    });
+
+    IT_SHOULD(push_back_own_elements_while_growing, {
+      some p;
+      p.push_back(5);
+      for (size_t i = 0; i < N; ++i) {
+        p.push_back(p[0]);
+      }
+      for (auto v : p) {
+        assert(v == 5);
+      }
+    });
+
+    IT_SHOULD(retain_values_when_reserving, {
+      some p;
+      setup_sequence(p, 0, N);
+      p.reserve(N * 10);
+      assert(p.capacity() >= N * 10);
+      verify_sequence(p, 0, N);
+    });
+
+    IT_SHOULD(retain_values_when_shrinking_to_fit, {
+      some p;
+      setup_sequence(p, 0, N);
+      p.reserve(N * 10);
+      p.shrink_to_fit();
+      assert(p.capacity() == N);
+      verify_sequence(p, 0, N);
+    });
+
+    IT_SHOULD(grow_by_the_growth_factor, {
+      slow_growing p;
+      size_t capacity = 0;
+      for (size_t i = 0; i < N; ++i) {
+        p.push_back(i);
+        if (p.capacity() != capacity) {
+          assert(p.capacity() >= capacity * 3 / 2);
+          assert(p.capacity() < capacity * 2 || capacity < 2);
+          capacity = p.capacity();
+        }
+      }
+    });
+
+    IT_SHOULD(move_values_that_are_not_trivially_relocatable, {
+      vector<std::string> p;
+      for (size_t i = 0; i < N; ++i) {
+        p.push_back(std::string(32, 'a' + i % 26));
+      }
+      for (size_t i = 0; i < N; ++i) {
+        assert(p[i] == std::string(32, 'a' + i % 26));
+      }
+    });
+
+    IT_SHOULD(allocate_from_its_allocator, {
+      size_t live = 0;
+      {
+        counted p{counting_allocator<int>{&live}};
+        for (size_t i = 0; i < N; ++i) {
+          p.push_back(i);
+        }
+        assert(live == 1);
+        auto q = p;
+        assert(live == 2);
+        verify_sequence(q, 0, N);
+      }
+      assert(live == 0);
+    });
+
+    IT_SHOULD(retain_values_when_growing_by_reallocation, {
+      reallocated p;
+      const size_t M = 1 << 20;
+      for (size_t i = 0; i < M; ++i) {
+        p.push_back(i);
+      }
+      verify_sequence(p, 0, M);
+      p.resize(M * 4);
+      verify_sequence(p, 0, M);
+      p.shrink_to_fit();
+      verify_sequence(p, 0, M);
+    });
+
+    using fragiles = vector<fragile>;
+
+    IT_SHOULD(free_everything_when_growth_throws, {
+      {
+        fragiles p;
+        p.reserve(4);
+        for (int i = 0; i < 4; ++i) {
+          p.emplace_back(i);
+        }
+        fragile::budget = 3;  // the new element and two copies
+        try {
+          p.emplace_back(4);
+          assert(false);
+        } catch (int) {
+        }
+        fragile::budget = -1;
+        assert(p.size() == 4);
+        assert(fragile::live == 4);
+      }
+      assert(fragile::live == 0);
+    });
+
+    IT_SHOULD(free_everything_when_copying_throws, {
+      {
+        fragiles p;
+        p.resize(8);
+        fragile::budget = 5;
+        try {
+          fragiles q{p};
+          assert(false);
+        } catch (int) {
+        }
+        fragile::budget = -1;
+        assert(fragile::live == 8);
+      }
+      assert(fragile::live == 0);
+    });
+
+    IT_SHOULD(keep_its_size_when_resizing_throws, {
+      {
+        fragiles p;
+        p.resize(2);
+        fragile::budget = 3;
+        try {
+          p.resize(8);
+          assert(false);
+        } catch (int) {
+        }
+        fragile::budget = -1;
+        assert(p.size() == 2);
+        assert(fragile::live == 2);
+      }
+      assert(fragile::live == 0);
+    });
+
+    using framed = vector<int, frame_allocator<int>>;
+
+    IT_CAN(copy_move_and_swap_over_a_frame_allocator, {
+      framed p;
+      setup_sequence(p, 0, N);
+      framed q;
+      q = p;
+      framed r;
+      r = std::move(q);
+      framed s;
+      s.push_back(5);
+      swap(r, s);
+      verify_sequence(p, 0, N);
+      verify_sequence(s, 0, N);
+      assert(r.size() == 1 && r[0] == 5);
+    });
+  }
 }